@@ -28,7 +28,6 @@
 #include "sst/plugininfra/patch-support/patch_base_clap_adapter.h"
 #include "sst/plugininfra/cpufeatures.h"
 
-#include "sst/voicemanager/midi1_to_voicemanager.h"
 #include "sst/clap_juce_shim/clap_juce_shim.h"
 
 #include "ui/six-sines-editor.h"
@@ -64,6 +63,7 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
         engine = std::make_unique<Synth>(multiOut);
 
         engine->clapHost = h;
+        engine->mainToAudio.host = h;
 
         clapJuceShim = std::make_unique<sst::clap_juce_shim::ClapJuceShim>(this);
         clapJuceShim->setResizable(true);
@@ -81,6 +81,8 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
         // session state (MPE / smoothing) is seeded at construction and thereafter reaches the
         // audio thread only through the SET_AUDIO_DAW_STATE queue, so it is not touched here.
         engine->patch.copyValuesFrom(engine->patchMain);
+        // Every table, not just the patch's, since automation can pick any waveform
+        SinTable::prepareAllWaveForms();
         engine->setSampleRate(sampleRate);
         return true;
     }
@@ -157,6 +159,7 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     clap_process_status process_nonblocking(const clap_process *process) SST_CPPUTILS_NONBLOCKING
     {
         auto fpuguard = sst::plugininfra::cpufeatures::FPUStateGuard();
+        auto start = std::chrono::high_resolution_clock::now();
 
         auto ev = process->in_events;
         auto outq = process->out_events;
@@ -168,6 +171,40 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
         {
             nextEvent = ev->get(ev, nextEventIndex);
         }
+        auto advanceEvent = [&]()
+        {
+            nextEventIndex++;
+            if (nextEventIndex < sz)
+                nextEvent = ev->get(ev, nextEventIndex);
+            else
+                nextEvent = nullptr;
+        };
+        auto sampleAccurate = engine->sampleAccurateEvents();
+
+        static constexpr int outBus{multiOut ? 1 + numOps : 1};
+        static constexpr int outChan{multiOut ? (1 + numOps) * 2 : 2};
+
+        // With nothing playing and no events, skip the engine. The sleeping flag goes up
+        // before the main thread queue drains so a message pushed after that wakes the host.
+        if (sz == 0 && engine->isIdle())
+        {
+            engine->mainToAudio.audioSleeping.store(true, std::memory_order_release);
+            engine->processUIQueue(outq);
+            if (engine->isIdle())
+            {
+                for (auto i = 0U; i < process->audio_outputs_count; ++i)
+                {
+                    auto &ob = process->audio_outputs[i];
+                    for (auto c = 0U; c < ob.channel_count; ++c)
+                        memset(ob.data32[c], 0, process->frames_count * sizeof(float));
+                    ob.constant_mask = (1ULL << ob.channel_count) - 1;
+                }
+                // Start a fresh engine block when processing resumes
+                blockPos = 0;
+                return CLAP_PROCESS_SLEEP;
+            }
+        }
+        engine->mainToAudio.audioSleeping.store(false, std::memory_order_relaxed);
 
         if (process->transport)
         {
@@ -199,8 +236,6 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
         // see the anchored value; this suppresses the per-block advance on the first block.)
         engine->monoValues.songPosNeedsResync = true;
 
-        static constexpr int outBus{multiOut ? 1 + numOps : 1};
-        static constexpr int outChan{multiOut ? (1 + numOps) * 2 : 2};
         float *out[outChan];
         for (auto i = 0; i < outBus; ++i)
         {
@@ -216,107 +251,99 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
             audioInR = process->audio_inputs[0].data32[1];
         }
 
-        for (auto s = 0U; s < process->frames_count; ++s)
+        // Buses which stay silent for every engine block this buffer reads from, including
+        // the one already part way through, get flagged constant so hosts can skip them
+        uint32_t silentBuses{engine->silentBusMask()};
+
+        // Walk the buffer a run at a time: a run ends at the engine block boundary or the end
+        // of the buffer, so the head and tail of an unaligned buffer are just short runs
+        auto inAt = [](const float *p, uint32_t s) { return p ? p + s : nullptr; };
+        for (uint32_t s = 0; s < process->frames_count;)
         {
-            engine->pushAudioIn(audioInL ? audioInL[s] : 0.f, audioInR ? audioInR[s] : 0.f);
+            auto n = std::min((uint32_t)(blockSize - blockPos), process->frames_count - s);
+            auto pushFrom = s;
 
             if (blockPos == 0)
             {
-                // Only realy need to run events when we do the block process
-                while (nextEvent && nextEvent->time <= s)
+                // The engine block may read the input frame it starts on
+                engine->pushAudioIn(inAt(audioInL, s), inAt(audioInR, s), 1);
+                pushFrom++;
+
+                if (sampleAccurate)
+                {
+                    // Everything up to the end of this block goes to the engine with its
+                    // time, to dispatch at the engine sample it maps to
+                    while (nextEvent && nextEvent->time < s + blockSize)
+                    {
+                        engine->scheduleEvent(nextEvent, (int32_t)nextEvent->time - (int32_t)s);
+                        advanceEvent();
+                    }
+                }
+                else
                 {
-                    handleEvent(nextEvent);
-                    nextEventIndex++;
-                    if (nextEventIndex < sz)
-                        nextEvent = ev->get(ev, nextEventIndex);
-                    else
-                        nextEvent = nullptr;
+                    // Only realy need to run events when we do the block process
+                    while (nextEvent && nextEvent->time <= s)
+                    {
+                        handleEvent(nextEvent);
+                        advanceEvent();
+                    }
                 }
 
                 engine->process(outq);
+                silentBuses &= engine->silentBusMask();
             }
+            engine->pushAudioIn(inAt(audioInL, pushFrom), inAt(audioInR, pushFrom),
+                                s + n - pushFrom);
 
             for (auto i = 0; i < outChan; ++i)
-                out[i][s] = engine->output[i][blockPos];
+                memcpy(out[i] + s, engine->output[i] + blockPos, n * sizeof(float));
 
-            blockPos++;
-            if (blockPos == blockSize)
-            {
-                blockPos = 0;
-            }
+            s += n;
+            blockPos = (blockPos + n) % blockSize;
         }
 
+        for (auto i = 0; i < outBus; ++i)
+            process->audio_outputs[i].constant_mask = (silentBuses & (1U << i)) ? 0x3 : 0;
+
+        // Events after the last block start in this buffer. Scheduled ones are timed back
+        // from the next block start, so they keep their sample; block events take the next
+        // engine block, as they would have at a block start
+        auto nextBlockStart = (int32_t)(process->frames_count + (blockSize - blockPos) % blockSize);
         while (nextEvent)
         {
-            handleEvent(nextEvent);
-            nextEventIndex++;
-            if (nextEventIndex < sz)
-                nextEvent = ev->get(ev, nextEventIndex);
+            if (sampleAccurate)
+                engine->scheduleEvent(nextEvent, (int32_t)nextEvent->time - nextBlockStart);
             else
-                nextEvent = nullptr;
+                handleEvent(nextEvent);
+            advanceEvent();
+        }
+
+        // Buffers the engine slept through are left out, so the tail is the working buffers
+        if (process->frames_count > 0)
+        {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::high_resolution_clock::now() - start)
+                          .count();
+            engine->processTiming.buffer.record(ns * engine->hostSampleRate * 1e-9 /
+                                                process->frames_count);
         }
         return CLAP_PROCESS_CONTINUE;
     }
 
     void reset() noexcept override { engine->voiceManager->allSoundsOff(); }
 
-    bool handleEvent(const clap_event_header_t *nextEvent)
+    // Offline renders can turn on sample accurate events (see Synth::EventTiming)
+    bool implementsRender() const noexcept override { return true; }
+    bool renderHasHardRealtimeRequirement() noexcept override { return false; }
+    bool renderSetMode(clap_plugin_render_mode mode) noexcept override
     {
-        auto &vm = engine->voiceManager;
-        if (nextEvent->space_id == CLAP_CORE_EVENT_SPACE_ID)
-        {
-            switch (nextEvent->type)
-            {
-            case CLAP_EVENT_MIDI:
-            {
-                auto mevt = reinterpret_cast<const clap_event_midi *>(nextEvent);
-                sst::voicemanager::applyMidi1Message(*vm, mevt->port_index, mevt->data);
-            }
-            break;
-
-            case CLAP_EVENT_NOTE_ON:
-            {
-                auto nevt = reinterpret_cast<const clap_event_note *>(nextEvent);
-                vm->processNoteOnEvent(nevt->port_index, nevt->channel, nevt->key, nevt->note_id,
-                                       nevt->velocity, 0.f);
-            }
-            break;
-
-            case CLAP_EVENT_NOTE_OFF:
-            {
-                auto nevt = reinterpret_cast<const clap_event_note *>(nextEvent);
-                auto nid = nevt->note_id;
-                // nid = -1;
-                vm->processNoteOffEvent(nevt->port_index, nevt->channel, nevt->key, nid,
-                                        nevt->velocity);
-            }
-            break;
-            case CLAP_EVENT_PARAM_VALUE:
-            {
-                auto pevt = reinterpret_cast<const clap_event_param_value *>(nextEvent);
-                auto par =
-                    sst::plugininfra::patch_support::paramFromClapEvent<Param>(pevt, engine->patch);
-                if (par)
-                {
-                    engine->handleParamValue(par, pevt->param_id, pevt->value);
-                }
-            }
-            break;
+        engine->renderingOffline = (mode == CLAP_RENDER_OFFLINE);
+        return true;
+    }
 
-            case CLAP_EVENT_NOTE_EXPRESSION:
-            {
-                auto nevt = reinterpret_cast<const clap_event_note_expression *>(nextEvent);
-                vm->routeNoteExpression(nevt->port_index, nevt->channel, nevt->key, nevt->note_id,
-                                        nevt->expression_id, nevt->value);
-            }
-            break;
-            default:
-            {
-                SXSNLOG("Unknown inbound event of type " << nextEvent->type);
-            }
-            break;
-            }
-        }
+    bool handleEvent(const clap_event_header_t *nextEvent)
+    {
+        engine->handleEvent(nextEvent);
         return true;
     }
 
@@ -525,8 +552,8 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     {
         auto res = std::make_unique<baconpaul::six_sines::ui::SixSinesEditor>(
             engine->patchMain, engine->audioToMain, engine->mainToAudio, engine->audioOutputRing,
-            engine->editorActive, engine->uiForceRebuild, engine->dawStateMain,
-            *engine->defaultsProvider, _host.host());
+            engine->processTiming, engine->editorActive, engine->uiForceRebuild,
+            engine->dawStateMain, *engine->defaultsProvider, _host.host());
 
         res->onZoomChanged = [this](auto f)
         {
@@ -26,8 +26,19 @@
 namespace baconpaul::six_sines
 {
 
-static constexpr size_t blockSize{8};
-static constexpr double blockSizeInv{1.0 / 8};
+// The engine block, which is also the modulation rate. Set with SIX_SINES_BLOCK_SIZE at
+// build time (see the -bs16 / -bs32 impl targets); the shipping plugin uses 8.
+#ifndef SIX_SINES_BLOCK_SIZE
+#define SIX_SINES_BLOCK_SIZE 8
+#endif
+static constexpr size_t blockSize{SIX_SINES_BLOCK_SIZE};
+static_assert(blockSize == 8 || blockSize == 16 || blockSize == 32,
+              "Engine block size must be 8, 16 or 32");
+static constexpr double blockSizeInv{1.0 / blockSize};
+// The engine can render up to this many blocks per voice in one go (see Synth::macroBlocks)
+static constexpr size_t maxMacroBlocks{4};
+// The SRC resamplers take up to this many engine blocks per call (see Synth::srcBatchBlocks)
+static constexpr size_t maxSRCBatchBlocks{16};
 
 static constexpr size_t numOps{6};
 static constexpr size_t matrixSize{(numOps * (numOps - 1)) / 2};
@@ -59,7 +70,9 @@ enum ResamplerEngine
     SRC_BEST,
     LANCZOS,
     LINTERP,
-    ZOH
+    ZOH,
+    POLYPHASE,
+    POLYPHASE_HQ
 };
 
 // Output signal-path stage settings (streamed)
@@ -53,7 +53,7 @@ struct MacroVoiceNode : EnvelopeSupport<Patch::MacroNode>,
         : macroNode(mn), monoValues(mv), voiceValues(vv), level(mn.level),
           macroPowerV(mn.macroPower), envDepth(mn.envDepth), lfoDepth(mn.lfoDepth),
           lfoLevelMode(mn.lfoLevelMode), ModulationSupport(mn, this, mv, vv),
-          EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv)
+          EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv, vv)
     {
     }
 
@@ -80,6 +80,7 @@ struct MacroVoiceNode : EnvelopeSupport<Patch::MacroNode>,
             out = level;
             return;
         }
+        node_profiler::Scope profile(node_profiler::MACRO);
         calculateModulation();
         envProcess();
         lfoProcess();
@@ -133,41 +134,21 @@ struct MacroVoiceNode : EnvelopeSupport<Patch::MacroNode>,
         resetModulation();
         envResetMod();
         lfoResetMod();
+        runModulation();
+    }
 
-        if (!anySources)
-            return;
-
-        for (int i = 0; i < numModsPer; ++i)
+    ModRoute nodeModulationRoute(int target)
+    {
+        switch ((Patch::MacroNode::TargetID)target)
         {
-            if (sourcePointers[i] &&
-                (int)macroNode.modtarget[i].value != Patch::MacroNode::TargetID::NONE)
-            {
-                auto dp = depthPointers[i];
-                if (!dp)
-                    continue;
-                auto d = *dp;
-
-                auto handled = envHandleModulationValue((int)macroNode.modtarget[i].value, d,
-                                                        sourcePointers[i]) ||
-                               lfoHandleModulationValue((int)macroNode.modtarget[i].value, d,
-                                                        sourcePointers[i]);
-
-                if (!handled)
-                {
-                    switch ((Patch::MacroNode::TargetID)macroNode.modtarget[i].value)
-                    {
-                    case Patch::MacroNode::LEVEL:
-                        levMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::MacroNode::DEPTH_ATTEN:
-                        depthAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
+        case Patch::MacroNode::LEVEL:
+            return {&levMod, ModRoute::ADD};
+        case Patch::MacroNode::DEPTH_ATTEN:
+            return {&depthAtten, ModRoute::ATTEN};
+        default:
+            break;
         }
+        return {};
     }
 
     bool checkLfoUsed() { return lfoDepth != 0 || lfoUsedAsModulationSource; }
@@ -45,7 +45,7 @@ struct MatrixNodeFrom : public EnvelopeSupport<Patch::MatrixNode>,
                    const VoiceValues &vv)
         : matrixNode(mn), monoValues(mv), voiceValues(vv), onto(on), from(fr), level(mn.level),
           modmodeV(mn.modulationMode), activeV(mn.active), EnvelopeSupport(mn, mv, vv),
-          LFOSupport(mn, mv), lfoToDepth(mn.lfoToDepth), envToLevel(mn.envToLevel),
+          LFOSupport(mn, mv, vv), lfoToDepth(mn.lfoToDepth), envToLevel(mn.envToLevel),
           overdriveV(mn.overdrive), lfoDepthMode(mn.lfoDepthMode),
           ModulationSupport(mn, this, mv, vv), rmScaleV(mn.modulationScale)
     {
@@ -80,10 +80,22 @@ struct MatrixNodeFrom : public EnvelopeSupport<Patch::MatrixNode>,
         }
     }
 
+    // The modulation depth is pinned at zero by an envelope which only a reattack can lift,
+    // so the source operator's output can't reach the target until then. A zero level
+    // doesn't count: it can be automated back up, and the envelopes have to have run
+    bool contributesNothing() const
+    {
+        if (!active)
+            return true;
+        return envIsMult && envSettledAtZero() && !anySources &&
+               (lfoDepthMode >= 0.5f || lfoToDepth == 0.f);
+    }
+
     void applyBlock()
     {
         if (!active)
             return;
+        node_profiler::Scope profile(node_profiler::MATRIX);
 
         calculateModulation();
         envProcess();
@@ -222,45 +234,23 @@ struct MatrixNodeFrom : public EnvelopeSupport<Patch::MatrixNode>,
         resetModulation();
         envResetMod();
         lfoResetMod();
+        runModulation();
+    }
 
-        if (!anySources)
-            return;
-
-        for (int i = 0; i < numModsPer; ++i)
+    ModRoute nodeModulationRoute(int target)
+    {
+        switch ((Patch::MatrixNode::TargetID)target)
         {
-            if (sourcePointers[i] &&
-                (int)matrixNode.modtarget[i].value != Patch::SelfNode::TargetID::NONE)
-            {
-                // targets: env depth atten, lfo dept atten, direct adjust, env attack, lfo rate
-                auto dp = depthPointers[i];
-                if (!dp)
-                    continue;
-                auto d = *dp;
-
-                auto handled = envHandleModulationValue((int)matrixNode.modtarget[i].value, d,
-                                                        sourcePointers[i]) ||
-                               lfoHandleModulationValue((int)matrixNode.modtarget[i].value, d,
-                                                        sourcePointers[i]);
-
-                if (!handled)
-                {
-                    switch ((Patch::MatrixNode::TargetID)matrixNode.modtarget[i].value)
-                    {
-                    case Patch::MatrixNode::DIRECT:
-                        applyMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::MatrixNode::DEPTH_ATTEN:
-                        depthAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::MatrixNode::LFO_DEPTH_ATTEN:
-                        lfoAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
+        case Patch::MatrixNode::DIRECT:
+            return {&applyMod, ModRoute::ADD};
+        case Patch::MatrixNode::DEPTH_ATTEN:
+            return {&depthAtten, ModRoute::ATTEN};
+        case Patch::MatrixNode::LFO_DEPTH_ATTEN:
+            return {&lfoAtten, ModRoute::ATTEN};
+        default:
+            break;
         }
+        return {};
     }
 };
 
@@ -278,7 +268,7 @@ struct MatrixNodeSelf : EnvelopeSupport<Patch::SelfNode>,
     MatrixNodeSelf(const Patch::SelfNode &sn, OpSource &on, MonoValues &mv, const VoiceValues &vv)
         : selfNode(sn), monoValues(mv), voiceValues(vv), onto(on), fbBase(sn.fbLevel),
           lfoToFB(sn.lfoToFB), activeV(sn.active), envToFB(sn.envToFB), overdriveV(sn.overdrive),
-          lfoFBMode(sn.lfoFBMode), EnvelopeSupport(sn, mv, vv), LFOSupport(sn, mv),
+          lfoFBMode(sn.lfoFBMode), EnvelopeSupport(sn, mv, vv), LFOSupport(sn, mv, vv),
           ModulationSupport(sn, this, mv, vv) {};
     bool active{true}, lfoMul{false};
     float overdriveFactor{1.0};
@@ -303,6 +293,7 @@ struct MatrixNodeSelf : EnvelopeSupport<Patch::SelfNode>,
     {
         if (!active)
             return;
+        node_profiler::Scope profile(node_profiler::SELF);
 
         calculateModulation();
         envProcess();
@@ -387,45 +378,23 @@ struct MatrixNodeSelf : EnvelopeSupport<Patch::SelfNode>,
         resetModulation();
         envResetMod();
         lfoResetMod();
+        runModulation();
+    }
 
-        if (!anySources)
-            return;
-
-        for (int i = 0; i < numModsPer; ++i)
+    ModRoute nodeModulationRoute(int target)
+    {
+        switch ((Patch::SelfNode::TargetID)target)
         {
-            if (sourcePointers[i] &&
-                (int)selfNode.modtarget[i].value != Patch::SelfNode::TargetID::NONE)
-            {
-                // targets: env depth atten, lfo dept atten, direct adjust, env attack, lfo rate
-                auto dp = depthPointers[i];
-                if (!dp)
-                    continue;
-                auto d = *dp;
-
-                auto handled = envHandleModulationValue((int)selfNode.modtarget[i].value, d,
-                                                        sourcePointers[i]) ||
-                               lfoHandleModulationValue((int)selfNode.modtarget[i].value, d,
-                                                        sourcePointers[i]);
-
-                if (!handled)
-                {
-                    switch ((Patch::SelfNode::TargetID)selfNode.modtarget[i].value)
-                    {
-                    case Patch::SelfNode::DIRECT:
-                        fbMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::SelfNode::DEPTH_ATTEN:
-                        depthAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::SelfNode::LFO_DEPTH_ATTEN:
-                        lfoAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
+        case Patch::SelfNode::DIRECT:
+            return {&fbMod, ModRoute::ADD};
+        case Patch::SelfNode::DEPTH_ATTEN:
+            return {&depthAtten, ModRoute::ATTEN};
+        case Patch::SelfNode::LFO_DEPTH_ATTEN:
+            return {&lfoAtten, ModRoute::ATTEN};
+        default:
+            break;
         }
+        return {};
     }
 
     bool checkLfoUsed() { return lfoToFB != 0 || lfoUsedAsModulationSource; }
@@ -449,7 +418,7 @@ struct MixerNode : EnvelopeSupport<Patch::MixerNode>,
         : mixerNode(mn), monoValues(mv), voiceValues(vv), from(f), pan(mn.pan), level(mn.level),
           activeF(mn.active), lfoToLevel(mn.lfoToLevel), lfoToPan(mn.lfoToPan),
           envToLevel(mn.envToLevel), lfoLevelMode(mn.lfoLevelMode), EnvelopeSupport(mn, mv, vv),
-          LFOSupport(mn, mv), ModulationSupport(mn, this, mv, vv)
+          LFOSupport(mn, mv, vv), ModulationSupport(mn, this, mv, vv)
     {
         memset(output, 0, sizeof(output));
     }
@@ -457,6 +426,29 @@ struct MixerNode : EnvelopeSupport<Patch::MixerNode>,
     float doBlock{false};
     sst::basic_blocks::dsp::DCBlocker<blockSize> dcBlocker;
 
+    // Nothing from the operator reaches the output until a reattack: the level is pinned
+    // at zero by a finished envelope, with no modulation (a modulated sustain could lift
+    // it) and no additive LFO. A zero level or a solo can be undone mid note, so they
+    // don't count; the envelopes have to have run when they are.
+    bool contributesNothing() const
+    {
+        if (!active)
+            return true;
+        return envIsMult && envSettledAtZero() && !anySources &&
+               (lfoLevelMode >= 0.5f || lfoToLevel == 0.f);
+    }
+
+    // The level could still come up on its own: an envelope yet to peak (or an additive
+    // one falling away from a negative depth), a tremolo, or modulation. A released voice
+    // under none of these only gets quieter.
+    bool levelCanRise() const
+    {
+        if (!active)
+            return false;
+        auto rising = !constantEnv && env.stage < env_t::s_decay;
+        return rising || (!envIsMult && envToLevel < 0.f) || lfoToLevel != 0.f || anySources;
+    }
+
     void attack()
     {
         resetModulation();
@@ -499,6 +491,7 @@ struct MixerNode : EnvelopeSupport<Patch::MixerNode>,
         {
             return;
         }
+        node_profiler::Scope profile(node_profiler::MIXER);
 
         float vSum alignas(16)[blockSize];
 
@@ -624,51 +617,27 @@ struct MixerNode : EnvelopeSupport<Patch::MixerNode>,
         resetModulation();
         envResetMod();
         lfoResetMod();
+        runModulation();
+    }
 
-        if (!anySources)
-            return;
-
-        for (int i = 0; i < numModsPer; ++i)
+    ModRoute nodeModulationRoute(int target)
+    {
+        switch ((Patch::MixerNode::TargetID)target)
         {
-            if (sourcePointers[i] &&
-                (int)mixerNode.modtarget[i].value != Patch::MixerNode::TargetID::NONE)
-            {
-                // targets: env depth atten, lfo dept atten, direct adjust, env attack, lfo rate
-                auto dp = depthPointers[i];
-                if (!dp)
-                    continue;
-                auto d = *dp;
-
-                auto handled = envHandleModulationValue((int)mixerNode.modtarget[i].value, d,
-                                                        sourcePointers[i]) ||
-                               lfoHandleModulationValue((int)mixerNode.modtarget[i].value, d,
-                                                        sourcePointers[i]);
-
-                if (!handled)
-                {
-                    switch ((Patch::MixerNode::TargetID)mixerNode.modtarget[i].value)
-                    {
-                    case Patch::MixerNode::DIRECT:
-                        levMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::MixerNode::PAN:
-                        panMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::MixerNode::DEPTH_ATTEN:
-                        depthAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::MixerNode::LFO_DEPTH_ATTEN:
-                        lfoAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::MixerNode::LFO_DEPTH_PAN_ATTEN:
-                        lfoPanAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
+        case Patch::MixerNode::DIRECT:
+            return {&levMod, ModRoute::ADD};
+        case Patch::MixerNode::PAN:
+            return {&panMod, ModRoute::ADD};
+        case Patch::MixerNode::DEPTH_ATTEN:
+            return {&depthAtten, ModRoute::ATTEN};
+        case Patch::MixerNode::LFO_DEPTH_ATTEN:
+            return {&lfoAtten, ModRoute::ATTEN};
+        case Patch::MixerNode::LFO_DEPTH_PAN_ATTEN:
+            return {&lfoPanAtten, ModRoute::ATTEN};
+        default:
+            break;
         }
+        return {};
     }
 };
 
@@ -687,8 +656,9 @@ struct MainPanNode : EnvelopeSupport<Patch::MainPanNode>,
     const float &lfoD, &envD;
 
     MainPanNode(const Patch::MainPanNode &mn, MonoValues &mv, const VoiceValues &vv)
-        : ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv),
-          modNode(mn), monoValues(mv), voiceValues(vv), lfoD(mn.lfoDepth), envD(mn.envDepth)
+        : ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv),
+          LFOSupport(mn, mv, vv), modNode(mn), monoValues(mv), voiceValues(vv), lfoD(mn.lfoDepth),
+          envD(mn.envDepth)
     {
     }
 
@@ -762,51 +732,27 @@ struct MainPanNode : EnvelopeSupport<Patch::MainPanNode>,
         resetModulation();
         envResetMod();
         lfoResetMod();
+        runModulation();
+    }
 
-        if (!anySources)
-            return;
-
-        for (int i = 0; i < numModsPer; ++i)
+    ModRoute nodeModulationRoute(int target)
+    {
+        switch ((Patch::MainPanNode::TargetID)target)
         {
-            if (sourcePointers[i] &&
-                (int)modNode.modtarget[i].value != Patch::MainPanNode::TargetID::NONE)
-            {
-                // targets: env depth atten, lfo dept atten, direct adjust, env attack, lfo rate
-                auto dp = depthPointers[i];
-                if (!dp)
-                    continue;
-                auto d = *dp;
-
-                auto handled =
-                    envHandleModulationValue((int)modNode.modtarget[i].value, d,
-                                             sourcePointers[i]) ||
-                    lfoHandleModulationValue((int)modNode.modtarget[i].value, d, sourcePointers[i]);
-
-                if (!handled)
-                {
-                    switch ((Patch::MainPanNode::TargetID)modNode.modtarget[i].value)
-                    {
-                    case Patch::MainPanNode::DIRECT:
-                        directMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::MainPanNode::ENVDEP_DIR:
-                        edMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::MainPanNode::LFODEP_DIR:
-                        ldMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::MainPanNode::DEPTH_ATTEN:
-                        envAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::MainPanNode::LFO_DEPTH_ATTEN:
-                        lfoAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
+        case Patch::MainPanNode::DIRECT:
+            return {&directMod, ModRoute::ADD};
+        case Patch::MainPanNode::ENVDEP_DIR:
+            return {&edMod, ModRoute::ADD};
+        case Patch::MainPanNode::LFODEP_DIR:
+            return {&ldMod, ModRoute::ADD};
+        case Patch::MainPanNode::DEPTH_ATTEN:
+            return {&envAtten, ModRoute::ATTEN};
+        case Patch::MainPanNode::LFO_DEPTH_ATTEN:
+            return {&lfoAtten, ModRoute::ATTEN};
+        default:
+            break;
         }
+        return {};
     }
 
     bool checkLfoUsed() { return lfoD != 0 || lfoUsedAsModulationSource; }
@@ -827,9 +773,9 @@ struct FineTuneNode : EnvelopeSupport<Patch::FineTuneNode>,
     const float &lfoD, &envD, &coarseTune, &lfoCoarseD, &envCoarseD;
 
     FineTuneNode(const Patch::FineTuneNode &mn, MonoValues &mv, const VoiceValues &vv)
-        : ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv),
-          coarseTune(mn.coarseTune), modNode(mn), monoValues(mv), voiceValues(vv),
-          lfoD(mn.lfoDepth), envD(mn.envDepth), lfoCoarseD(mn.lfoCoarseDepth),
+        : ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv),
+          LFOSupport(mn, mv, vv), coarseTune(mn.coarseTune), modNode(mn), monoValues(mv),
+          voiceValues(vv), lfoD(mn.lfoDepth), envD(mn.envDepth), lfoCoarseD(mn.lfoCoarseDepth),
           envCoarseD(mn.envCoarseDepth)
     {
     }
@@ -912,54 +858,29 @@ struct FineTuneNode : EnvelopeSupport<Patch::FineTuneNode>,
         resetModulation();
         envResetMod();
         lfoResetMod();
+        runModulation();
+    }
 
-        if (!anySources)
-            return;
-
-        for (int i = 0; i < numModsPer; ++i)
+    ModRoute nodeModulationRoute(int target)
+    {
+        switch (target)
         {
-            if (sourcePointers[i] &&
-                (int)modNode.modtarget[i].value != Patch::FineTuneNode::TargetID::NONE)
-            {
-                // targets: env depth atten, lfo dept atten, direct adjust, env attack, lfo rate
-                auto dp = depthPointers[i];
-                if (!dp)
-                    continue;
-                auto d = *dp;
-
-                auto handled =
-                    envHandleModulationValue((int)modNode.modtarget[i].value, d,
-                                             sourcePointers[i]) ||
-                    lfoHandleModulationValue((int)modNode.modtarget[i].value, d, sourcePointers[i]);
-
-                if (!handled)
-                {
-                    switch ((int32_t)modNode.modtarget[i].value)
-                    {
-                    case Patch::FineTuneNode::DIRECT:
-                        directMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::FineTuneNode::ENVDEP_DIR:
-                        edMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::FineTuneNode::LFODEP_DIR:
-                        ldMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::FineTuneNode::DEPTH_ATTEN:
-                        envAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::FineTuneNode::LFO_DEPTH_ATTEN:
-                        lfoAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::FineTuneNode::COARSE:
-                        directCoarseMod += d * *sourcePointers[i];
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
+        case Patch::FineTuneNode::DIRECT:
+            return {&directMod, ModRoute::ADD};
+        case Patch::FineTuneNode::ENVDEP_DIR:
+            return {&edMod, ModRoute::ADD};
+        case Patch::FineTuneNode::LFODEP_DIR:
+            return {&ldMod, ModRoute::ADD};
+        case Patch::FineTuneNode::DEPTH_ATTEN:
+            return {&envAtten, ModRoute::ATTEN};
+        case Patch::FineTuneNode::LFO_DEPTH_ATTEN:
+            return {&lfoAtten, ModRoute::ATTEN};
+        case Patch::FineTuneNode::COARSE:
+            return {&directCoarseMod, ModRoute::ADD};
+        default:
+            break;
         }
+        return {};
     }
 
     bool checkLfoUsed() { return lfoD != 0 || lfoCoarseD != 0 || lfoUsedAsModulationSource; }
@@ -990,7 +911,7 @@ struct OutputNode : EnvelopeSupport<Patch::OutputNode>,
         : outputNode(on), ModulationSupport(on, this, mv, vv), monoValues(mv), voiceValues(vv),
           fromArr(f), level(on.level), bendUp(on.bendUp), bendDown(on.bendDown),
           octTranspose(on.octTranspose), velSen(on.velSensitivity), EnvelopeSupport(on, mv, vv),
-          LFOSupport(on, mv), defTrigV(on.defaultTrigger), pan(on.pan), fineTune(on.fineTune),
+          LFOSupport(on, mv, vv), defTrigV(on.defaultTrigger), pan(on.pan), fineTune(on.fineTune),
           lfoDepth(on.lfoDepth), ftModNode(ftMN, mv, vv), panModNode(panMN, mv, vv)
     {
         memset(output, 0, sizeof(output));
@@ -1017,6 +938,7 @@ struct OutputNode : EnvelopeSupport<Patch::OutputNode>,
     float finalEnvLevel alignas(16)[blockSize];
     void renderBlock()
     {
+        node_profiler::Scope profile(node_profiler::MIXER);
         calculateModulation();
         for (const auto &from : fromArr)
         {
@@ -1099,48 +1021,25 @@ struct OutputNode : EnvelopeSupport<Patch::OutputNode>,
         resetModulation();
         envResetMod();
         lfoResetMod();
+        runModulation();
+    }
 
-        if (!anySources)
-            return;
-
-        for (int i = 0; i < numModsPer; ++i)
+    ModRoute nodeModulationRoute(int target)
+    {
+        switch ((Patch::OutputNode::TargetID)target)
         {
-            if (sourcePointers[i] &&
-                (int)outputNode.modtarget[i].value != Patch::OutputNode::TargetID::NONE)
-            {
-                // targets: env depth atten, lfo dept atten, direct adjust, env attack, lfo rate
-                auto dp = depthPointers[i];
-                if (!dp)
-                    continue;
-                auto d = *dp;
-
-                auto handled = envHandleModulationValue((int)outputNode.modtarget[i].value, d,
-                                                        sourcePointers[i]) ||
-                               lfoHandleModulationValue((int)outputNode.modtarget[i].value, d,
-                                                        sourcePointers[i]);
-
-                if (!handled)
-                {
-                    switch ((Patch::OutputNode::TargetID)outputNode.modtarget[i].value)
-                    {
-                    case Patch::OutputNode::PAN:
-                        panMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::OutputNode::DIRECT:
-                        levMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::OutputNode::DEPTH_ATTEN:
-                        depthAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::OutputNode::LFO_DEPTH_ATTEN:
-                        lfoAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
+        case Patch::OutputNode::PAN:
+            return {&panMod, ModRoute::ADD};
+        case Patch::OutputNode::DIRECT:
+            return {&levMod, ModRoute::ADD};
+        case Patch::OutputNode::DEPTH_ATTEN:
+            return {&depthAtten, ModRoute::ATTEN};
+        case Patch::OutputNode::LFO_DEPTH_ATTEN:
+            return {&lfoAtten, ModRoute::ATTEN};
+        default:
+            break;
         }
+        return {};
     }
 
     bool checkLfoUsed() { return lfoDepth != 0 || lfoUsedAsModulationSource; }
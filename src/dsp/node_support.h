@@ -31,6 +31,7 @@
 #include "synth/mono_values.h"
 #include "synth/voice_values.h"
 #include "synth/patch.h"
+#include "synth/node_profiler.h"
 
 namespace baconpaul::six_sines
 {
@@ -48,6 +49,31 @@ enum TriggerMode
 static const char *TriggerModeName[5]{"On Start or In Release (Legato)", "On Start Voice Only",
                                       "On Any Key Press", "Patch Default", "On Release"};
 
+/*
+ * Where a modulation slot lands once its target is resolved: the float it writes and
+ * how it combines depth * source into it. SET overwrites (envelope and lfo targets),
+ * ADD accumulates (direct targets), ATTEN scales by 1 - depth * (1 - clamp(source))
+ * and EXP2_RATE writes 2^(3 * depth * source). For SET and ADD, depth * source is
+ * multiplied by scale and then divided by divisor, in double, so a route reproduces
+ * the expression its target always used (ratio fine is depth * source * 2.0 / 12.0)
+ * bit for bit. Each node maps its own targets with nodeModulationRoute.
+ */
+struct ModRoute
+{
+    enum Op : uint8_t
+    {
+        SET,
+        ADD,
+        ATTEN,
+        EXP2_RATE,
+        numOps
+    };
+    float *dest{nullptr};
+    Op op{ADD};
+    double scale{1.0};
+    double divisor{1.0};
+};
+
 template <typename T> struct EnvelopeSupport
 {
     const MonoValues &monoValues;
@@ -78,7 +104,7 @@ template <typename T> struct EnvelopeSupport
         releaseMod{0.f};
     float aShapeMod{0.f}, dShapeMod{0.f}, rShapeMod{0.f};
     // Multiplier on env phase advance; 1.0 = unmodulated. The 2^(3*x) is folded
-    // into the mod handler so the unmodulated path costs nothing.
+    // into the mod program so the unmodulated path costs nothing.
     float envRateMul{1.f};
     bool releaseEnvStarted{false}, releaseEnvUngated{false};
     bool envIsMult{true};
@@ -164,6 +190,7 @@ template <typename T> struct EnvelopeSupport
     {
         if (!active || constantEnv)
             return;
+        node_profiler::Scope profile(node_profiler::MODULATORS);
 
         if (triggerMode == ON_RELEASE)
         {
@@ -228,6 +255,17 @@ template <typename T> struct EnvelopeSupport
         }
     }
 
+    // True once the envelope can only output zero until it is attacked again: finished, or
+    // held at a zero sustain (envProcess zero fills both). ON_RELEASE envelopes are waiting
+    // for their trigger rather than done, so they never count.
+    bool envSettledAtZero() const
+    {
+        if (!active || constantEnv || triggerMode == ON_RELEASE)
+            return false;
+        return env.stage > env_t::s_release ||
+               (voiceValues.gated && env.stage == env_t::s_sustain && sustain == 0.f);
+    }
+
     void envCleanup()
     {
         memset(env.outputCache, 0, sizeof(env.outputCache));
@@ -249,51 +287,44 @@ template <typename T> struct EnvelopeSupport
         envRateMul = 1.f;
     }
 
-    bool envHandleModulationValue(int target, const float depth, const float *source)
+    ModRoute envModulationRoute(int target)
     {
         switch (target)
         {
         case Patch::DAHDSRMixin::ENV_DELAY:
-            delayMod = depth * *source;
-            return true;
+            return {&delayMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_ATTACK:
-            attackMod = depth * *source;
-            return true;
+            return {&attackMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_HOLD:
-            holdMod = depth * *source;
-            return true;
+            return {&holdMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_DECAY:
-            decayMod = depth * *source;
-            return true;
+            return {&decayMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_SUSTAIN:
-            sustainMod = depth * *source;
-            return true;
+            return {&sustainMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_RELEASE:
-            releaseMod = depth * *source;
-            return true;
+            return {&releaseMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_ASHAPE:
-            aShapeMod = depth * *source;
-            return true;
+            return {&aShapeMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_DSHAPE:
-            dShapeMod = depth * *source;
-            return true;
+            return {&dShapeMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_RSHAPE:
-            rShapeMod = depth * *source;
-            return true;
+            return {&rShapeMod, ModRoute::SET};
         case Patch::DAHDSRMixin::ENV_RATE:
-            // 2^(3*x): +1 -> 8x faster, -1 -> 8x slower. Computed here (per bound
-            // route) so the unmodulated env pays nothing.
-            envRateMul = monoValues.twoToTheX.twoToThe(3.f * depth * *source);
-            return true;
+            // 2^(3*x): +1 -> 8x faster, -1 -> 8x slower. Computed per bound route
+            // so the unmodulated env pays nothing.
+            return {&envRateMul, ModRoute::EXP2_RATE};
         }
-        return false;
+        return {};
     }
 };
 
 template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSupport
 {
     const T &paramBundle;
-    MonoValues &monoValues; // non-const so we can read the RNG
+    MonoValues &monoValues;
+    // Random shapes draw from the voice's own RNG, not the shared mono one, so
+    // voices can render on separate threads with output independent of order.
+    sst::basic_blocks::dsp::RNG &rng;
 
     const float &lfoRate, &lfoDeform, &lfoShape, &lfoActiveV, &tempoSyncV, &bipolarV,
         &lfoIsEnvelopedV, &lfoStartPhase, &runModeV;
@@ -310,8 +341,9 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
     const float *stepCountValue{nullptr};
     const float *stepCycleModeValue{nullptr};
 
-    LFOSupport(const T &mn, MonoValues &mv)
-        : paramBundle(mn), lfo(&mv.sr, mv.rng), stepLFO(mv.tuningProvider), lfoRate(mn.lfoRate),
+    LFOSupport(const T &mn, MonoValues &mv, const VoiceValues &vv)
+        : paramBundle(mn), rng(vv.rng), lfo(&mv.sr, vv.rng), stepLFO(mv.tuningProvider),
+          lfoRate(mn.lfoRate),
           lfoDeform(mn.lfoDeform), lfoShape(mn.lfoShape), lfoActiveV(mn.lfoActive),
           tempoSyncV(mn.tempoSync), monoValues(mv), bipolarV(mn.lfoBipolar),
           lfoIsEnvelopedV(mn.lfoIsEnveloped), lfoStartPhase(mn.lfoStartPhase), runModeV(mn.runMode),
@@ -386,7 +418,7 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
                 snapRate = -paramBundle.lfoRate.meta.snapToTemposync(-snapRate);
             auto useRate = std::clamp(snapRate + lfoRateMod, paramBundle.lfoRate.meta.minVal,
                                       paramBundle.lfoRate.meta.maxVal);
-            stepLFO.assign(&stepStorage, useRate, &stepTransport, monoValues.rng, tempoSync);
+            stepLFO.assign(&stepStorage, useRate, &stepTransport, rng, tempoSync);
 
             // Start position expressed as a continuous step index (integer part = step,
             // fractional part = phase within the step). The user start phase is a fraction
@@ -467,6 +499,7 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
 
             return;
         }
+        node_profiler::Scope profile(node_profiler::MODULATORS);
 
         auto rate = lfoRate;
 
@@ -521,21 +554,18 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
         lfoStartMod = 0.f;
     }
 
-    bool lfoHandleModulationValue(int target, const float depth, const float *source)
+    ModRoute lfoModulationRoute(int target)
     {
         switch (target)
         {
         case Patch::LFOMixin::LFO_RATE:
-            lfoRateMod = depth * *source * 4;
-            return true;
+            return {&lfoRateMod, ModRoute::SET, 4.0};
         case Patch::LFOMixin::LFO_DEFORM:
-            lfoDeformMod = depth * *source;
-            return true;
+            return {&lfoDeformMod, ModRoute::SET};
         case Patch::LFOMixin::LFO_STARTPHASE:
-            lfoStartMod = depth * *source;
-            return true;
+            return {&lfoStartMod, ModRoute::SET};
         }
-        return false;
+        return {};
     }
 };
 
@@ -552,6 +582,24 @@ template <typename Bundle, typename Node> struct ModulationSupport
     std::array<const float *, numModsPer> depthPointers;
     std::array<float, numModsPer> priorModulation;
 
+    /*
+     * The compiled modulation program. compileModulation resolves each bound slot's
+     * target to a destination and op once, grouped by op, so runModulation is a few
+     * straight loops with no per slot dispatch. It is rebuilt when bindModulation
+     * runs and when a modtarget moves under a held voice; depths are read through
+     * their pointer so a depth change needs no rebuild.
+     */
+    struct ModInstruction
+    {
+        float *dest;
+        const float *src;
+        const float *depth;
+        double scale, divisor;
+    };
+    std::array<ModInstruction, numModsPer> modProgram{};
+    std::array<int, ModRoute::numOps + 1> modProgramStart{};
+    std::array<float, numModsPer> compiledTargets;
+
     float modr01{0.f}, modrpm1{0.f}, modrnorm{0.f}, modrhalfnorm{0.f};
 
     ModulationSupport(const Bundle &mn, Node *p, MonoValues &mv, const VoiceValues &vv)
@@ -561,6 +609,7 @@ template <typename Bundle, typename Node> struct ModulationSupport
     {
         std::fill(sourcePointers.begin(), sourcePointers.end(), nullptr);
         std::fill(priorModulation.begin(), priorModulation.end(), 0.f);
+        std::fill(compiledTargets.begin(), compiledTargets.end(), 0.f);
     }
 
     bool lfoUsedAsModulationSource{false};
@@ -594,6 +643,86 @@ template <typename Bundle, typename Node> struct ModulationSupport
             modrpm1 = monoValues.rng.unifPM1();
             modrnorm = monoValues.rng.normPM1();
             modrhalfnorm = monoValues.rng.half01();
+            compileModulation();
+        }
+    }
+
+    void compileModulation()
+    {
+        std::array<ModRoute, numModsPer> routes{};
+        std::array<int, ModRoute::numOps> counts{};
+        for (int i = 0; i < numModsPer; ++i)
+        {
+            compiledTargets[i] = paramBundle.modtarget[i].value;
+            if (!sourcePointers[i] || !depthPointers[i])
+                continue;
+
+            // envelope then lfo then node targets, the same precedence the ids had
+            // when each block walked the handlers
+            auto t = (int)compiledTargets[i];
+            auto r = enclosingNode->envModulationRoute(t);
+            if (!r.dest)
+                r = enclosingNode->lfoModulationRoute(t);
+            if (!r.dest)
+                r = enclosingNode->nodeModulationRoute(t);
+            routes[i] = r;
+            if (r.dest)
+                counts[r.op]++;
+        }
+
+        modProgramStart[0] = 0;
+        for (int o = 0; o < ModRoute::numOps; ++o)
+            modProgramStart[o + 1] = modProgramStart[o] + counts[o];
+
+        // Slots keep their order within an op, so repeated targets combine as before
+        auto next = modProgramStart;
+        for (int i = 0; i < numModsPer; ++i)
+        {
+            if (routes[i].dest)
+                modProgram[next[routes[i].op]++] = {routes[i].dest, sourcePointers[i],
+                                                    depthPointers[i], routes[i].scale,
+                                                    routes[i].divisor};
+        }
+    }
+
+    bool modTargetsChanged() const
+    {
+        bool res{false};
+        for (int i = 0; i < numModsPer; ++i)
+            res = res || paramBundle.modtarget[i].value != compiledTargets[i];
+        return res;
+    }
+
+    // Call after the node and its env and lfo have reset their modulated values
+    void runModulation()
+    {
+        if (!anySources)
+            return;
+
+        if (modTargetsChanged())
+            compileModulation();
+
+        for (int k = modProgramStart[ModRoute::SET]; k < modProgramStart[ModRoute::SET + 1]; ++k)
+        {
+            auto &m = modProgram[k];
+            *m.dest = *m.depth * *m.src * m.scale / m.divisor;
+        }
+        for (int k = modProgramStart[ModRoute::ADD]; k < modProgramStart[ModRoute::ADD + 1]; ++k)
+        {
+            auto &m = modProgram[k];
+            *m.dest += *m.depth * *m.src * m.scale / m.divisor;
+        }
+        for (int k = modProgramStart[ModRoute::ATTEN]; k < modProgramStart[ModRoute::ATTEN + 1];
+             ++k)
+        {
+            auto &m = modProgram[k];
+            *m.dest *= 1.0 - *m.depth * (1.0 - std::clamp(*m.src, 0.f, 1.f));
+        }
+        for (int k = modProgramStart[ModRoute::EXP2_RATE];
+             k < modProgramStart[ModRoute::EXP2_RATE + 1]; ++k)
+        {
+            auto &m = modProgram[k];
+            *m.dest = monoValues.twoToTheX.twoToThe(3.f * *m.depth * *m.src);
         }
     }
 
@@ -16,6 +16,7 @@
 #ifndef BACONPAUL_SIX_SINES_DSP_OP_SOURCE_H
 #define BACONPAUL_SIX_SINES_DSP_OP_SOURCE_H
 
+#include <cassert>
 #include <cstdint>
 #include <cmath>
 
@@ -48,6 +49,9 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
     // backward dependency unlocks a lot more compiler reordering.
     bool hasActiveFeedback{false};
     int opIndex{0}; // set by Voice constructor; 0 = op1 which can use AUDIO_IN
+    // Set by the voice while nothing can hear this op (see Voice::updateReachability). The
+    // output is zeroed once on the way in and the op isn't rendered until it wakes.
+    bool dormant{false};
 
     float output alignas(16)[blockSize];
 
@@ -137,13 +141,13 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
 
     OpSource(const Patch::SourceNode &sn, MonoValues &mv, const VoiceValues &vv)
         : sourceNode(sn), monoValues(mv), voiceValues(vv), EnvelopeSupport(sn, mv, vv),
-          LFOSupport(sn, mv), ModulationSupport(sn, this, mv, vv), ratio(sn.ratio),
+          LFOSupport(sn, mv, vv), ModulationSupport(sn, this, mv, vv), ratio(sn.ratio),
           activeV(sn.active), envToRatio(sn.envToRatio), lfoToRatio(sn.lfoToRatio),
           waveForm(sn.waveForm), kt(sn.keyTrack), ktv(sn.keyTrackValue),
           ktlo(sn.keyTrackValueIsLow), ktlov(sn.keyTrackLowFrequencyValue),
           startPhase(sn.startingPhase), octTranspose(sn.octTranspose), absOffset(sn.absoluteOffset),
           lfoToRatioFine(sn.lfoToRatioFine), envToRatioFine(sn.envToRatioFine),
-          noiseHelper(mv.rng, mv.dbToLinear)
+          noiseHelper(vv.rng, mv.dbToLinear)
     {
         reset();
     }
@@ -183,6 +187,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
             }
         }
         firstTime = true;
+        dormant = false;
         extendedMPrior = sourceNode.extendedModeM.value;
         // Configure the M/N lags only if the operator is actually using an extended mode
         // that consumes them. In NONE the lag members exist but are never touched.
@@ -218,7 +223,8 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
             resetPhaseOnly();
             fbVal[0] = 0.f;
             fbVal[1] = 0.f;
-            st.setWaveForm(waveFormCachedAtAttack);
+            st.setWaveForm(waveFormCachedAtAttack,
+                           monoValues.polySine ? SinTable::POLY : SinTable::TABLE);
 
             if (lfoIsEnveloped)
             {
@@ -341,15 +347,61 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
     sst::basic_blocks::dsp::OnePoleLag<float, false> extendedLagM, extendedLagN;
 
     bool firstTime{true};
+    node_profiler::Category profileCategory() const
+    {
+        return node_profiler::operatorCategory((uint32_t)extendedModeCachedAtAttack);
+    }
+
     void renderBlock()
+    {
+        node_profiler::Scope profile(profileCategory());
+        float rf, dRF;
+        if (!renderBlockPrologue(rf, dRF))
+            return;
+
+        if (softResetPhaseCount > 0)
+        {
+            float newOutput alignas(16)[blockSize];
+            innerLoop(output, fbVal, rf, dRF, phase);
+            innerLoop(newOutput, softFb, rf, dRF, softPhase);
+            float p0 = 1.f * softResetPhaseCount / softPhaseCount;
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                auto fac = p0 - i * dSoftPhase;
+                output[i] = fac * output[i] + (1 - fac) * newOutput[i];
+            }
+            softResetPhaseCount--;
+
+            if (softResetPhaseCount == 0)
+            {
+                phase = softPhase;
+                fbVal[0] = softFb[0];
+                fbVal[1] = softFb[1];
+            }
+        }
+        else
+        {
+            innerLoop(output, fbVal, rf, dRF, phase);
+        }
+    }
+
+    /*
+     * Everything renderBlock does before the inner loop: modulation, envelope, lfo and
+     * the ratio walk for this block. Returns false if the block is already complete
+     * (inactive or audio in) and there is no inner loop to run. Split out so the voice
+     * pack render can run the prologue per voice and the inner loop across voices.
+     */
+    bool renderBlockPrologue(float &rf, float &dRF)
     {
         if (!active)
         {
             memset(output, 0, sizeof(output));
             fbVal[0] = 0.f;
             fbVal[1] = 0.f;
-            return;
+            return false;
         }
+        node_profiler::Scope profile(profileCategory());
 
         if (isAudioInCachedAtAttack)
         {
@@ -363,7 +415,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
                 memset(output, 0, sizeof(output));
             }
             fbVal[0] = fbVal[1] = 0.f;
-            return;
+            return false;
         }
 
         /*
@@ -375,7 +427,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         lfoProcess();
         auto lfoFac = *lfoFacP;
 
-        auto rf = monoValues.twoToTheX.twoToThe(
+        rf = monoValues.twoToTheX.twoToThe(
                       ratio +
                       envRatioAtten * (envToRatio + centsScale * envToRatioFine) *
                           env.outputCache[blockSize - 1] +
@@ -387,34 +439,9 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         if (firstTime)
             priorRF = rf;
         firstTime = false;
-        auto dRF = (rf - priorRF) / blockSize;
+        dRF = (rf - priorRF) / blockSize;
         std::swap(rf, priorRF);
-
-        if (softResetPhaseCount > 0)
-        {
-            float newOutput alignas(16)[blockSize];
-            innerLoop(output, fbVal, rf, dRF, phase);
-            innerLoop(newOutput, softFb, rf, dRF, softPhase);
-            float p0 = 1.f * softResetPhaseCount / softPhaseCount;
-
-            for (int i = 0; i < blockSize; ++i)
-            {
-                auto fac = p0 - i * dSoftPhase;
-                output[i] = fac * output[i] + (1 - fac) * newOutput[i];
-            }
-            softResetPhaseCount--;
-
-            if (softResetPhaseCount == 0)
-            {
-                phase = softPhase;
-                fbVal[0] = softFb[0];
-                fbVal[1] = softFb[1];
-            }
-        }
-        else
-        {
-            innerLoop(output, fbVal, rf, dRF, phase);
-        }
+        return true;
     }
 
     static constexpr int softPhaseCount{16};
@@ -437,13 +464,25 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         // MatrixNodeSelf::applyBlock and stays false when self-FB is off for
         // this op (the common case for modulator stacks) — the UsesFB=false
         // path then skips the feedback math entirely.
-        if (hasActiveFeedback)
-            innerLoopDispatch<true>(onto, fbv, rf, dRF, phs);
+        // The SinTable backend is latched at attack and picks the lookup the same way,
+        // so the per sample loop never branches on it.
+        if (st.usesPoly())
+        {
+            if (hasActiveFeedback)
+                innerLoopDispatch<true, true>(onto, fbv, rf, dRF, phs);
+            else
+                innerLoopDispatch<false, true>(onto, fbv, rf, dRF, phs);
+        }
         else
-            innerLoopDispatch<false>(onto, fbv, rf, dRF, phs);
+        {
+            if (hasActiveFeedback)
+                innerLoopDispatch<true, false>(onto, fbv, rf, dRF, phs);
+            else
+                innerLoopDispatch<false, false>(onto, fbv, rf, dRF, phs);
+        }
     }
 
-    template <bool UsesFB>
+    template <bool UsesFB, bool Poly>
     void innerLoopDispatch(float *onto, float *fbv, float rf, const float dRF, uint32_t &phs)
     {
         using EM = Patch::SourceNode::ExtendedMode;
@@ -451,29 +490,30 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         switch (extendedModeCachedAtAttack)
         {
         case EM::NONE:
-            innerLoopImpl<UsesFB, EM::NONE>(onto, fbv, rf, dRF, phs);
+            innerLoopImpl<UsesFB, Poly, EM::NONE>(onto, fbv, rf, dRF, phs);
             break;
         case EM::PHASE_REMAP:
         {
+            constexpr auto PR = EM::PHASE_REMAP;
             switch (phaseMapShapeCachedAtAttack)
             {
             case PM::SAW:
-                innerLoopImpl<UsesFB, EM::PHASE_REMAP, PM::SAW>(onto, fbv, rf, dRF, phs);
+                innerLoopImpl<UsesFB, Poly, PR, PM::SAW>(onto, fbv, rf, dRF, phs);
                 break;
             case PM::SQUARE:
-                innerLoopImpl<UsesFB, EM::PHASE_REMAP, PM::SQUARE>(onto, fbv, rf, dRF, phs);
+                innerLoopImpl<UsesFB, Poly, PR, PM::SQUARE>(onto, fbv, rf, dRF, phs);
                 break;
             case PM::PULSE:
-                innerLoopImpl<UsesFB, EM::PHASE_REMAP, PM::PULSE>(onto, fbv, rf, dRF, phs);
+                innerLoopImpl<UsesFB, Poly, PR, PM::PULSE>(onto, fbv, rf, dRF, phs);
                 break;
             case PM::DOUBLE:
-                innerLoopImpl<UsesFB, EM::PHASE_REMAP, PM::DOUBLE>(onto, fbv, rf, dRF, phs);
+                innerLoopImpl<UsesFB, Poly, PR, PM::DOUBLE>(onto, fbv, rf, dRF, phs);
                 break;
             case PM::SIN_TO_SQUARE:
-                innerLoopImpl<UsesFB, EM::PHASE_REMAP, PM::SIN_TO_SQUARE>(onto, fbv, rf, dRF, phs);
+                innerLoopImpl<UsesFB, Poly, PR, PM::SIN_TO_SQUARE>(onto, fbv, rf, dRF, phs);
                 break;
             case PM::DOUBLE_SAW:
-                innerLoopImpl<UsesFB, EM::PHASE_REMAP, PM::DOUBLE_SAW>(onto, fbv, rf, dRF, phs);
+                innerLoopImpl<UsesFB, Poly, PR, PM::DOUBLE_SAW>(onto, fbv, rf, dRF, phs);
                 break;
             }
             break;
@@ -481,41 +521,36 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         case EM::RESONANT_SWEEP:
         {
             using RW = Patch::SourceNode::ResonantSweepWindow;
+            constexpr auto RS = EM::RESONANT_SWEEP;
             // The PhaseMapShape template arg is unused on this branch; leave it at default.
+            constexpr auto PMSAW = PM::SAW;
+            auto kScale = resonantSweepKScaleCachedAtAttack;
             switch (resonantSweepWindowCachedAtAttack)
             {
             case RW::SAW:
-                innerLoopImpl<UsesFB, EM::RESONANT_SWEEP, Patch::SourceNode::PhaseMapShape::SAW,
-                              RW::SAW>(onto, fbv, rf, dRF, phs, resonantSweepKScaleCachedAtAttack);
+                innerLoopImpl<UsesFB, Poly, RS, PMSAW, RW::SAW>(onto, fbv, rf, dRF, phs, kScale);
                 break;
             case RW::TRIANGLE:
-                innerLoopImpl<UsesFB, EM::RESONANT_SWEEP, Patch::SourceNode::PhaseMapShape::SAW,
-                              RW::TRIANGLE>(onto, fbv, rf, dRF, phs,
-                                            resonantSweepKScaleCachedAtAttack);
+                innerLoopImpl<UsesFB, Poly, RS, PMSAW, RW::TRIANGLE>(onto, fbv, rf, dRF, phs,
+                                                                     kScale);
                 break;
             case RW::TRAPEZOID:
-                innerLoopImpl<UsesFB, EM::RESONANT_SWEEP, Patch::SourceNode::PhaseMapShape::SAW,
-                              RW::TRAPEZOID>(onto, fbv, rf, dRF, phs,
-                                             resonantSweepKScaleCachedAtAttack);
+                innerLoopImpl<UsesFB, Poly, RS, PMSAW, RW::TRAPEZOID>(onto, fbv, rf, dRF, phs,
+                                                                      kScale);
                 break;
             case RW::FULLTRAP:
-                innerLoopImpl<UsesFB, EM::RESONANT_SWEEP, Patch::SourceNode::PhaseMapShape::SAW,
-                              RW::FULLTRAP>(onto, fbv, rf, dRF, phs,
-                                            resonantSweepKScaleCachedAtAttack);
+                innerLoopImpl<UsesFB, Poly, RS, PMSAW, RW::FULLTRAP>(onto, fbv, rf, dRF, phs,
+                                                                     kScale);
                 break;
             case RW::HANN:
-                innerLoopImpl<UsesFB, EM::RESONANT_SWEEP, Patch::SourceNode::PhaseMapShape::SAW,
-                              RW::HANN>(onto, fbv, rf, dRF, phs, resonantSweepKScaleCachedAtAttack);
+                innerLoopImpl<UsesFB, Poly, RS, PMSAW, RW::HANN>(onto, fbv, rf, dRF, phs, kScale);
                 break;
             case RW::BLACKMAN_HARRIS:
-                innerLoopImpl<UsesFB, EM::RESONANT_SWEEP, Patch::SourceNode::PhaseMapShape::SAW,
-                              RW::BLACKMAN_HARRIS>(onto, fbv, rf, dRF, phs,
-                                                   resonantSweepKScaleCachedAtAttack);
+                innerLoopImpl<UsesFB, Poly, RS, PMSAW, RW::BLACKMAN_HARRIS>(onto, fbv, rf, dRF,
+                                                                            phs, kScale);
                 break;
             case RW::TUKEY:
-                innerLoopImpl<UsesFB, EM::RESONANT_SWEEP, Patch::SourceNode::PhaseMapShape::SAW,
-                              RW::TUKEY>(onto, fbv, rf, dRF, phs,
-                                         resonantSweepKScaleCachedAtAttack);
+                innerLoopImpl<UsesFB, Poly, RS, PMSAW, RW::TUKEY>(onto, fbv, rf, dRF, phs, kScale);
                 break;
             }
             break;
@@ -523,29 +558,30 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         case EM::NOISE:
         {
             using NM = Patch::SourceNode::NoiseMode;
-            constexpr auto PMSAW = Patch::SourceNode::PhaseMapShape::SAW;
+            constexpr auto NZ = EM::NOISE;
+            constexpr auto PMSAW = PM::SAW;
             constexpr auto RWSAW = Patch::SourceNode::ResonantSweepWindow::SAW;
             switch (noiseModeCachedAtAttack)
             {
             case NM::ADD_TO_PHASE:
-                innerLoopImpl<UsesFB, EM::NOISE, PMSAW, RWSAW, NM::ADD_TO_PHASE>(onto, fbv, rf, dRF,
-                                                                                 phs);
+                innerLoopImpl<UsesFB, Poly, NZ, PMSAW, RWSAW, NM::ADD_TO_PHASE>(onto, fbv, rf, dRF,
+                                                                                phs);
                 break;
             case NM::ADD_TO_SIGNAL:
-                innerLoopImpl<UsesFB, EM::NOISE, PMSAW, RWSAW, NM::ADD_TO_SIGNAL>(onto, fbv, rf,
-                                                                                  dRF, phs);
+                innerLoopImpl<UsesFB, Poly, NZ, PMSAW, RWSAW, NM::ADD_TO_SIGNAL>(onto, fbv, rf,
+                                                                                 dRF, phs);
                 break;
             case NM::MIX_WITH_SIGNAL:
-                innerLoopImpl<UsesFB, EM::NOISE, PMSAW, RWSAW, NM::MIX_WITH_SIGNAL>(onto, fbv, rf,
-                                                                                    dRF, phs);
+                innerLoopImpl<UsesFB, Poly, NZ, PMSAW, RWSAW, NM::MIX_WITH_SIGNAL>(onto, fbv, rf,
+                                                                                   dRF, phs);
                 break;
             case NM::MUL_BY_SIGNAL:
-                innerLoopImpl<UsesFB, EM::NOISE, PMSAW, RWSAW, NM::MUL_BY_SIGNAL>(onto, fbv, rf,
-                                                                                  dRF, phs);
+                innerLoopImpl<UsesFB, Poly, NZ, PMSAW, RWSAW, NM::MUL_BY_SIGNAL>(onto, fbv, rf,
+                                                                                 dRF, phs);
                 break;
             case NM::MUL_BY_UNI_SIGNAL:
-                innerLoopImpl<UsesFB, EM::NOISE, PMSAW, RWSAW, NM::MUL_BY_UNI_SIGNAL>(onto, fbv, rf,
-                                                                                      dRF, phs);
+                innerLoopImpl<UsesFB, Poly, NZ, PMSAW, RWSAW, NM::MUL_BY_UNI_SIGNAL>(onto, fbv,
+                                                                                     rf, dRF, phs);
                 break;
             }
             break;
@@ -554,7 +590,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
     }
 
     template <
-        bool UsesFB, Patch::SourceNode::ExtendedMode ET,
+        bool UsesFB, bool Poly, Patch::SourceNode::ExtendedMode ET,
         Patch::SourceNode::PhaseMapShape S = Patch::SourceNode::PhaseMapShape::SAW,
         Patch::SourceNode::ResonantSweepWindow R = Patch::SourceNode::ResonantSweepWindow::SAW,
         Patch::SourceNode::NoiseMode NM = Patch::SourceNode::NoiseMode::ADD_TO_PHASE>
@@ -565,6 +601,13 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         using NMode = Patch::SourceNode::NoiseMode;
         using NT = Patch::SourceNode::NoiseType;
         using LM = Patch::SourceNode::LFSRMode;
+        auto lookup = [this](uint32_t p)
+        {
+            if constexpr (Poly)
+                return st.atPoly(p);
+            else
+                return st.at(p);
+        };
         float nextM{0.f}, dM{0.f};
         float nextN{0.f};
         NT noiseType{NT::PINK};
@@ -598,6 +641,24 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
             lfsrMode = lfsrModeCachedAtAttack;
         }
 
+        if constexpr (!UsesFB && ET == EM::NONE)
+        {
+            // Without self feedback no sample depends on the one before it, so work out
+            // the whole block of phases first and do the table lookups four at a time.
+            uint32_t phB alignas(16)[blockSize];
+            for (int i = 0; i < blockSize; ++i)
+            {
+                dPhase = st.dPhase((baseFrequency * (1.0 + fmAmount[i])) * rf + absOffset);
+                rf += dRF;
+                phs += dPhase;
+                phB[i] = phs + phaseInput[i];
+            }
+            st.atBlock(phB, onto, blockSize);
+            for (int i = 0; i < blockSize; ++i)
+                onto[i] = onto[i] * rmLevel[i];
+            return;
+        }
+
         for (int i = 0; i < blockSize; ++i)
         {
             dPhase = st.dPhase((baseFrequency * (1.0 + fmAmount[i])) * rf + absOffset);
@@ -645,7 +706,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
                 else if constexpr (S == PM::DOUBLE_SAW)
                     ph = remap::remapDoubleSaw(ph & phase::phaseMask, nextM);
                 nextM += dM;
-                out = st.at(ph);
+                out = lookup(ph);
             }
             else if constexpr (ET == EM::RESONANT_SWEEP)
             {
@@ -668,7 +729,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
                 auto kFactor = std::max(kScale * nextM + 1.0f, 0.f);
                 uint32_t kmph = static_cast<uint32_t>(static_cast<float>(wph) * kFactor);
                 nextM += dM;
-                out = window * st.at(kmph);
+                out = window * lookup(kmph);
             }
             else if constexpr (ET == EM::NOISE)
             {
@@ -685,30 +746,30 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
                 {
                     ph += static_cast<int32_t>(m * noise * phase::phaseMaxF *
                                                Patch::SourceNode::noisePhaseScale);
-                    out = st.at(ph);
+                    out = lookup(ph);
                 }
                 else if constexpr (NM == NMode::ADD_TO_SIGNAL)
                 {
-                    out = st.at(ph) + m * noise;
+                    out = lookup(ph) + m * noise;
                 }
                 else if constexpr (NM == NMode::MUL_BY_SIGNAL)
                 {
-                    out = st.at(ph) * (1.f + m * noise);
+                    out = lookup(ph) * (1.f + m * noise);
                 }
                 else if constexpr (NM == NMode::MUL_BY_UNI_SIGNAL)
                 {
-                    auto u = (st.at(ph) + 1.f) * 0.5f;
+                    auto u = (lookup(ph) + 1.f) * 0.5f;
                     out = u * (1.f + m * noise) * 2.f - 1.f;
                 }
                 else // MIX_WITH_SIGNAL
                 {
-                    auto base = st.at(ph);
+                    auto base = lookup(ph);
                     out = (1.f - m) * base + m * noise;
                 }
             }
             else
             {
-                out = st.at(ph);
+                out = lookup(ph);
             }
 
             out = out * rmLevel[i];
@@ -721,6 +782,192 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         }
     }
 
+    /*
+     * Cross-voice rendering. When many voices play the same patch, the same operator
+     * in each voice runs the same template instantiation of innerLoopImpl. For the
+     * EM::NONE case without a soft reset crossfade we can run up to voicePackWidth
+     * voices at once with one voice per SIMD lane: the phase accumulate, the dPhase
+     * calculation, the self feedback and the table interpolation all become
+     * structure-of-arrays. The feedback recurrence is per voice so it stays inside
+     * its lane. Voices are packed by hasActiveFeedback, which picks the UsesFB
+     * instantiation; each lane gathers from its own waveform table, so voices in a
+     * pack do not need to share a waveform.
+     *
+     * The lane math is the same sequence of operations as the scalar loop (dPhase
+     * and feedback are done in double, and the hermite dot product sums as
+     * (q0c0 + q1c1) + (q2c2 + q3c3) just like the two hadds in SinTable::at) so a
+     * packed voice is bit-identical to the scalar path on SSE. Operators on the
+     * SinTable POLY backend have no table to gather from and render one at a time.
+     */
+    static constexpr size_t voicePackWidth{4};
+
+    bool canRenderInVoicePack() const
+    {
+        return active && !isAudioInCachedAtAttack &&
+               extendedModeCachedAtAttack == Patch::SourceNode::ExtendedMode::NONE &&
+               softResetPhaseCount <= 0 && !st.usesPoly();
+    }
+
+    template <bool UsesFB>
+    static void innerLoopVoicePack(OpSource *const *ops, size_t n, const float *rfIn,
+                                   const float *dRFIn)
+    {
+        static constexpr uint32_t mask{(1 << 12) - 1};
+        static constexpr uint32_t umask{(1 << 14) - 1};
+        static constexpr size_t W{voicePackWidth};
+        static_assert(W == 4, "The voice pack lane transpose assumes 4 lanes");
+        assert(n > 0 && n <= W);
+        node_profiler::Scope profile(node_profiler::OP_SINE);
+
+        // Pad a partial pack by repeating the last voice; padded lanes are never written back
+        size_t li[W];
+        for (size_t k = 0; k < W; ++k)
+            li[k] = k < n ? k : n - 1;
+
+        float bfA alignas(16)[W], aoA alignas(16)[W], rfA alignas(16)[W], dRFA alignas(16)[W];
+        double ftpA alignas(16)[W];
+        int32_t phsA alignas(16)[W];
+        float fb0A alignas(16)[W], fb1A alignas(16)[W];
+        const SIMD_M128 *quad[W];
+
+        float fmT alignas(16)[blockSize][W];
+        int32_t piT alignas(16)[blockSize][W];
+        int32_t flT alignas(16)[blockSize][W];
+        float rmT alignas(16)[blockSize][W];
+        float outT alignas(16)[blockSize][W];
+
+        for (size_t k = 0; k < W; ++k)
+        {
+            auto *o = ops[li[k]];
+            bfA[k] = o->baseFrequency;
+            aoA[k] = o->absOffset;
+            rfA[k] = rfIn[li[k]];
+            dRFA[k] = dRFIn[li[k]];
+            ftpA[k] = o->st.frToPhase;
+            phsA[k] = (int32_t)o->phase;
+            fb0A[k] = o->fbVal[0];
+            fb1A[k] = o->fbVal[1];
+            quad[k] = o->st.simdQuad;
+            for (int i = 0; i < blockSize; ++i)
+            {
+                fmT[i][k] = o->fmAmount[i];
+                piT[i][k] = o->phaseInput[i];
+                rmT[i][k] = o->rmLevel[i];
+                if constexpr (UsesFB)
+                    flT[i][k] = o->feedbackLevel[i];
+            }
+        }
+
+        const auto oneD = SIMD_MM(set1_pd)(1.0);
+        const auto halfD = SIMD_MM(set1_pd)(0.5);
+        const auto bfV = SIMD_MM(load_ps)(bfA);
+        const auto aoV = SIMD_MM(load_ps)(aoA);
+        const auto bfLo = SIMD_MM(cvtps_pd)(bfV);
+        const auto bfHi = SIMD_MM(cvtps_pd)(SIMD_MM(movehl_ps)(bfV, bfV));
+        const auto aoLo = SIMD_MM(cvtps_pd)(aoV);
+        const auto aoHi = SIMD_MM(cvtps_pd)(SIMD_MM(movehl_ps)(aoV, aoV));
+        const auto ftpLo = SIMD_MM(load_pd)(ftpA);
+        const auto ftpHi = SIMD_MM(load_pd)(ftpA + 2);
+        const auto dRF = SIMD_MM(load_ps)(dRFA);
+        const auto lbMask = SIMD_MM(set1_epi32)(mask);
+        const auto ubMask = SIMD_MM(set1_epi32)(umask);
+
+        auto rf = SIMD_MM(load_ps)(rfA);
+        auto phs = SIMD_MM(load_si128)((const SIMD_M128I *)phsA);
+        auto dph = SIMD_MM(setzero_si128)();
+        auto fb0 = SIMD_MM(load_ps)(fb0A);
+        auto fb1 = SIMD_MM(load_ps)(fb1A);
+
+        for (int i = 0; i < blockSize; ++i)
+        {
+            // (baseFrequency * (1.0 + fmAmount[i])) * rf + absOffset in double, as the
+            // scalar loop does, then rounded to float since SinTable::dPhase takes a float
+            auto fm = SIMD_MM(load_ps)(fmT[i]);
+            auto fmLo = SIMD_MM(cvtps_pd)(fm);
+            auto fmHi = SIMD_MM(cvtps_pd)(SIMD_MM(movehl_ps)(fm, fm));
+            auto rfLo = SIMD_MM(cvtps_pd)(rf);
+            auto rfHi = SIMD_MM(cvtps_pd)(SIMD_MM(movehl_ps)(rf, rf));
+            auto frLo = SIMD_MM(add_pd)(
+                SIMD_MM(mul_pd)(SIMD_MM(mul_pd)(bfLo, SIMD_MM(add_pd)(oneD, fmLo)), rfLo), aoLo);
+            auto frHi = SIMD_MM(add_pd)(
+                SIMD_MM(mul_pd)(SIMD_MM(mul_pd)(bfHi, SIMD_MM(add_pd)(oneD, fmHi)), rfHi), aoHi);
+            auto fr = SIMD_MM(movelh_ps)(SIMD_MM(cvtpd_ps)(frLo), SIMD_MM(cvtpd_ps)(frHi));
+            auto dLo = SIMD_MM(mul_pd)(SIMD_MM(cvtps_pd)(fr), ftpLo);
+            auto dHi = SIMD_MM(mul_pd)(SIMD_MM(cvtps_pd)(SIMD_MM(movehl_ps)(fr, fr)), ftpHi);
+            dph = SIMD_MM(unpacklo_epi64)(SIMD_MM(cvttpd_epi32)(dLo), SIMD_MM(cvttpd_epi32)(dHi));
+            rf = SIMD_MM(add_ps)(rf, dRF);
+
+            phs = SIMD_MM(add_epi32)(phs, dph);
+            auto ph = SIMD_MM(add_epi32)(phs, SIMD_MM(load_si128)((const SIMD_M128I *)piT[i]));
+            if constexpr (UsesFB)
+            {
+                // fb = 0.5 * (fbv[0] + fbv[1]); fb = fb * (1 - sb * (1 - fb)) in double
+                // then (int32_t)(feedbackLevel * fb), lane by lane as innerLoopImpl does
+                auto fl = SIMD_MM(load_si128)((const SIMD_M128I *)flT[i]);
+                auto sb = SIMD_MM(srli_epi32)(fl, 31);
+                auto fbs = SIMD_MM(add_ps)(fb0, fb1);
+                auto fbLo = SIMD_MM(mul_pd)(halfD, SIMD_MM(cvtps_pd)(fbs));
+                auto fbHi = SIMD_MM(mul_pd)(halfD, SIMD_MM(cvtps_pd)(SIMD_MM(movehl_ps)(fbs, fbs)));
+                auto sbLo = SIMD_MM(cvtepi32_pd)(sb);
+                auto sbHi = SIMD_MM(cvtepi32_pd)(SIMD_MM(unpackhi_epi64)(sb, sb));
+                fbLo = SIMD_MM(mul_pd)(
+                    fbLo, SIMD_MM(sub_pd)(
+                              oneD, SIMD_MM(mul_pd)(sbLo, SIMD_MM(sub_pd)(oneD, fbLo))));
+                fbHi = SIMD_MM(mul_pd)(
+                    fbHi, SIMD_MM(sub_pd)(
+                              oneD, SIMD_MM(mul_pd)(sbHi, SIMD_MM(sub_pd)(oneD, fbHi))));
+                auto flLo = SIMD_MM(cvtepi32_pd)(fl);
+                auto flHi = SIMD_MM(cvtepi32_pd)(SIMD_MM(unpackhi_epi64)(fl, fl));
+                auto fbI = SIMD_MM(unpacklo_epi64)(
+                    SIMD_MM(cvttpd_epi32)(SIMD_MM(mul_pd)(flLo, fbLo)),
+                    SIMD_MM(cvttpd_epi32)(SIMD_MM(mul_pd)(flHi, fbHi)));
+                ph = SIMD_MM(add_epi32)(ph, fbI);
+            }
+
+            int32_t lb alignas(16)[W], ub alignas(16)[W];
+            SIMD_MM(store_si128)((SIMD_M128I *)lb, SIMD_MM(and_si128)(ph, lbMask));
+            auto ubV = SIMD_MM(and_si128)(SIMD_MM(srli_epi32)(ph, 12), ubMask);
+            SIMD_MM(store_si128)((SIMD_M128I *)ub, ubV);
+
+            auto q0 = quad[0][ub[0]], q1 = quad[1][ub[1]];
+            auto q2 = quad[2][ub[2]], q3 = quad[3][ub[3]];
+            auto c0 = SinTable::simdCubic[lb[0]], c1 = SinTable::simdCubic[lb[1]];
+            auto c2 = SinTable::simdCubic[lb[2]], c3 = SinTable::simdCubic[lb[3]];
+            SinTable::transpose4(q0, q1, q2, q3);
+            SinTable::transpose4(c0, c1, c2, c3);
+
+            auto v = SIMD_MM(add_ps)(
+                SIMD_MM(add_ps)(SIMD_MM(mul_ps)(q0, c0), SIMD_MM(mul_ps)(q1, c1)),
+                SIMD_MM(add_ps)(SIMD_MM(mul_ps)(q2, c2), SIMD_MM(mul_ps)(q3, c3)));
+            auto out = SIMD_MM(mul_ps)(v, SIMD_MM(load_ps)(rmT[i]));
+            SIMD_MM(store_ps)(outT[i], out);
+            if constexpr (UsesFB)
+            {
+                fb1 = fb0;
+                fb0 = out;
+            }
+        }
+
+        int32_t dphA alignas(16)[W];
+        SIMD_MM(store_si128)((SIMD_M128I *)phsA, phs);
+        SIMD_MM(store_si128)((SIMD_M128I *)dphA, dph);
+        SIMD_MM(store_ps)(fb0A, fb0);
+        SIMD_MM(store_ps)(fb1A, fb1);
+        for (size_t k = 0; k < n; ++k)
+        {
+            auto *o = ops[k];
+            o->phase = (uint32_t)phsA[k];
+            o->dPhase = dphA[k];
+            if constexpr (UsesFB)
+            {
+                o->fbVal[0] = fb0A[k];
+                o->fbVal[1] = fb1A[k];
+            }
+            for (int i = 0; i < blockSize; ++i)
+                o->output[i] = outT[i][k];
+        }
+    }
+
     void resetModulation()
     {
         envRatioAtten = 1.f;
@@ -735,56 +982,31 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         resetModulation();
         envResetMod();
         lfoResetMod();
+        runModulation();
+    }
 
-        if (!anySources)
-            return;
-
-        for (int i = 0; i < numModsPer; ++i)
+    ModRoute nodeModulationRoute(int target)
+    {
+        switch ((Patch::SourceNode::TargetID)target)
         {
-            if (sourcePointers[i] &&
-                (int)sourceNode.modtarget[i].value != Patch::SourceNode::TargetID::NONE)
-            {
-                // targets: env depth atten, lfo dept atten, direct adjust, env attack, lfo rate
-                auto dp = depthPointers[i];
-                if (!dp)
-                    continue;
-                auto d = *dp;
-
-                auto handled =
-                    envHandleModulationValue(sourceNode.modtarget[i].value, d, sourcePointers[i]) ||
-                    lfoHandleModulationValue(sourceNode.modtarget[i].value, d, sourcePointers[i]);
-
-                if (!handled)
-                {
-                    switch ((Patch::SourceNode::TargetID)sourceNode.modtarget[i].value)
-                    {
-                    case Patch::SourceNode::DIRECT:
-                        ratioMod += d * *sourcePointers[i] * 2;
-                        break;
-                    case Patch::SourceNode::DIRECT_FINE:
-                        ratioMod += d * *sourcePointers[i] * 2.0 / 12.0;
-                        break;
-                    case Patch::SourceNode::STARTING_PHASE:
-                        phaseMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::SourceNode::ENV_DEPTH_ATTEN:
-                        envRatioAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::SourceNode::LFO_DEPTH_ATTEN:
-                        lfoRatioAtten *= 1.0 - d * (1.0 - std::clamp(*sourcePointers[i], 0.f, 1.f));
-                        break;
-                    case Patch::SourceNode::EXTEND_M:
-                        extendedMMod += d * *sourcePointers[i];
-                        break;
-                    case Patch::SourceNode::EXTEND_N:
-                        extendedNMod += d * *sourcePointers[i];
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
+        case Patch::SourceNode::DIRECT:
+            return {&ratioMod, ModRoute::ADD, 2.0};
+        case Patch::SourceNode::DIRECT_FINE:
+            return {&ratioMod, ModRoute::ADD, 2.0, 12.0};
+        case Patch::SourceNode::STARTING_PHASE:
+            return {&phaseMod, ModRoute::ADD};
+        case Patch::SourceNode::ENV_DEPTH_ATTEN:
+            return {&envRatioAtten, ModRoute::ATTEN};
+        case Patch::SourceNode::LFO_DEPTH_ATTEN:
+            return {&lfoRatioAtten, ModRoute::ATTEN};
+        case Patch::SourceNode::EXTEND_M:
+            return {&extendedMMod, ModRoute::ADD};
+        case Patch::SourceNode::EXTEND_N:
+            return {&extendedNMod, ModRoute::ADD};
+        default:
+            break;
         }
+        return {};
     }
 
     SinTable st;
@@ -0,0 +1,129 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_DSP_OUTPUT_SHAPER_H
+#define BACONPAUL_SIX_SINES_DSP_OUTPUT_SHAPER_H
+
+#include <sst/basic-blocks/simd/setup.h>
+
+#include "configuration.h"
+
+/*
+ * The stateless end-of-chain stages (saturation, bit depth rounding and output gain)
+ * fused into one four lane pass over the stereo bus. Synth resolves which of them run,
+ * and where the filters split them, when the output settings change, and calls the
+ * matching shapeBlock instantiation, so nothing here branches per sample.
+ *
+ * The shapers match Synth::softSaturator and Synth::ojdSaturator to float rounding.
+ * Bit depth rounding is half away from zero, matching std::round at every boundary.
+ */
+namespace baconpaul::six_sines::output_shaper
+{
+struct Params
+{
+    float drive{1.f};
+    float scale{1.f}, invScale{1.f}; // bit depth steps each side of zero
+    float gain{1.f};
+};
+
+inline SIMD_M128 softSaturator(SIMD_M128 x)
+{
+    x = SIMD_MM(max_ps)(SIMD_MM(set1_ps)(-4.f), SIMD_MM(min_ps)(x, SIMD_MM(set1_ps)(4.f)));
+    auto x2 = SIMD_MM(mul_ps)(x, x);
+    auto num = SIMD_MM(mul_ps)(x, SIMD_MM(add_ps)(SIMD_MM(set1_ps)(27.f), x2));
+    auto den = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(27.f), SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(9.f), x2));
+    return SIMD_MM(div_ps)(num, den);
+}
+
+inline SIMD_M128 ojdSaturator(SIMD_M128 x)
+{
+    // Clamped to the rails the three regions are x plus a knee below -0.3 and above 0.9,
+    // and each knee is zero outside its own region, so both add without a select
+    constexpr float denLow = 1.f / (4.f * (1.f - 0.3f));
+    constexpr float denHigh = 1.f / (4.f * (1.f - 0.9f));
+    x = SIMD_MM(max_ps)(SIMD_MM(set1_ps)(-1.7f), SIMD_MM(min_ps)(x, SIMD_MM(set1_ps)(1.1f)));
+    auto xl = SIMD_MM(min_ps)(SIMD_MM(add_ps)(x, SIMD_MM(set1_ps)(0.3f)), SIMD_MM(setzero_ps)());
+    auto xh = SIMD_MM(max_ps)(SIMD_MM(sub_ps)(x, SIMD_MM(set1_ps)(0.9f)), SIMD_MM(setzero_ps)());
+    auto low = SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(denLow), SIMD_MM(mul_ps)(xl, xl));
+    auto high = SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(denHigh), SIMD_MM(mul_ps)(xh, xh));
+    return SIMD_MM(sub_ps)(SIMD_MM(add_ps)(x, low), high);
+}
+
+inline SIMD_M128 roundToSteps(SIMD_M128 x, SIMD_M128 scale, SIMD_M128 invScale)
+{
+    auto sign = SIMD_MM(set1_ps)(-0.f);
+    auto v = SIMD_MM(mul_ps)(x, scale);
+    auto mag = SIMD_MM(andnot_ps)(sign, v);
+    // Truncation floors |v|, and the remainder is exact, so a half or more steps up.
+    // Adding the half first would round 0.49999997 up to 1
+    auto fl = SIMD_MM(cvtepi32_ps)(SIMD_MM(cvttps_epi32)(mag));
+    auto up = SIMD_MM(cmpge_ps)(SIMD_MM(sub_ps)(mag, fl), SIMD_MM(set1_ps)(0.5f));
+    auto r = SIMD_MM(add_ps)(fl, SIMD_MM(and_ps)(up, SIMD_MM(set1_ps)(1.f)));
+    return SIMD_MM(mul_ps)(SIMD_MM(or_ps)(r, SIMD_MM(and_ps)(sign, v)), invScale);
+}
+
+template <int sat, bool crush, bool gain>
+void shapeBlock(float *__restrict L, float *__restrict R, const Params &p)
+{
+    if constexpr (sat == SAT_NONE && !crush && gain)
+    {
+        if (p.gain == 1.f)
+            return;
+    }
+
+    auto drive = SIMD_MM(set1_ps)(p.drive);
+    auto scale = SIMD_MM(set1_ps)(p.scale);
+    auto invScale = SIMD_MM(set1_ps)(p.invScale);
+    auto g = SIMD_MM(set1_ps)(p.gain);
+
+    auto shape = [&](SIMD_M128 x)
+    {
+        if constexpr (sat == SAT_SOFT)
+            x = softSaturator(SIMD_MM(mul_ps)(x, drive));
+        else if constexpr (sat == SAT_OJD)
+            x = ojdSaturator(SIMD_MM(mul_ps)(x, drive));
+        if constexpr (crush)
+            x = roundToSteps(x, scale, invScale);
+        if constexpr (gain)
+            x = SIMD_MM(mul_ps)(x, g);
+        return x;
+    };
+
+    for (int i = 0; i < blockSize; i += 4)
+    {
+        SIMD_MM(store_ps)(L + i, shape(SIMD_MM(load_ps)(L + i)));
+        SIMD_MM(store_ps)(R + i, shape(SIMD_MM(load_ps)(R + i)));
+    }
+}
+
+using shapeFn_t = void (*)(float *, float *, const Params &);
+
+inline shapeFn_t shapeFnFor(int sat, bool crush, bool gain)
+{
+#define SHAPE_FOR(S)                                                                               \
+    if (sat == S)                                                                                  \
+    {                                                                                              \
+        if (crush)                                                                                 \
+            return gain ? shapeBlock<S, true, true> : shapeBlock<S, true, false>;                  \
+        return gain ? shapeBlock<S, false, true> : shapeBlock<S, false, false>;                    \
+    }
+    SHAPE_FOR(SAT_SOFT);
+    SHAPE_FOR(SAT_OJD);
+    SHAPE_FOR(SAT_NONE);
+#undef SHAPE_FOR
+    return nullptr;
+}
+} // namespace baconpaul::six_sines::output_shaper
+#endif // OUTPUT_SHAPER_H
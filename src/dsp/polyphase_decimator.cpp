@@ -0,0 +1,127 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "polyphase_decimator.h"
+
+#include <array>
+#include <cmath>
+
+namespace baconpaul::six_sines
+{
+namespace
+{
+double besselI0(double x)
+{
+    double sum{1.0}, term{1.0};
+    auto q = x * x * 0.25;
+    for (int k = 1; k < 64; ++k)
+    {
+        term *= q / (k * k);
+        sum += term;
+        if (term < sum * 1e-17)
+            break;
+    }
+    return sum;
+}
+
+/*
+ * Kaiser windowed sinc at L times the engine rate. pass and stop are fractions of the host
+ * rate and stopDb is the stopband attenuation; the length comes from the Kaiser estimate
+ * N = (A - 7.95) / (2.285 * 2 pi df), rounded up to a multiple of 8 taps per phase.
+ */
+PolyphaseDecimator::Coefficients design(int L, int M, double pass, double stop, double stopDb)
+{
+    PolyphaseDecimator::Coefficients c;
+    c.L = L;
+    c.M = M;
+
+    // The prototype runs at L times the engine rate, which is M times the host rate
+    auto df = (stop - pass) / M;
+    auto fc = 0.5 * (pass + stop) / M;
+    auto n = (stopDb - 7.95) / (2.285 * 2.0 * M_PI * df);
+    c.taps = ((int)std::ceil(n / L) + 7) & ~7;
+    auto np = c.taps * L;
+
+    auto beta = 0.1102 * (stopDb - 8.7);
+    auto i0b = besselI0(beta);
+    auto centre = 0.5 * (np - 1);
+
+    std::vector<double> proto(np);
+    for (int j = 0; j < np; ++j)
+    {
+        auto t = j - centre;
+        auto x = 2.0 * fc * t;
+        auto sinc = std::fabs(x) < 1e-12 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+        auto r = t / centre;
+        auto w = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / i0b;
+        proto[j] = 2.0 * fc * sinc * w;
+    }
+
+    // Phase p takes prototype taps p, p + L, ...; the newest input meets tap p, so reverse
+    // each phase to run oldest to newest. Each phase is normalised to unity at DC so the
+    // L phases of a fractional ratio don't ripple against each other.
+    c.h.resize(np);
+    for (int p = 0; p < L; ++p)
+    {
+        double sum{0.0};
+        for (int k = 0; k < c.taps; ++k)
+            sum += proto[p + L * k];
+        for (int k = 0; k < c.taps; ++k)
+            c.h[p * c.taps + (c.taps - 1 - k)] = (float)(proto[p + L * k] / sum);
+    }
+    return c;
+}
+} // namespace
+
+void PolyphaseDecimator::ratioFor(SampleRateStrategy s, int &L, int &M)
+{
+    L = 1;
+    switch (s)
+    {
+    case SR_110120:
+        L = 2;
+        M = 5;
+        break;
+    case SR_132144:
+        M = 3;
+        break;
+    case SR_176192:
+        M = 4;
+        break;
+    case SR_220240:
+        M = 5;
+        break;
+    }
+}
+
+const PolyphaseDecimator::Coefficients &PolyphaseDecimator::coefficientsFor(SampleRateStrategy s,
+                                                                           Tier t)
+{
+    static constexpr int numStrategies{SR_220240 + 1};
+    static const auto table = []()
+    {
+        std::array<std::array<Coefficients, numTiers>, numStrategies> res;
+        for (int i = 0; i < numStrategies; ++i)
+        {
+            int L, M;
+            ratioFor((SampleRateStrategy)i, L, M);
+            res[i][STANDARD] = design(L, M, 0.4535, 0.5465, 100.0);
+            res[i][HQ] = design(L, M, 0.4535, 0.5, 120.0);
+        }
+        return res;
+    }();
+    return table[s][t];
+}
+} // namespace baconpaul::six_sines
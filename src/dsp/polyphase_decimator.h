@@ -0,0 +1,168 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_DSP_POLYPHASE_DECIMATOR_H
+#define BACONPAUL_SIX_SINES_DSP_POLYPHASE_DECIMATOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include <sst/basic-blocks/simd/setup.h>
+
+#include "configuration.h"
+
+/*
+ * A stereo polyphase FIR resampler for the engine's fixed oversampling ratios. Every
+ * SampleRateStrategy runs the engine at an exact L / M of the host rate (2 / 5 for 2.5x,
+ * 1 / 3, 1 / 4 and 1 / 5 for the rest), so rather than a general resampler this keeps a
+ * Kaiser windowed sinc prototype at L times the engine rate, split into L phases, and
+ * each host sample is one SIMD dot product of a phase against the input history.
+ *
+ * Coefficients depend only on the ratio and tier, not the host rate, and are designed
+ * once on first use. The STANDARD tier lets the transition band straddle host nyquist
+ * (pass to 0.4535 fs, which is 20k at 44.1, stop at 0.5465 fs) so any alias folds above
+ * the passband; HQ stops at nyquist. Both hold 100dB or better in the stopband.
+ *
+ * The interface matches the LanczosResampler calls processInternal makes: push engine
+ * rate samples, ask how many more inputs a block of outputs needs, then pull the block.
+ */
+namespace baconpaul::six_sines
+{
+struct PolyphaseDecimator
+{
+    enum Tier
+    {
+        STANDARD,
+        HQ,
+        numTiers
+    };
+
+    struct Coefficients
+    {
+        int L{1}, M{1};
+        int taps{0}; // per phase, a multiple of 8
+        // L phases of taps each, reversed so phase p dots directly against the oldest
+        // to newest input window
+        std::vector<float> h;
+    };
+
+    // The L / M for an oversampling strategy, engine rate to host rate
+    static void ratioFor(SampleRateStrategy s, int &L, int &M);
+    // Designed on first call, so call it off the audio thread first (setSampleRate does)
+    static const Coefficients &coefficientsFor(SampleRateStrategy s, Tier t);
+
+    static constexpr int bufferSize{2048};
+    static constexpr int bufferMask{bufferSize - 1};
+    // The input history, written twice so any window of taps reads contiguously
+    float input alignas(16)[2][2 * bufferSize];
+    int wp{0};
+    int avail{0}; // inputs pushed at or beyond the next output's newest input
+    int phase{0}; // of the next output, in [0, L)
+    const Coefficients *coeffs{nullptr};
+
+    // Clears the history and binds a ratio / tier. No allocation, so audio thread safe.
+    void reset(const Coefficients &c)
+    {
+        coeffs = &c;
+        memset(input, 0, sizeof(input));
+        wp = 0;
+        avail = 0;
+        phase = 0;
+    }
+
+    // Clears the history and binds another tier of the same ratio, keeping the read
+    // position so the host / engine clock runs on undisturbed
+    void retier(const Coefficients &c)
+    {
+        assert(coeffs && c.L == coeffs->L && c.M == coeffs->M);
+        coeffs = &c;
+        memset(input, 0, sizeof(input));
+    }
+
+    // Clears the history and takes o's ratio and read position, so this runs in step
+    // with o as if it had been pushed silence all along
+    void syncClockTo(const PolyphaseDecimator &o)
+    {
+        reset(*o.coeffs);
+        wp = o.wp;
+        avail = o.avail;
+        phase = o.phase;
+    }
+
+    void push(float L, float R)
+    {
+        input[0][wp] = L;
+        input[0][wp + bufferSize] = L;
+        input[1][wp] = R;
+        input[1][wp + bufferSize] = R;
+        wp = (wp + 1) & bufferMask;
+        avail++;
+    }
+
+    void pushBlock(const float *L, const float *R)
+    {
+        for (int i = 0; i < blockSize; ++i)
+            push(L[i], R[i]);
+    }
+
+    int inputsRequiredToGenerateOutputs(int n) const
+    {
+        // output n - 1 reads the input (phase + (n - 1) M) / L past the next one
+        auto need = (phase + (n - 1) * coeffs->M) / coeffs->L + 1;
+        return std::max(0, need - avail);
+    }
+
+    void populateNextBlockSize(float *L, float *R)
+    {
+        auto &c = *coeffs;
+        for (int n = 0; n < blockSize; ++n)
+        {
+            auto start = (wp - avail - c.taps + 1) & bufferMask;
+            auto *xl = &input[0][start];
+            auto *xr = &input[1][start];
+            auto *h = &c.h[phase * c.taps];
+
+            // Two accumulators a channel so the adds don't serialise on one register
+            auto al0 = SIMD_MM(setzero_ps)(), al1 = SIMD_MM(setzero_ps)();
+            auto ar0 = SIMD_MM(setzero_ps)(), ar1 = SIMD_MM(setzero_ps)();
+            for (int k = 0; k < c.taps; k += 8)
+            {
+                auto h0 = SIMD_MM(loadu_ps)(h + k);
+                auto h1 = SIMD_MM(loadu_ps)(h + k + 4);
+                al0 = SIMD_MM(add_ps)(al0, SIMD_MM(mul_ps)(h0, SIMD_MM(loadu_ps)(xl + k)));
+                al1 = SIMD_MM(add_ps)(al1, SIMD_MM(mul_ps)(h1, SIMD_MM(loadu_ps)(xl + k + 4)));
+                ar0 = SIMD_MM(add_ps)(ar0, SIMD_MM(mul_ps)(h0, SIMD_MM(loadu_ps)(xr + k)));
+                ar1 = SIMD_MM(add_ps)(ar1, SIMD_MM(mul_ps)(h1, SIMD_MM(loadu_ps)(xr + k + 4)));
+            }
+            auto al = SIMD_MM(add_ps)(al0, al1);
+            auto ar = SIMD_MM(add_ps)(ar0, ar1);
+            // one hadd pair sums both channels: lanes are (l01, l23, r01, r23) then (l, r, ..)
+            auto s = SIMD_MM(hadd_ps)(al, ar);
+            s = SIMD_MM(hadd_ps)(s, s);
+            float res alignas(16)[4];
+            SIMD_MM(store_ps)(res, s);
+            L[n] = res[0];
+            R[n] = res[1];
+
+            phase += c.M;
+            avail -= phase / c.L;
+            phase = phase % c.L;
+        }
+    }
+};
+} // namespace baconpaul::six_sines
+#endif // POLYPHASE_DECIMATOR_H
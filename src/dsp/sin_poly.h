@@ -0,0 +1,91 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_DSP_SIN_POLY_H
+#define BACONPAUL_SIX_SINES_DSP_SIN_POLY_H
+
+#include <cstdint>
+
+#include <sst/basic-blocks/simd/setup.h>
+
+/*
+ * Four lane sin and cos of the 26-bit engine phase from minimax polynomials, with
+ * no table reads. This is the core of the SinTable POLY backend.
+ *
+ * The phase maps to x in cycles the same way the quadrant tables do: the top two
+ * bits pick the quadrant and the low 24 bits walk 4096 / 4095 of a quarter turn
+ * (the table puts its last point of each quadrant at the start of the next), so the
+ * two backends agree to within float rounding wherever the waveform is smooth.
+ *
+ * The reduction splits each quadrant at its midpoint into a quarter turn index n
+ * and an angle in [-pi/4, pi/4], where the cephes sinf / cosf minimax polynomials
+ * are good to about an ulp. n then rotates (sin, cos) into place.
+ */
+namespace baconpaul::six_sines::sin_poly
+{
+struct Lanes
+{
+    SIMD_M128 s, c;       // sin(2 pi x), cos(2 pi x)
+    SIMD_M128I quadrant;  // 0..3, the top two phase bits
+    SIMD_M128 upperHalf;  // all ones where the phase is in the second half of its quadrant
+};
+
+inline SIMD_M128 select(SIMD_M128 mask, SIMD_M128 a, SIMD_M128 b)
+{
+    return SIMD_MM(or_ps)(SIMD_MM(and_ps)(mask, a), SIMD_MM(andnot_ps)(mask, b));
+}
+
+inline Lanes sinCos(SIMD_M128I ph)
+{
+    static constexpr float quarterPerCount{1.f / (4096.f * 4095.f)};
+    static constexpr float halfPi{1.57079632679489661923f};
+
+    Lanes r;
+    r.quadrant = SIMD_MM(and_si128)(SIMD_MM(srli_epi32)(ph, 24), SIMD_MM(set1_epi32)(3));
+    auto u = SIMD_MM(cvtepi32_ps)(SIMD_MM(and_si128)(ph, SIMD_MM(set1_epi32)(0xFFFFFF)));
+    auto y = SIMD_MM(mul_ps)(u, SIMD_MM(set1_ps)(quarterPerCount));
+    r.upperHalf = SIMD_MM(cmpge_ps)(y, SIMD_MM(set1_ps)(0.5f));
+    auto f = SIMD_MM(sub_ps)(y, SIMD_MM(and_ps)(r.upperHalf, SIMD_MM(set1_ps)(1.f)));
+    auto t = SIMD_MM(mul_ps)(f, SIMD_MM(set1_ps)(halfPi));
+    auto z = SIMD_MM(mul_ps)(t, t);
+
+    auto sp = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(-1.9515295891e-4f), z),
+                              SIMD_MM(set1_ps)(8.3321608736e-3f));
+    sp = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(sp, z), SIMD_MM(set1_ps)(-1.6666654611e-1f));
+    auto st = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(sp, z), t), t);
+
+    auto cp = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(2.443315711809948e-5f), z),
+                              SIMD_MM(set1_ps)(-1.388731625493765e-3f));
+    cp = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(cp, z), SIMD_MM(set1_ps)(4.166664568298827e-2f));
+    auto ct = SIMD_MM(add_ps)(
+        SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(SIMD_MM(mul_ps)(cp, z), z),
+                        SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(0.5f), z)),
+        SIMD_MM(set1_ps)(1.f));
+
+    // Quarter turns n = quadrant + upperHalf. Odd n swaps sin and cos, then sin
+    // flips sign for n in {2, 3} and cos for n in {1, 2}.
+    auto n = SIMD_MM(sub_epi32)(r.quadrant, SIMD_MM(castps_si128)(r.upperHalf));
+    auto one = SIMD_MM(set1_epi32)(1);
+    auto two = SIMD_MM(set1_epi32)(2);
+    auto swap = SIMD_MM(castsi128_ps)(
+        SIMD_MM(cmpeq_epi32)(SIMD_MM(and_si128)(n, one), one));
+    auto sFlip = SIMD_MM(slli_epi32)(SIMD_MM(and_si128)(n, two), 30);
+    auto cFlip = SIMD_MM(slli_epi32)(SIMD_MM(and_si128)(SIMD_MM(add_epi32)(n, one), two), 30);
+    r.s = SIMD_MM(xor_ps)(select(swap, ct, st), SIMD_MM(castsi128_ps)(sFlip));
+    r.c = SIMD_MM(xor_ps)(select(swap, st, ct), SIMD_MM(castsi128_ps)(cFlip));
+    return r;
+}
+} // namespace baconpaul::six_sines::sin_poly
+#endif // SIN_POLY_H
@@ -15,6 +15,8 @@
 
 #include "sintable.h"
 
+#include <mutex>
+
 namespace baconpaul::six_sines
 {
 double SinTable::xTable[nQuadrants][nPoints + 1];
@@ -28,7 +30,177 @@ SIMD_M128 SinTable::simdFullQuad alignas(
     16)[NUM_WAVEFORMS][nQuadrants * nPoints];       // for each quad it is q, q+1, dq + 1
 SIMD_M128 SinTable::simdCubic alignas(16)[nPoints]; // it is cq, cq+1, cdq, cd1+1
 
-bool SinTable::staticsInitialized{false};
+std::atomic<bool> SinTable::staticsInitialized{false};
+std::atomic<bool> SinTable::waveFormReady[NUM_WAVEFORMS]{};
+
+namespace
+{
+// Guards table building; never taken on the audio thread
+std::mutex buildMutex;
+
+/*
+ * The POLY backend waveforms. Each is the closed form of its fillTable lambda below,
+ * written in terms of s = sin(2 pi x) and c = cos(2 pi x) (and their double angles),
+ * with the quadrant and half quadrant taken from the phase bits so the piecewise
+ * selection lands where the table's does.
+ */
+template <int WF> SIMD_M128 polyWave(SIMD_M128I ph)
+{
+    using sin_poly::select;
+    auto l = sin_poly::sinCos(ph);
+    const auto one = SIMD_MM(set1_ps)(1.f);
+    const auto two = SIMD_MM(set1_ps)(2.f);
+    const auto signBit = SIMD_MM(set1_ps)(-0.f);
+    auto q0 = SIMD_MM(castsi128_ps)(SIMD_MM(cmpeq_epi32)(l.quadrant, SIMD_MM(setzero_si128)()));
+    auto q1 = SIMD_MM(castsi128_ps)(SIMD_MM(cmpeq_epi32)(l.quadrant, SIMD_MM(set1_epi32)(1)));
+    auto q01 = SIMD_MM(or_ps)(q0, q1);
+
+    // sin and cos of 4 pi x
+    auto s2 = SIMD_MM(mul_ps)(two, SIMD_MM(mul_ps)(l.s, l.c));
+    auto c2 = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(l.c, l.c), SIMD_MM(mul_ps)(l.s, l.s));
+
+    if constexpr (WF == SinTable::SIN)
+    {
+        return l.s;
+    }
+    else if constexpr (WF == SinTable::TX2)
+    {
+        // 0.5 (sin(4 pi (x - 1/8)) + 1) = s^2, negated in the back half
+        auto ss = SIMD_MM(mul_ps)(l.s, l.s);
+        return select(q01, ss, SIMD_MM(xor_ps)(ss, signBit));
+    }
+    else if constexpr (WF == SinTable::TX3)
+    {
+        return SIMD_MM(and_ps)(q01, l.s);
+    }
+    else if constexpr (WF == SinTable::TX4)
+    {
+        return SIMD_MM(and_ps)(q01, SIMD_MM(mul_ps)(l.s, l.s));
+    }
+    else if constexpr (WF == SinTable::TX5)
+    {
+        return SIMD_MM(and_ps)(q01, s2);
+    }
+    else if constexpr (WF == SinTable::TX6)
+    {
+        auto ss = SIMD_MM(mul_ps)(s2, s2);
+        return SIMD_MM(or_ps)(SIMD_MM(and_ps)(q0, ss),
+                              SIMD_MM(and_ps)(q1, SIMD_MM(xor_ps)(ss, signBit)));
+    }
+    else if constexpr (WF == SinTable::TX7)
+    {
+        return SIMD_MM(or_ps)(SIMD_MM(and_ps)(q0, s2),
+                              SIMD_MM(and_ps)(q1, SIMD_MM(xor_ps)(s2, signBit)));
+    }
+    else if constexpr (WF == SinTable::TX8)
+    {
+        return SIMD_MM(and_ps)(q01, SIMD_MM(mul_ps)(s2, s2));
+    }
+    else if constexpr (WF == SinTable::SPIKY_TX2 || WF == SinTable::SPIKY_TX4)
+    {
+        // 1 - c, 1 + c, -1 - c, c - 1 by quadrant; TX4 is silent in the back half
+        auto q3 = SIMD_MM(castsi128_ps)(SIMD_MM(cmpeq_epi32)(l.quadrant, SIMD_MM(set1_epi32)(3)));
+        auto v = select(SIMD_MM(or_ps)(q0, q3), SIMD_MM(sub_ps)(one, l.c),
+                        SIMD_MM(add_ps)(one, l.c));
+        if constexpr (WF == SinTable::SPIKY_TX4)
+            return SIMD_MM(and_ps)(q01, v);
+        else
+            return select(q01, v, SIMD_MM(xor_ps)(v, signBit));
+    }
+    else if constexpr (WF == SinTable::SPIKY_TX6 || WF == SinTable::SPIKY_TX8)
+    {
+        // The same spikes on cos(4 pi x), switching at each half quadrant
+        auto lo = SIMD_MM(sub_ps)(one, c2);
+        auto hi = SIMD_MM(add_ps)(one, c2);
+        auto v0 = select(l.upperHalf, hi, lo);
+        auto v1 = select(l.upperHalf, lo, hi);
+        if constexpr (WF == SinTable::SPIKY_TX6)
+            v1 = SIMD_MM(xor_ps)(v1, signBit);
+        return SIMD_MM(or_ps)(SIMD_MM(and_ps)(q0, v0), SIMD_MM(and_ps)(q1, v1));
+    }
+    else
+    {
+        return SIMD_MM(setzero_ps)();
+    }
+}
+
+template <int WF> void polyWaveBlock(const uint32_t *ph, float *out, int n)
+{
+    for (int i = 0; i < n; i += 4)
+        SIMD_MM(storeu_ps)(out + i,
+                           polyWave<WF>(SIMD_MM(loadu_si128)((const SIMD_M128I *)(ph + i))));
+}
+} // namespace
+
+SinTable::polyLanes_t SinTable::polyLanesFor(WaveForm wf)
+{
+    switch (wf)
+    {
+    case SIN:
+        return polyWave<SIN>;
+    case TX2:
+        return polyWave<TX2>;
+    case TX3:
+        return polyWave<TX3>;
+    case TX4:
+        return polyWave<TX4>;
+    case TX5:
+        return polyWave<TX5>;
+    case TX6:
+        return polyWave<TX6>;
+    case TX7:
+        return polyWave<TX7>;
+    case TX8:
+        return polyWave<TX8>;
+    case SPIKY_TX2:
+        return polyWave<SPIKY_TX2>;
+    case SPIKY_TX4:
+        return polyWave<SPIKY_TX4>;
+    case SPIKY_TX6:
+        return polyWave<SPIKY_TX6>;
+    case SPIKY_TX8:
+        return polyWave<SPIKY_TX8>;
+    default:
+        break;
+    }
+    return nullptr;
+}
+
+SinTable::polyBlock_t SinTable::polyBlockFor(WaveForm wf)
+{
+    switch (wf)
+    {
+    case SIN:
+        return polyWaveBlock<SIN>;
+    case TX2:
+        return polyWaveBlock<TX2>;
+    case TX3:
+        return polyWaveBlock<TX3>;
+    case TX4:
+        return polyWaveBlock<TX4>;
+    case TX5:
+        return polyWaveBlock<TX5>;
+    case TX6:
+        return polyWaveBlock<TX6>;
+    case TX7:
+        return polyWaveBlock<TX7>;
+    case TX8:
+        return polyWaveBlock<TX8>;
+    case SPIKY_TX2:
+        return polyWaveBlock<SPIKY_TX2>;
+    case SPIKY_TX4:
+        return polyWaveBlock<SPIKY_TX4>;
+    case SPIKY_TX6:
+        return polyWaveBlock<SPIKY_TX6>;
+    case SPIKY_TX8:
+        return polyWaveBlock<SPIKY_TX8>;
+    default:
+        break;
+    }
+    return nullptr;
+}
+
+bool SinTable::hasPolyBackend(WaveForm wf) { return polyLanesFor(wf) != nullptr; }
 
 void SinTable::fillTable(int WF, std::function<std::pair<double, double>(double x, int Q)> der)
 {
@@ -44,29 +216,22 @@ void SinTable::fillTable(int WF, std::function<std::pair<double, double>(double
     }
 }
 
-void SinTable::initializeStatics()
+void SinTable::buildWaveForm(int WF)
 {
-    if (staticsInitialized)
-        return;
-
-    memset(quadrantTable, 0, sizeof(quadrantTable));
-    memset(dQuadrantTable, 0, sizeof(dQuadrantTable));
-
-    for (int i = 0; i < nPoints + 1; ++i)
+    // Each waveform below is one fillAsked call; only the one asked for runs
+    auto fillAsked = [WF](int which, auto &&der)
     {
-        for (int Q = 0; Q < nQuadrants; ++Q)
-        {
-            xTable[Q][i] = (1.0 * i / (nPoints - 1) + Q) * 0.25;
-        }
-    }
+        if (which == WF)
+            fillTable(which, der);
+    };
 
     static constexpr double twoPi{2.0 * M_PI};
     // Waveform 0: sin(2pix);
-    fillTable(WaveForm::SIN, [](double x, int Q)
+    fillAsked(WaveForm::SIN, [](double x, int Q)
               { return std::make_pair(sin(twoPi * x), twoPi * cos(twoPi * x)); });
 
     // Waveform 1: sin(2pix)^4. Deriv is 5 2pix sin(2pix)^4 cos(2pix)
-    fillTable(WaveForm::SIN_FIFTH,
+    fillAsked(WaveForm::SIN_FIFTH,
               [](double x, int Q)
               {
                   auto s = sin(twoPi * x);
@@ -77,7 +242,7 @@ void SinTable::initializeStatics()
               });
 
     // Waveform 2: Square-ish with sin 8 transitions
-    fillTable(WaveForm::SQUARISH,
+    fillAsked(WaveForm::SQUARISH,
               [](double x, int Q)
               {
                   static constexpr double winFreq{8.0};
@@ -120,7 +285,7 @@ void SinTable::initializeStatics()
     auto osp = 1.0 / (twoPiS);
     auto co = osp * acos(-2 * osp) / (twoPi /* rad->0.1 units */);
 
-    fillTable(WaveForm::SAWISH,
+    fillAsked(WaveForm::SAWISH,
               [co](double x, int Q)
               {
                   auto a = 1.0 - 2 * x;
@@ -144,7 +309,7 @@ void SinTable::initializeStatics()
                   return std::make_pair(-v, -dv);
               });
 
-    fillTable(WaveForm::TRIANGLE,
+    fillAsked(WaveForm::TRIANGLE,
               [](double x, int Q)
               {
                   if (Q == 0)
@@ -161,7 +326,7 @@ void SinTable::initializeStatics()
                   }
                   return std::make_pair(0.0, 0.0);
               });
-    fillTable(WaveForm::SIN_OF_CUBED,
+    fillAsked(WaveForm::SIN_OF_CUBED,
               [](double x, int Q)
               {
                   auto z = x * 2 - 1;
@@ -174,7 +339,7 @@ void SinTable::initializeStatics()
                   return std::make_pair(v, dv);
               });
 
-    fillTable(SinTable::TX2,
+    fillAsked(SinTable::TX2,
               [](double x, int Q) -> std::pair<double, double>
               {
                   auto v = 0.0;
@@ -192,7 +357,7 @@ void SinTable::initializeStatics()
                   return {v, dv};
               });
 
-    fillTable(SinTable::WaveForm::SPIKY_TX2,
+    fillAsked(SinTable::WaveForm::SPIKY_TX2,
               [](double x, int Q)
               {
                   double v, dv;
@@ -222,7 +387,7 @@ void SinTable::initializeStatics()
                   return std::make_pair(v, dv);
               });
 
-    fillTable(SinTable::WaveForm::TX3,
+    fillAsked(SinTable::WaveForm::TX3,
               [](double x, int Q)
               {
                   double v, dv;
@@ -246,7 +411,7 @@ void SinTable::initializeStatics()
                   return std::make_pair(v, dv);
               });
 
-    fillTable(SinTable::TX4,
+    fillAsked(SinTable::TX4,
               [](double x, int Q) -> std::pair<double, double>
               {
                   auto v = 0.0;
@@ -260,7 +425,7 @@ void SinTable::initializeStatics()
                   return {v, dv};
               });
 
-    fillTable(SinTable::WaveForm::SPIKY_TX4,
+    fillAsked(SinTable::WaveForm::SPIKY_TX4,
               [](double x, int Q)
               {
                   double v, dv;
@@ -287,7 +452,7 @@ void SinTable::initializeStatics()
                   return std::make_pair(v, dv);
               });
 
-    fillTable(SinTable::WaveForm::TX5,
+    fillAsked(SinTable::WaveForm::TX5,
               [](double x, int Q)
               {
                   double v, dv;
@@ -311,7 +476,7 @@ void SinTable::initializeStatics()
                   return std::make_pair(v, dv);
               });
 
-    fillTable(SinTable::WaveForm::TX6,
+    fillAsked(SinTable::WaveForm::TX6,
               [](double x, int Q) -> std::pair<double, double>
               {
                   auto v = 0.0;
@@ -328,7 +493,7 @@ void SinTable::initializeStatics()
                   }
                   return {v, dv};
               });
-    fillTable(SinTable::WaveForm::SPIKY_TX6,
+    fillAsked(SinTable::WaveForm::SPIKY_TX6,
               [](double x, int Q)
               {
                   double v{0}, dv{0};
@@ -366,7 +531,7 @@ void SinTable::initializeStatics()
                   return std::make_pair(v, dv);
               });
 
-    fillTable(SinTable::WaveForm::TX7,
+    fillAsked(SinTable::WaveForm::TX7,
               [](double x, int Q)
               {
                   double v, dv;
@@ -393,7 +558,7 @@ void SinTable::initializeStatics()
                   return std::make_pair(v, dv);
               });
 
-    fillTable(SinTable::WaveForm::TX8,
+    fillAsked(SinTable::WaveForm::TX8,
               [](double x, int Q) -> std::pair<double, double>
               {
                   auto v = 0.0;
@@ -406,7 +571,7 @@ void SinTable::initializeStatics()
 
                   return {v, dv};
               });
-    fillTable(SinTable::WaveForm::SPIKY_TX8,
+    fillAsked(SinTable::WaveForm::SPIKY_TX8,
               [](double x, int Q)
               {
                   double v{0}, dv{0};
@@ -446,7 +611,7 @@ void SinTable::initializeStatics()
 
     // Thanks to https://en.wikipedia.org/wiki/Window_function for these
     // HANN: 0.5 * (1-cos 2pix). Derivative is pi sin 2pix
-    fillTable(SinTable::WaveForm::HANN_WINDOW,
+    fillAsked(SinTable::WaveForm::HANN_WINDOW,
               [](double x, int Q)
               {
                   auto v = 0.5 * (1.0 - cos(2.0 * M_PI * x));
@@ -464,9 +629,9 @@ void SinTable::initializeStatics()
         ;
         return std::make_pair(v, dv);
     };
-    fillTable(SinTable::WaveForm::BLACKMAN_HARRIS_WINDOW, [cosSum](double x, int Q)
+    fillAsked(SinTable::WaveForm::BLACKMAN_HARRIS_WINDOW, [cosSum](double x, int Q)
               { return cosSum(x, 0.35875, 0.48829, 0.14128, 0.01168, 0.00196); });
-    fillTable(SinTable::WaveForm::HALF_BLACKMAN_HARRIS_WINDOW,
+    fillAsked(SinTable::WaveForm::HALF_BLACKMAN_HARRIS_WINDOW,
               [cosSum](double x, int Q)
               {
                   if (Q == 2 || Q == 3)
@@ -478,7 +643,7 @@ void SinTable::initializeStatics()
               });
 
     // Tukey with alpha 0.15
-    fillTable(SinTable::WaveForm::TUKEY_WINDOW,
+    fillAsked(SinTable::WaveForm::TUKEY_WINDOW,
               [](double x, int Q)
               {
                   static constexpr float alpha{0.15};
@@ -502,6 +667,58 @@ void SinTable::initializeStatics()
                   return std::make_pair(v, dSign * dv);
               });
 
+    for (int i = 0; i < nPoints; ++i)
+    {
+        for (int Q = 0; Q < 4; ++Q)
+        {
+            float r alignas(16)[4];
+            r[0] = quadrantTable[WF][Q][i];
+            r[1] = dQuadrantTable[WF][Q][i];
+            r[2] = quadrantTable[WF][Q][i + 1];
+            r[3] = dQuadrantTable[WF][Q][i + 1];
+            simdFullQuad[WF][nPoints * Q + i] = SIMD_MM(load_ps)(r);
+        }
+    }
+}
+
+void SinTable::prepareWaveForm(WaveForm wf)
+{
+    if (wf >= NUM_WAVEFORMS)
+        return;
+    initializeStatics();
+    if (waveFormReady[wf].load(std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> g(buildMutex);
+    if (waveFormReady[wf].load(std::memory_order_relaxed))
+        return;
+    buildWaveForm(wf);
+    waveFormReady[wf].store(true, std::memory_order_release);
+}
+
+void SinTable::prepareAllWaveForms()
+{
+    for (int wf = 0; wf < (int)NUM_WAVEFORMS; ++wf)
+        prepareWaveForm((WaveForm)wf);
+}
+
+void SinTable::initializeStatics()
+{
+    if (staticsInitialized.load(std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> g(buildMutex);
+    if (staticsInitialized.load(std::memory_order_relaxed))
+        return;
+
+    for (int i = 0; i < nPoints + 1; ++i)
+    {
+        for (int Q = 0; Q < nQuadrants; ++Q)
+        {
+            xTable[Q][i] = (1.0 * i / (nPoints - 1) + Q) * 0.25;
+        }
+    }
+
     // Fill up interp buffers
     for (int i = 0; i < nPoints; ++i)
     {
@@ -521,32 +738,24 @@ void SinTable::initializeStatics()
         linterpCoefficients[1][i] = t;
     }
 
-    // Load the SIMD buffers
     for (int i = 0; i < nPoints; ++i)
     {
-        for (int WF = 0; WF < NUM_WAVEFORMS; ++WF)
+        float r alignas(16)[4];
+        for (int j = 0; j < 4; ++j)
         {
-            for (int Q = 0; Q < 4; ++Q)
-            {
-                float r alignas(16)[4];
-                r[0] = quadrantTable[WF][Q][i];
-                r[1] = dQuadrantTable[WF][Q][i];
-                r[2] = quadrantTable[WF][Q][i + 1];
-                r[3] = dQuadrantTable[WF][Q][i + 1];
-                simdFullQuad[WF][nPoints * Q + i] = SIMD_MM(load_ps)(r);
-            }
+            r[j] = cubicHermiteCoefficients[j][i];
         }
+        simdCubic[i] = SIMD_MM(load_ps)(r);
+    }
 
-        {
-            float r alignas(16)[4];
-            for (int j = 0; j < 4; ++j)
-            {
-                r[j] = cubicHermiteCoefficients[j][i];
-            }
-            simdCubic[i] = SIMD_MM(load_ps)(r);
-        }
+    // AUDIO_IN has no table; its zero rows are never read
+    for (auto wf : {SIN, HANN_WINDOW})
+    {
+        buildWaveForm(wf);
+        waveFormReady[wf].store(true, std::memory_order_release);
     }
-    staticsInitialized = true;
+    waveFormReady[AUDIO_IN].store(true, std::memory_order_release);
+    staticsInitialized.store(true, std::memory_order_release);
 }
 
 } // namespace baconpaul::six_sines
\ No newline at end of file
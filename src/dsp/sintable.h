@@ -16,6 +16,7 @@
 #ifndef BACONPAUL_SIX_SINES_DSP_SINTABLE_H
 #define BACONPAUL_SIX_SINES_DSP_SINTABLE_H
 
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <functional>
@@ -23,6 +24,7 @@
 
 #include "configuration.h"
 #include <sst/basic-blocks/simd/setup.h>
+#include "dsp/sin_poly.h"
 
 namespace baconpaul::six_sines
 {
@@ -94,10 +96,58 @@ struct SinTable
     static SIMD_M128 simdFullQuad alignas(
         16)[NUM_WAVEFORMS][nQuadrants * nPoints];    // for each quad it is q, q+1, dq + 1
     static SIMD_M128 simdCubic alignas(16)[nPoints]; // it is cq, cq+1, cdq, cd1+1
-    static bool staticsInitialized;
+    static std::atomic<bool> staticsInitialized;
+
+    /*
+     * Waveform tables are built lazily. initializeStatics only builds the shared
+     * interpolation coefficients plus SIN and HANN_WINDOW, which every operator
+     * selects on reset, so loading an instance stays cheap.
+     *
+     * prepareWaveForm builds and publishes a waveform (release, paired with the
+     * acquire in setWaveForm). It takes a lock and does real work, so it runs on the
+     * main thread. Activate calls prepareAllWaveForms, which is about 20ms the first
+     * time in a process and nothing after, so host automation of a waveform, or a
+     * window shape, finds its table built. setWaveForm never plays a stand in shape: an
+     * engine which starts notes without activating (tests, tools) and hasn't prepared
+     * the patch's waveforms builds the missing table where it stands.
+     */
+    static std::atomic<bool> waveFormReady[NUM_WAVEFORMS];
+
+    static void prepareWaveForm(WaveForm wf);
+    static void prepareAllWaveForms();
+    static bool isWaveFormReady(WaveForm wf)
+    {
+        return wf < NUM_WAVEFORMS && waveFormReady[wf].load(std::memory_order_acquire);
+    }
 
     SIMD_M128 *simdQuad;
 
+    /*
+     * Evaluation backends. TABLE is the hermite quadrant table lookup. POLY builds
+     * the waveform from sin_poly::sinCos and reads no memory, so it doesn't fight the
+     * rest of the host for cache; it exists for SIN and the piecewise sine TX and
+     * SPIKY_TX shapes. The backend is per table and latched by setWaveForm. at() is
+     * the table lookup alone, so a caller which can be on POLY picks atPoly() for the
+     * whole run (OpSource does it by template instantiation) rather than branching on
+     * every sample.
+     */
+    enum Backend
+    {
+        TABLE,
+        POLY
+    };
+    static bool hasPolyBackend(WaveForm wf);
+
+    // Four phases at a time, and a whole run of phases with the lane kernel inlined
+    using polyLanes_t = SIMD_M128 (*)(SIMD_M128I);
+    using polyBlock_t = void (*)(const uint32_t *, float *, int);
+    static polyLanes_t polyLanesFor(WaveForm wf);
+    static polyBlock_t polyBlockFor(WaveForm wf);
+    // set when this table's waveform evaluates with POLY
+    polyLanes_t polyLanes{nullptr};
+    polyBlock_t polyBlock{nullptr};
+    bool usesPoly() const { return polyLanes != nullptr; }
+
     SinTable()
     {
         initializeStatics();
@@ -106,14 +156,20 @@ struct SinTable
 
     void setSampleRate(double sr) { frToPhase = (1 << 26) / sr; }
     static void fillTable(int WF, std::function<std::pair<double, double>(double x, int Q)> der);
+    static void buildWaveForm(int WF);
     static void initializeStatics();
 
-    void setWaveForm(WaveForm wf)
+    void setWaveForm(WaveForm wf, Backend backend = TABLE)
     {
         auto stwf = size_t(wf);
         if (stwf >= NUM_WAVEFORMS) // mostly remove ine during dev
             stwf = 0;
+        if (!waveFormReady[stwf].load(std::memory_order_acquire))
+            prepareWaveForm((WaveForm)stwf);
         simdQuad = simdFullQuad[stwf];
+        auto poly = backend == POLY;
+        polyLanes = poly ? polyLanesFor((WaveForm)stwf) : nullptr;
+        polyBlock = poly ? polyBlockFor((WaveForm)stwf) : nullptr;
     }
 
     double frToPhase{0};
@@ -140,6 +196,69 @@ struct SinTable
         auto v = SIMD_MM(hadd_ps)(h, h);
         return SIMD_MM(cvtss_f32)(v);
     }
+
+    // at() on the POLY backend; only valid when usesPoly()
+    inline float atPoly(const uint32_t ph) const
+    {
+        assert(polyLanes);
+        return SIMD_MM(cvtss_f32)(polyLanes(SIMD_MM(set1_epi32)((int32_t)ph)));
+    }
+
+    /*
+     * at() for a run of phases, four at a time. Each lane gathers its table row and
+     * hermite coefficients, a 4x4 transpose turns those into one register per term,
+     * and the terms sum as (q0c0 + q1c1) + (q2c2 + q3c3), the same order as the two
+     * hadds in at(), so the result is identical. The POLY backend runs the same lane
+     * kernel atPoly() does. n must be a multiple of 4.
+     */
+    inline void atBlock(const uint32_t *ph, float *out, int n) const
+    {
+        static constexpr uint32_t mask{(1 << 12) - 1};
+        static constexpr uint32_t umask{(1 << 14) - 1};
+        assert(n % 4 == 0);
+
+        if (polyBlock)
+        {
+            polyBlock(ph, out, n);
+            return;
+        }
+
+        const auto lmask = SIMD_MM(set1_epi32)(mask);
+        const auto hmask = SIMD_MM(set1_epi32)(umask);
+        for (int i = 0; i < n; i += 4)
+        {
+            auto p = SIMD_MM(loadu_si128)((const SIMD_M128I *)(ph + i));
+            auto lbv = SIMD_MM(and_si128)(p, lmask);
+            auto ubv = SIMD_MM(and_si128)(SIMD_MM(srli_epi32)(p, 12), hmask);
+            uint32_t lb alignas(16)[4], ub alignas(16)[4];
+            SIMD_MM(store_si128)((SIMD_M128I *)lb, lbv);
+            SIMD_MM(store_si128)((SIMD_M128I *)ub, ubv);
+
+            auto q0 = simdQuad[ub[0]], q1 = simdQuad[ub[1]];
+            auto q2 = simdQuad[ub[2]], q3 = simdQuad[ub[3]];
+            auto c0 = simdCubic[lb[0]], c1 = simdCubic[lb[1]];
+            auto c2 = simdCubic[lb[2]], c3 = simdCubic[lb[3]];
+            transpose4(q0, q1, q2, q3);
+            transpose4(c0, c1, c2, c3);
+
+            auto v = SIMD_MM(add_ps)(
+                SIMD_MM(add_ps)(SIMD_MM(mul_ps)(q0, c0), SIMD_MM(mul_ps)(q1, c1)),
+                SIMD_MM(add_ps)(SIMD_MM(mul_ps)(q2, c2), SIMD_MM(mul_ps)(q3, c3)));
+            SIMD_MM(storeu_ps)(out + i, v);
+        }
+    }
+
+    static inline void transpose4(SIMD_M128 &a, SIMD_M128 &b, SIMD_M128 &c, SIMD_M128 &d)
+    {
+        auto t0 = SIMD_MM(unpacklo_ps)(a, b);
+        auto t1 = SIMD_MM(unpacklo_ps)(c, d);
+        auto t2 = SIMD_MM(unpackhi_ps)(a, b);
+        auto t3 = SIMD_MM(unpackhi_ps)(c, d);
+        a = SIMD_MM(movelh_ps)(t0, t1);
+        b = SIMD_MM(movehl_ps)(t1, t0);
+        c = SIMD_MM(movelh_ps)(t2, t3);
+        d = SIMD_MM(movehl_ps)(t3, t2);
+    }
 };
 } // namespace baconpaul::six_sines
 #endif // SINTABLE_H
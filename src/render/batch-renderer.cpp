@@ -0,0 +1,413 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "batch-renderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <cmrc/cmrc.hpp>
+
+#include "infra/RIFFWavWriter.h"
+
+CMRC_DECLARE(sixsines_patches);
+
+namespace baconpaul::six_sines::render
+{
+namespace
+{
+// In place radix 2 FFT; the size is a power of two
+void fft(std::vector<std::complex<double>> &a)
+{
+    auto n = a.size();
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+        auto bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(a[i], a[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        auto ang = -2.0 * M_PI / len;
+        std::complex<double> wl(std::cos(ang), std::sin(ang));
+        for (size_t i = 0; i < n; i += len)
+        {
+            std::complex<double> w(1.0);
+            for (size_t k = 0; k < len / 2; ++k)
+            {
+                auto u = a[i + k];
+                auto v = a[i + k + len / 2] * w;
+                a[i + k] = u + v;
+                a[i + k + len / 2] = u - v;
+                w *= wl;
+            }
+        }
+    }
+}
+
+double toDb(double x) { return 20.0 * std::log10(std::max(x, 1e-10)); }
+
+void pushStereo(RIFFWavWriter &wav, const float *L, const float *R, int n)
+{
+    float inter[2 * blockSize];
+    for (int i = 0; i < n; ++i)
+    {
+        inter[2 * i] = L[i];
+        inter[2 * i + 1] = R[i];
+    }
+    wav.pushInterleavedBlock(inter, 2 * n);
+}
+} // namespace
+
+FingerprintBuilder::FingerprintBuilder(double sr)
+    : sampleRate(sr), frame(analysisSize, 0.f), power(analysisSize / 2 + 1, 0.0)
+{
+    print.hash = 0xcbf29ce484222325ull;
+}
+
+void FingerprintBuilder::add(const float *L, const float *R, int n)
+{
+    for (auto *ch : {L, R})
+    {
+        auto *bytes = reinterpret_cast<const uint8_t *>(ch);
+        for (size_t i = 0; i < n * sizeof(float); ++i)
+        {
+            print.hash ^= bytes[i];
+            print.hash *= 0x100000001b3ull;
+        }
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        sumSquares += (double)L[i] * L[i] + (double)R[i] * R[i];
+        print.peak = std::max({print.peak, std::fabs(L[i]), std::fabs(R[i])});
+        frame[fill++] = 0.5f * (L[i] + R[i]);
+        if (fill == analysisSize)
+            analyseFrame();
+    }
+    print.frames += n;
+}
+
+void FingerprintBuilder::analyseFrame()
+{
+    std::vector<std::complex<double>> bins(analysisSize);
+    for (int i = 0; i < analysisSize; ++i)
+    {
+        auto hann = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / analysisSize);
+        bins[i] = i < fill ? frame[i] * hann : 0.0;
+    }
+    fft(bins);
+    for (size_t k = 0; k < power.size(); ++k)
+        power[k] += std::norm(bins[k]);
+    fill = 0;
+}
+
+Fingerprint FingerprintBuilder::finish()
+{
+    if (fill > 0)
+        analyseFrame();
+
+    double num{0}, den{0};
+    for (size_t k = 0; k < power.size(); ++k)
+    {
+        num += k * sampleRate / analysisSize * power[k];
+        den += power[k];
+    }
+    print.centroidHz = den > 0 ? (float)(num / den) : 0.f;
+    print.rms = print.frames > 0 ? (float)std::sqrt(sumSquares / (2.0 * print.frames)) : 0.f;
+    return print;
+}
+
+const char *batchScoreNotes = "note 0.00 0.60 36 40\n"
+                              "note 0.75 0.60 48 100\n"
+                              "note 1.50 0.60 60 127\n"
+                              "note 2.25 0.60 72 64\n"
+                              "note 3.00 0.60 84 100\n"
+                              "note 3.75 1.50 60 90\n"
+                              "note 3.75 1.50 64 90\n"
+                              "note 3.75 1.50 67 90\n";
+
+std::vector<BatchJob> factoryPatchJobs()
+{
+    // Matches PresetManager::factoryPath, which lives with the UI
+    static constexpr const char *factoryPath{"resources/factory_patches"};
+    static constexpr const char *extension{".sxsnp"};
+
+    auto fs = cmrc::sixsines_patches::get_filesystem();
+    std::vector<std::string> categories;
+    for (const auto &cat : fs.iterate_directory(factoryPath))
+        if (cat.is_directory())
+            categories.push_back(cat.filename());
+    std::sort(categories.begin(), categories.end());
+
+    std::vector<BatchJob> res;
+    for (const auto &cat : categories)
+    {
+        auto catPath = std::string(factoryPath) + "/" + cat;
+        std::vector<std::string> patches;
+        for (const auto &p : fs.iterate_directory(catPath))
+            if (p.is_file())
+                patches.push_back(p.filename());
+        std::sort(patches.begin(), patches.end());
+
+        for (const auto &p : patches)
+        {
+            auto file = fs.open(catPath + "/" + p);
+            auto name = p;
+            if (name.size() > strlen(extension) &&
+                name.compare(name.size() - strlen(extension), strlen(extension), extension) == 0)
+                name.resize(name.size() - strlen(extension));
+            res.push_back({cat + "/" + name, std::string(file.begin(), file.end())});
+        }
+    }
+    return res;
+}
+
+std::vector<BatchResult> renderBatch(const std::vector<BatchJob> &jobs, const Score &score,
+                                     const BatchOptions &options, const batchProgress_t &progress)
+{
+    std::vector<BatchResult> results(jobs.size());
+    std::atomic<size_t> nextJob{0};
+    size_t done{0};
+
+    /*
+     * Synth construction and sample rate setup fill shared tables (the resampler's among
+     * them) and register with MTS-ESP, none of which are safe to race, so each worker
+     * holds setupMutex while it builds and while it tears down. Rendering runs unlocked.
+     */
+    std::mutex setupMutex, progressMutex;
+
+    auto renderOne = [&](const BatchJob &job, BatchResult &res)
+    {
+        res.name = job.name;
+
+        std::unique_ptr<Synth> synth;
+        {
+            std::lock_guard<std::mutex> g(setupMutex);
+            synth = std::make_unique<Synth>(false, options.randomSeed);
+            res.ok = prepareSynth(*synth, job.patchData, options.sampleRate, res.error);
+        }
+
+        std::unique_ptr<RIFFWavWriter> wav;
+        if (res.ok && !options.wavDirectory.empty())
+        {
+            auto path = std::filesystem::path(options.wavDirectory) / (job.name + ".wav");
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            wav = std::make_unique<RIFFWavWriter>(path, 2);
+            if (!wav->openFile())
+            {
+                res.ok = false;
+                res.error = wav->errMsg;
+            }
+            else
+            {
+                wav->writeRIFFHeader();
+                wav->writeFMTChunk((int32_t)std::round(options.sampleRate));
+                wav->startDataChunk();
+            }
+        }
+
+        if (res.ok)
+        {
+            FingerprintBuilder fp(options.sampleRate);
+            auto start = std::chrono::steady_clock::now();
+            renderScore(*synth, score, options.render,
+                        [&](const float *L, const float *R, int n)
+                        {
+                            fp.add(L, R, n);
+                            if (wav)
+                                pushStereo(*wav, L, R, n);
+                        });
+            res.renderSeconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            res.print = fp.finish();
+
+            if (wav && !wav->closeFile())
+            {
+                res.ok = false;
+                res.error = "Unable to finish writing the preview";
+            }
+        }
+
+        std::lock_guard<std::mutex> g(setupMutex);
+        synth.reset();
+    };
+
+    auto worker = [&]()
+    {
+        for (auto i = nextJob++; i < jobs.size(); i = nextJob++)
+        {
+            renderOne(jobs[i], results[i]);
+            if (progress)
+            {
+                std::lock_guard<std::mutex> g(progressMutex);
+                progress(++done, jobs.size(), results[i]);
+            }
+        }
+    };
+
+    size_t nThreads = options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+    nThreads = std::clamp(nThreads, (size_t)1, std::max(jobs.size(), (size_t)1));
+
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < nThreads; ++i)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool)
+        t.join();
+
+    return results;
+}
+
+bool writeFingerprints(const std::string &path, const std::vector<BatchResult> &results)
+{
+    std::ofstream f(path);
+    if (!f.is_open())
+        return false;
+
+    // The name goes last so it can hold anything but a newline
+    f << "frames,rms_db,peak_db,centroid_hz,hash,patch\n";
+    for (const auto &r : results)
+    {
+        if (!r.ok)
+            continue;
+        auto &p = r.print;
+        f << p.frames << std::fixed << std::setprecision(4) << "," << toDb(p.rms) << ","
+          << toDb(p.peak) << "," << std::setprecision(2) << p.centroidHz << "," << std::hex
+          << std::setw(16) << std::setfill('0') << p.hash << std::dec << std::setfill(' ') << ","
+          << r.name << "\n";
+    }
+    return f.good();
+}
+
+bool readFingerprints(const std::string &path, std::map<std::string, Fingerprint> &into,
+                      std::string &err)
+{
+    std::ifstream f(path);
+    if (!f.is_open())
+    {
+        err = "Unable to open " + path;
+        return false;
+    }
+
+    std::string line;
+    int lineNo{0};
+    while (std::getline(f, line))
+    {
+        ++lineNo;
+        if (lineNo == 1 || line.empty())
+            continue;
+
+        std::vector<std::string> cols;
+        size_t pos{0};
+        for (int i = 0; i < 5; ++i)
+        {
+            auto c = line.find(',', pos);
+            if (c == std::string::npos)
+                break;
+            cols.push_back(line.substr(pos, c - pos));
+            pos = c + 1;
+        }
+        if (cols.size() != 5 || pos >= line.size())
+        {
+            err = "Line " + std::to_string(lineNo) + ": expected six columns";
+            return false;
+        }
+
+        Fingerprint p;
+        try
+        {
+            p.frames = std::stoll(cols[0]);
+            p.rms = std::pow(10.f, std::stof(cols[1]) / 20.f);
+            p.peak = std::pow(10.f, std::stof(cols[2]) / 20.f);
+            p.centroidHz = std::stof(cols[3]);
+            p.hash = std::stoull(cols[4], nullptr, 16);
+        }
+        catch (const std::exception &)
+        {
+            err = "Line " + std::to_string(lineNo) + ": bad number";
+            return false;
+        }
+        into[line.substr(pos)] = p;
+    }
+    return true;
+}
+
+std::vector<std::string> compareFingerprints(const std::map<std::string, Fingerprint> &baseline,
+                                             const std::vector<BatchResult> &results,
+                                             double sampleRate, const FingerprintTolerance &tol)
+{
+    std::vector<std::string> res;
+    std::map<std::string, bool> seen;
+    for (const auto &r : results)
+    {
+        seen[r.name] = true;
+        if (!r.ok)
+        {
+            res.push_back(r.name + ": failed to render: " + r.error);
+            continue;
+        }
+        auto b = baseline.find(r.name);
+        if (b == baseline.end())
+        {
+            res.push_back(r.name + ": not in the baseline");
+            continue;
+        }
+
+        auto &was = b->second;
+        auto &now = r.print;
+        std::ostringstream why;
+        why << std::fixed << std::setprecision(2);
+        auto lenDiff = std::fabs((double)(now.frames - was.frames)) / sampleRate;
+        if (lenDiff > tol.lengthSeconds)
+            why << " length " << was.frames / sampleRate << "s -> " << now.frames / sampleRate
+                << "s;";
+        if (std::fabs(toDb(now.rms) - toDb(was.rms)) > tol.levelDb)
+            why << " rms " << toDb(was.rms) << "dB -> " << toDb(now.rms) << "dB;";
+        if (std::fabs(toDb(now.peak) - toDb(was.peak)) > tol.levelDb)
+            why << " peak " << toDb(was.peak) << "dB -> " << toDb(now.peak) << "dB;";
+        if (std::fabs(now.centroidHz - was.centroidHz) >
+            tol.centroidFraction * std::max(was.centroidHz, 1.f))
+            why << " centroid " << was.centroidHz << "Hz -> " << now.centroidHz << "Hz;";
+        if (tol.requireHash && now.hash != was.hash)
+            why << " hash differs;";
+
+        auto s = why.str();
+        if (!s.empty())
+        {
+            s.pop_back();
+            res.push_back(r.name + ":" + s);
+        }
+    }
+    for (const auto &[name, p] : baseline)
+        if (!seen.count(name))
+            res.push_back(name + ": in the baseline but not rendered");
+    return res;
+}
+} // namespace baconpaul::six_sines::render
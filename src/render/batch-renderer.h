@@ -0,0 +1,122 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_RENDER_BATCH_RENDERER_H
+#define BACONPAUL_SIX_SINES_RENDER_BATCH_RENDERER_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "render/offline-renderer.h"
+
+/*
+ * Batch rendering: many patches through the same score on a pool of threads, each patch
+ * on a fresh synth with a fixed random seed, so a patch's audio does not depend on which
+ * thread rendered it or what rendered before. Each render is summarised as a Fingerprint
+ * and can also be written to a WAV preview.
+ *
+ * The fingerprint CSV (see writeFingerprints) is the regression baseline. The hash only
+ * matches on the same build and platform; the level, centroid and length comparisons in
+ * compareFingerprints are the ones to gate on across compilers.
+ */
+namespace baconpaul::six_sines::render
+{
+struct Fingerprint
+{
+    int64_t frames{0};
+    float rms{0.f}, peak{0.f}; // linear, over both channels
+    float centroidHz{0.f};     // spectral centroid of the mono sum over the whole render
+    uint64_t hash{0};          // FNV-1a over every output sample
+};
+
+struct FingerprintBuilder
+{
+    explicit FingerprintBuilder(double sampleRate);
+    void add(const float *L, const float *R, int frames);
+    Fingerprint finish();
+
+    static constexpr int analysisSize{2048};
+
+  private:
+    void analyseFrame();
+
+    double sampleRate;
+    Fingerprint print;
+    double sumSquares{0};
+    std::vector<float> frame;
+    std::vector<double> power;
+    int fill{0};
+};
+
+struct BatchJob
+{
+    std::string name; // "Category/Patch" for the factory library
+    std::string patchData;
+};
+
+// Every factory patch, in category then patch order
+std::vector<BatchJob> factoryPatchJobs();
+
+// A few notes across the keyboard at soft, medium and hard velocities, then a held chord
+extern const char *batchScoreNotes;
+
+struct BatchOptions
+{
+    double sampleRate{48000.0};
+    int threads{0}; // 0 for one per hardware thread
+    uint32_t randomSeed{0x5155};
+    RenderOptions render{6.0};
+    std::string wavDirectory; // write <wavDirectory>/<name>.wav previews when set
+};
+
+struct BatchResult
+{
+    std::string name;
+    bool ok{false};
+    std::string error;
+    Fingerprint print;
+    double renderSeconds{0}; // wall clock
+};
+
+using batchProgress_t = std::function<void(size_t done, size_t total, const BatchResult &)>;
+
+// Results come back in job order. progress, if set, is called as each job finishes, one
+// call at a time but from the worker threads
+std::vector<BatchResult> renderBatch(const std::vector<BatchJob> &jobs, const Score &score,
+                                     const BatchOptions &options,
+                                     const batchProgress_t &progress = {});
+
+bool writeFingerprints(const std::string &path, const std::vector<BatchResult> &results);
+bool readFingerprints(const std::string &path, std::map<std::string, Fingerprint> &into,
+                      std::string &err);
+
+struct FingerprintTolerance
+{
+    float levelDb{0.1f};
+    float centroidFraction{0.01f};
+    double lengthSeconds{0.1};
+    bool requireHash{false};
+};
+
+// One line for each patch which failed, changed beyond the tolerance, or is missing from
+// either side; empty when the results match the baseline
+std::vector<std::string> compareFingerprints(const std::map<std::string, Fingerprint> &baseline,
+                                             const std::vector<BatchResult> &results,
+                                             double sampleRate, const FingerprintTolerance &tol);
+} // namespace baconpaul::six_sines::render
+#endif // BATCH_RENDERER_H
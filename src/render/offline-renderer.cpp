@@ -0,0 +1,429 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "offline-renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace baconpaul::six_sines::render
+{
+namespace
+{
+bool isNoteOff(const ScoreEvent &e)
+{
+    auto kind = e.data[0] & 0xF0;
+    return kind == 0x80 || (kind == 0x90 && e.data[2] == 0);
+}
+
+bool toNumber(const std::string &s, double &v)
+{
+    char *end{nullptr};
+    v = std::strtod(s.c_str(), &end);
+    return end != s.c_str() && *end == 0 && std::isfinite(v);
+}
+
+bool toInt(const std::string &s, int lo, int hi, int &v)
+{
+    double d;
+    if (!toNumber(s, d) || d != std::floor(d) || d < lo || d > hi)
+        return false;
+    v = (int)d;
+    return true;
+}
+
+struct MidiReader
+{
+    const std::vector<uint8_t> &b;
+    size_t pos{0}, end{0};
+    bool ok{true};
+
+    MidiReader(const std::vector<uint8_t> &bytes) : b(bytes), end(bytes.size()) {}
+
+    uint8_t peek()
+    {
+        if (pos >= end)
+        {
+            ok = false;
+            return 0;
+        }
+        return b[pos];
+    }
+    uint8_t u8()
+    {
+        auto r = peek();
+        if (ok)
+            pos++;
+        return r;
+    }
+    uint32_t bigEndian(int bytes)
+    {
+        uint32_t r{0};
+        for (int i = 0; i < bytes; ++i)
+            r = (r << 8) | u8();
+        return r;
+    }
+    uint32_t varLen()
+    {
+        uint32_t r{0};
+        for (int i = 0; i < 4; ++i)
+        {
+            auto c = u8();
+            r = (r << 7) | (c & 0x7F);
+            if (!(c & 0x80))
+                return r;
+        }
+        ok = false;
+        return r;
+    }
+    void skip(uint32_t n)
+    {
+        if (n > end - pos)
+            ok = false;
+        else
+            pos += n;
+    }
+};
+
+struct TickEvent
+{
+    uint64_t tick;
+    uint8_t data[3];
+};
+} // namespace
+
+void Score::sort()
+{
+    std::stable_sort(events.begin(), events.end(),
+                     [](const ScoreEvent &a, const ScoreEvent &b)
+                     {
+                         if (a.sample != b.sample)
+                             return a.sample < b.sample;
+                         return isNoteOff(a) && !isNoteOff(b);
+                     });
+}
+
+bool parseNoteList(const std::string &text, double sampleRate, Score &score, std::string &err)
+{
+    std::istringstream in(text);
+    std::string line;
+    int lineNo{0};
+    while (std::getline(in, line))
+    {
+        lineNo++;
+        auto hash = line.find('#');
+        if (hash != std::string::npos)
+            line = line.substr(0, hash);
+
+        std::istringstream ls(line);
+        std::vector<std::string> tok;
+        std::string t;
+        while (ls >> t)
+            tok.push_back(t);
+        if (tok.empty())
+            continue;
+
+        auto fail = [&](const std::string &why)
+        {
+            err = "Line " + std::to_string(lineNo) + ": " + why;
+            return false;
+        };
+        auto toSample = [sampleRate](double seconds)
+        { return (int64_t)std::llround(seconds * sampleRate); };
+
+        // The optional trailing channel, at tok[idx] if present
+        auto channelAt = [&](size_t idx, int &ch)
+        {
+            ch = 0;
+            return tok.size() <= idx || toInt(tok[idx], 0, 15, ch);
+        };
+
+        double time;
+        if (tok.size() < 2 || !toNumber(tok[1], time) || time < 0)
+            return fail("expected a time in seconds after '" + tok[0] + "'");
+
+        int ch;
+        if (tok[0] == "note")
+        {
+            double dur;
+            int key, vel{100};
+            if (tok.size() < 4 || tok.size() > 6)
+                return fail("note takes <start> <duration> <key> [velocity] [channel]");
+            if (!toNumber(tok[2], dur) || dur <= 0)
+                return fail("bad duration '" + tok[2] + "'");
+            if (!toInt(tok[3], 0, 127, key))
+                return fail("bad key '" + tok[3] + "'");
+            if (tok.size() > 4 && !toInt(tok[4], 1, 127, vel))
+                return fail("bad velocity '" + tok[4] + "'");
+            if (!channelAt(5, ch))
+                return fail("bad channel '" + tok[5] + "'");
+            score.events.push_back(
+                {toSample(time), {(uint8_t)(0x90 | ch), (uint8_t)key, (uint8_t)vel}});
+            score.events.push_back({toSample(time + dur), {(uint8_t)(0x80 | ch), (uint8_t)key, 0}});
+        }
+        else if (tok[0] == "cc")
+        {
+            int cc, val;
+            if (tok.size() < 4 || tok.size() > 5)
+                return fail("cc takes <time> <controller> <value> [channel]");
+            if (!toInt(tok[2], 0, 127, cc))
+                return fail("bad controller '" + tok[2] + "'");
+            if (!toInt(tok[3], 0, 127, val))
+                return fail("bad value '" + tok[3] + "'");
+            if (!channelAt(4, ch))
+                return fail("bad channel '" + tok[4] + "'");
+            score.events.push_back(
+                {toSample(time), {(uint8_t)(0xB0 | ch), (uint8_t)cc, (uint8_t)val}});
+        }
+        else if (tok[0] == "bend")
+        {
+            int val;
+            if (tok.size() < 3 || tok.size() > 4)
+                return fail("bend takes <time> <value> [channel]");
+            if (!toInt(tok[2], -8192, 8191, val))
+                return fail("bad bend '" + tok[2] + "'");
+            if (!channelAt(3, ch))
+                return fail("bad channel '" + tok[3] + "'");
+            auto v = val + 8192;
+            score.events.push_back(
+                {toSample(time), {(uint8_t)(0xE0 | ch), (uint8_t)(v & 0x7F), (uint8_t)(v >> 7)}});
+        }
+        else if (tok[0] == "pressure")
+        {
+            int val;
+            if (tok.size() < 3 || tok.size() > 4)
+                return fail("pressure takes <time> <value> [channel]");
+            if (!toInt(tok[2], 0, 127, val))
+                return fail("bad pressure '" + tok[2] + "'");
+            if (!channelAt(3, ch))
+                return fail("bad channel '" + tok[3] + "'");
+            score.events.push_back({toSample(time), {(uint8_t)(0xD0 | ch), (uint8_t)val, 0}});
+        }
+        else
+        {
+            return fail("unknown event '" + tok[0] + "'");
+        }
+    }
+    score.sort();
+    return true;
+}
+
+bool parseMidiFile(const std::vector<uint8_t> &bytes, double sampleRate, Score &score,
+                   std::string &err)
+{
+    MidiReader r(bytes);
+    if (bytes.size() < 14 || memcmp(bytes.data(), "MThd", 4) != 0)
+    {
+        err = "Not a standard MIDI file";
+        return false;
+    }
+    r.pos = 4;
+    auto headerLen = r.bigEndian(4);
+    r.bigEndian(2); // format; type 2 sequences are laid end to end by their own times anyway
+    r.bigEndian(2); // track count; we read however many MTrk chunks there are
+    auto division = r.bigEndian(2);
+    if (division == 0)
+    {
+        err = "MIDI file has a zero time division";
+        return false;
+    }
+    r.pos = 8;
+    r.skip(headerLen);
+
+    std::vector<TickEvent> events;
+    std::vector<std::pair<uint64_t, uint32_t>> tempos; // tick, microseconds a quarter
+    while (r.ok && r.pos + 8 <= bytes.size())
+    {
+        auto id = r.pos;
+        r.pos += 4;
+        auto len = r.bigEndian(4);
+        if (len > bytes.size() - r.pos)
+        {
+            err = "MIDI file is truncated";
+            return false;
+        }
+        if (memcmp(&bytes[id], "MTrk", 4) != 0)
+        {
+            r.skip(len);
+            continue;
+        }
+
+        MidiReader t(bytes);
+        t.pos = r.pos;
+        t.end = r.pos + len;
+        r.skip(len);
+
+        uint64_t tick{0};
+        uint8_t running{0};
+        while (t.ok && t.pos < t.end)
+        {
+            tick += t.varLen();
+            auto status = t.peek();
+            if (status & 0x80)
+                t.u8();
+            else if (running)
+                status = running;
+            else
+            {
+                err = "MIDI data byte with no running status";
+                return false;
+            }
+
+            if (status == 0xFF)
+            {
+                auto type = t.u8();
+                auto mlen = t.varLen();
+                if (type == 0x51 && mlen == 3)
+                    tempos.emplace_back(tick, t.bigEndian(3));
+                else
+                    t.skip(mlen);
+                running = 0;
+                if (type == 0x2F)
+                    break;
+            }
+            else if (status == 0xF0 || status == 0xF7)
+            {
+                t.skip(t.varLen());
+                running = 0;
+            }
+            else if (status > 0xF0)
+            {
+                err = "Unexpected system message in MIDI track";
+                return false;
+            }
+            else
+            {
+                running = status;
+                auto kind = status & 0xF0;
+                auto d1 = t.u8();
+                uint8_t d2 = (kind == 0xC0 || kind == 0xD0) ? 0 : t.u8();
+                // Program changes select nothing here; everything else goes to the voice manager
+                if (kind != 0xC0)
+                    events.push_back({tick, {status, (uint8_t)(d1 & 0x7F), (uint8_t)(d2 & 0x7F)}});
+            }
+        }
+        if (!t.ok)
+        {
+            err = "MIDI track is truncated";
+            return false;
+        }
+    }
+
+    // Seconds at each tempo change, from the default 120bpm at tick 0
+    std::stable_sort(tempos.begin(), tempos.end(),
+                     [](auto &a, auto &b) { return a.first < b.first; });
+    struct Segment
+    {
+        uint64_t tick;
+        double seconds, secondsPerTick;
+    };
+    std::vector<Segment> segments;
+    if (division & 0x8000)
+    {
+        // SMPTE: frames a second and ticks a frame, no tempo
+        auto fps = -(int)(int8_t)(division >> 8);
+        auto tpf = (int)(division & 0xFF);
+        if (fps <= 0 || tpf <= 0)
+        {
+            err = "Bad SMPTE time division";
+            return false;
+        }
+        segments.push_back({0, 0.0, 1.0 / (fps * tpf)});
+    }
+    else
+    {
+        segments.push_back({0, 0.0, 0.5 / division});
+        for (auto &[tk, us] : tempos)
+        {
+            auto &prev = segments.back();
+            auto sec = prev.seconds + (tk - prev.tick) * prev.secondsPerTick;
+            auto spt = us * 1e-6 / division;
+            if (tk == prev.tick)
+                prev.secondsPerTick = spt;
+            else
+                segments.push_back({tk, sec, spt});
+        }
+    }
+
+    for (auto &e : events)
+    {
+        auto it = std::upper_bound(segments.begin(), segments.end(), e.tick,
+                                   [](uint64_t tk, const Segment &s) { return tk < s.tick; });
+        auto &s = *(it - 1);
+        auto seconds = s.seconds + (e.tick - s.tick) * s.secondsPerTick;
+        ScoreEvent se;
+        se.sample = (int64_t)std::llround(seconds * sampleRate);
+        memcpy(se.data, e.data, 3);
+        score.events.push_back(se);
+    }
+    score.sort();
+    return true;
+}
+
+bool prepareSynth(Synth &synth, const std::string &patchData, double sampleRate,
+                  std::string &err)
+{
+    if (!synth.patch.fromState(patchData))
+    {
+        err = "Unable to read the patch";
+        return false;
+    }
+    Synth::prepareWaveFormsFor(synth.patch);
+    // setSampleRate takes the strategy and resampler from the patch, so it follows the load
+    synth.setSampleRate(sampleRate);
+    synth.postLoad();
+    synth.eventTiming = Synth::SAMPLE_ACCURATE;
+    synth.renderingOffline = true;
+    return true;
+}
+
+int64_t renderScore(Synth &synth, const Score &score, const RenderOptions &options,
+                    const blockSink_t &onBlock)
+{
+    // One silent block starts the event clock, so even events in the first block are timed
+    synth.process(nullptr);
+
+    auto &ev = score.events;
+    auto last = score.lastSample();
+    auto stopBy = last + (int64_t)(options.maxTailSeconds * synth.hostSampleRate);
+    size_t next{0};
+    int64_t pos{0};
+    while (true)
+    {
+        while (next < ev.size() && ev[next].sample < pos + blockSize)
+        {
+            clap_event_midi_t m{};
+            m.header.size = sizeof(m);
+            m.header.type = CLAP_EVENT_MIDI;
+            m.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+            m.port_index = 0;
+            memcpy(m.data, ev[next].data, 3);
+            synth.scheduleEvent(&m.header, (int32_t)(ev[next].sample - pos));
+            next++;
+        }
+
+        synth.process(nullptr);
+        onBlock(synth.output[0], synth.output[1], blockSize);
+        pos += blockSize;
+
+        if (next == ev.size() && pos > last && (synth.isIdle() || pos >= stopBy))
+            break;
+    }
+    return pos;
+}
+} // namespace baconpaul::six_sines::render
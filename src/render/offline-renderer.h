@@ -0,0 +1,75 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_RENDER_OFFLINE_RENDERER_H
+#define BACONPAUL_SIX_SINES_RENDER_OFFLINE_RENDERER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "synth/synth.h"
+
+/*
+ * Headless rendering for six-sines-render: a patch and a score in, host rate stereo out,
+ * with no plugin wrapper, host or UI. The score is MIDI 1 channel messages at host sample
+ * times, read from a standard MIDI file or a note list, and every message is scheduled
+ * with the engine's sample accurate events so it lands on its exact sample.
+ *
+ * The note list is one event a line, times in seconds, channels 0 - 15, # comments:
+ *
+ *     note <start> <duration> <key> [velocity 1-127, default 100] [channel]
+ *     cc <time> <controller> <value 0-127> [channel]
+ *     bend <time> <value -8192 - 8191> [channel]
+ *     pressure <time> <value 0-127> [channel]
+ */
+namespace baconpaul::six_sines::render
+{
+struct ScoreEvent
+{
+    int64_t sample{0};
+    uint8_t data[3]{0, 0, 0};
+};
+
+struct Score
+{
+    std::vector<ScoreEvent> events; // in time order; note offs first at a shared time
+    void sort();
+    int64_t lastSample() const { return events.empty() ? 0 : events.back().sample; }
+};
+
+bool parseNoteList(const std::string &text, double sampleRate, Score &score, std::string &err);
+bool parseMidiFile(const std::vector<uint8_t> &bytes, double sampleRate, Score &score,
+                   std::string &err);
+
+// Loads .sxsnp content into the synth's patch and brings it up at sampleRate for offline
+// rendering with sample accurate events
+bool prepareSynth(Synth &synth, const std::string &patchData, double sampleRate,
+                  std::string &err);
+
+struct RenderOptions
+{
+    // Rendering stops once the engine is idle after the last event, or this long after it
+    double maxTailSeconds{30.0};
+};
+
+// Renders the score through a prepared synth, handing each host block to onBlock, and
+// returns the sample frames rendered
+using blockSink_t = std::function<void(const float *L, const float *R, int frames)>;
+int64_t renderScore(Synth &synth, const Score &score, const RenderOptions &options,
+                    const blockSink_t &onBlock);
+} // namespace baconpaul::six_sines::render
+#endif // OFFLINE_RENDERER_H
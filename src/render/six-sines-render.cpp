@@ -0,0 +1,277 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+/*
+ * six-sines-render: render a patch playing a MIDI file or note list to a float WAV,
+ * headless and as fast as the engine runs. See render/offline-renderer.h for the note
+ * list format.
+ *
+ * With --factory it instead renders every factory patch through a fixed script on a pool
+ * of threads, writing a fingerprint CSV, optionally WAV previews, and optionally comparing
+ * against an earlier CSV as a regression gate. See render/batch-renderer.h.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+
+#include "infra/RIFFWavWriter.h"
+#include "render/offline-renderer.h"
+#include "render/batch-renderer.h"
+
+namespace sxr = baconpaul::six_sines::render;
+using baconpaul::six_sines::blockSize;
+using baconpaul::six_sines::RIFFWavWriter;
+using baconpaul::six_sines::Synth;
+
+namespace
+{
+int usage(const char *why = nullptr)
+{
+    if (why)
+        std::cerr << "six-sines-render: " << why << "\n\n";
+    std::cerr << "Usage: six-sines-render --patch <file.sxsnp> (--midi <file.mid> | --notes "
+                 "<file.txt>)\n"
+                 "                        --out <file.wav> [--rate <hz>] [--tail <seconds>]\n"
+                 "       six-sines-render --factory <dir> [--threads <n>] [--previews]\n"
+                 "                        [--compare <baseline.csv>] [--rate <hz>] [--tail <seconds>]\n"
+                 "\n"
+                 "  --rate      host sample rate of the render (default 48000)\n"
+                 "  --tail      longest render after the last event (default 30, 6 with\n"
+                 "              --factory); rendering stops sooner once the output is silent\n"
+                 "  --factory   render every factory patch, writing <dir>/fingerprints.csv\n"
+                 "  --threads   render threads for --factory (default one per core)\n"
+                 "  --previews  also write <dir>/previews/<category>/<patch>.wav\n"
+                 "  --compare   exit 1 if any patch's level, centroid or length moved from\n"
+                 "              the baseline fingerprints\n";
+    return 2;
+}
+
+bool readFile(const std::string &path, std::string &into)
+{
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open())
+        return false;
+    std::stringstream ss;
+    ss << f.rdbuf();
+    into = ss.str();
+    return true;
+}
+
+int renderFactory(const std::string &dir, const sxr::BatchOptions &options,
+                  const std::string &comparePath)
+{
+    std::map<std::string, sxr::Fingerprint> baseline;
+    std::string err;
+    if (!comparePath.empty() && !sxr::readFingerprints(comparePath, baseline, err))
+    {
+        std::cerr << "six-sines-render: " << comparePath << ": " << err << "\n";
+        return 1;
+    }
+
+    sxr::Score score;
+    if (!sxr::parseNoteList(sxr::batchScoreNotes, options.sampleRate, score, err))
+    {
+        std::cerr << "six-sines-render: batch score: " << err << "\n";
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+
+    auto jobs = sxr::factoryPatchJobs();
+    auto start = std::chrono::steady_clock::now();
+    auto results = sxr::renderBatch(jobs, score, options,
+                                    [](size_t done, size_t total, const sxr::BatchResult &r)
+                                    {
+                                        std::cout << "[" << done << "/" << total << "] "
+                                                  << r.name;
+                                        if (!r.ok)
+                                            std::cout << " FAILED: " << r.error;
+                                        std::cout << std::endl;
+                                    });
+    auto took = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failed{0};
+    double audio{0};
+    for (auto &r : results)
+    {
+        failed += !r.ok;
+        audio += r.print.frames / options.sampleRate;
+    }
+
+    auto csv = (std::filesystem::path(dir) / "fingerprints.csv").string();
+    if (!sxr::writeFingerprints(csv, results))
+    {
+        std::cerr << "six-sines-render: unable to write " << csv << "\n";
+        return 1;
+    }
+    std::cout << "Rendered " << results.size() - failed << " of " << results.size()
+              << " patches (" << audio << "s of audio) in " << took << "s to " << csv
+              << std::endl;
+
+    if (comparePath.empty())
+        return failed ? 1 : 0;
+
+    auto diffs = sxr::compareFingerprints(baseline, results, options.sampleRate, {});
+    for (auto &d : diffs)
+        std::cout << "CHANGED " << d << "\n";
+    std::cout << diffs.size() << " differences from " << comparePath << std::endl;
+    return diffs.empty() && !failed ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string patchPath, midiPath, notesPath, outPath, factoryDir, comparePath;
+    double rate{48000.0};
+    std::optional<double> tail;
+    int threads{0};
+    bool previews{false};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string a = argv[i];
+        if (a == "--previews")
+        {
+            previews = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return usage(("missing a value after " + a).c_str());
+        std::string v = argv[++i];
+        try
+        {
+            if (a == "--patch")
+                patchPath = v;
+            else if (a == "--midi")
+                midiPath = v;
+            else if (a == "--notes")
+                notesPath = v;
+            else if (a == "--out")
+                outPath = v;
+            else if (a == "--rate")
+                rate = std::stod(v);
+            else if (a == "--tail")
+                tail = std::stod(v);
+            else if (a == "--factory")
+                factoryDir = v;
+            else if (a == "--threads")
+                threads = std::stoi(v);
+            else if (a == "--compare")
+                comparePath = v;
+            else
+                return usage(("unknown option " + a).c_str());
+        }
+        catch (const std::exception &)
+        {
+            return usage(("bad number '" + v + "' for " + a).c_str());
+        }
+    }
+    if (rate < 8000 || rate > 768000)
+        return usage("rate must be between 8000 and 768000");
+
+    if (!factoryDir.empty())
+    {
+        sxr::BatchOptions batch;
+        batch.sampleRate = rate;
+        batch.threads = threads;
+        if (tail)
+            batch.render.maxTailSeconds = *tail;
+        if (previews)
+            batch.wavDirectory = (std::filesystem::path(factoryDir) / "previews").string();
+        return renderFactory(factoryDir, batch, comparePath);
+    }
+
+    if (patchPath.empty() || outPath.empty() || midiPath.empty() == notesPath.empty())
+        return usage();
+    sxr::RenderOptions options;
+    if (tail)
+        options.maxTailSeconds = *tail;
+
+    std::string patchData, scoreData, err;
+    if (!readFile(patchPath, patchData))
+    {
+        std::cerr << "six-sines-render: can't read " << patchPath << "\n";
+        return 1;
+    }
+    auto &scorePath = midiPath.empty() ? notesPath : midiPath;
+    if (!readFile(scorePath, scoreData))
+    {
+        std::cerr << "six-sines-render: can't read " << scorePath << "\n";
+        return 1;
+    }
+
+    sxr::Score score;
+    auto parsed = midiPath.empty()
+                      ? sxr::parseNoteList(scoreData, rate, score, err)
+                      : sxr::parseMidiFile(std::vector<uint8_t>(scoreData.begin(), scoreData.end()),
+                                           rate, score, err);
+    if (!parsed)
+    {
+        std::cerr << "six-sines-render: " << scorePath << ": " << err << "\n";
+        return 1;
+    }
+
+    // Constructing the synth builds the DSP tables the patch load needs
+    auto synth = std::make_unique<Synth>(false);
+    if (!sxr::prepareSynth(*synth, patchData, rate, err))
+    {
+        std::cerr << "six-sines-render: " << patchPath << ": " << err << "\n";
+        return 1;
+    }
+
+    RIFFWavWriter wav(outPath, 2);
+    if (!wav.openFile())
+    {
+        std::cerr << "six-sines-render: " << wav.errMsg << "\n";
+        return 1;
+    }
+    wav.writeRIFFHeader();
+    wav.writeFMTChunk((int32_t)std::round(rate));
+    wav.startDataChunk();
+
+    auto start = std::chrono::steady_clock::now();
+    auto frames = sxr::renderScore(*synth, score, options,
+                                   [&wav](const float *L, const float *R, int n)
+                                   {
+                                       float inter[2 * blockSize];
+                                       for (int i = 0; i < n; ++i)
+                                       {
+                                           inter[2 * i] = L[i];
+                                           inter[2 * i + 1] = R[i];
+                                       }
+                                       wav.pushInterleavedBlock(inter, 2 * n);
+                                   });
+    auto took = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!wav.closeFile())
+    {
+        std::cerr << "six-sines-render: unable to finish writing " << outPath << "\n";
+        return 1;
+    }
+
+    auto seconds = frames / rate;
+    std::cout << "Rendered " << seconds << "s of " << score.events.size() << " events to "
+              << outPath << " in " << took << "s (" << (took > 0 ? seconds / took : 0.0)
+              << "x real time)" << std::endl;
+    return 0;
+}
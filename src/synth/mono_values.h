@@ -21,7 +21,10 @@
 #include <sst/basic-blocks/tables/TwoToTheXProvider.h>
 #include <sst/basic-blocks/dsp/RNG.h>
 
+#include <optional>
+
 #include "mod_matrix.h"
+#include "node_profiler.h"
 
 struct MTSClient;
 
@@ -50,8 +53,12 @@ struct SRProvider
 
 struct MonoValues
 {
-    MonoValues() : sr(twoToTheX)
+    // Without a seed the random stream (and every voice's, which are seeded from it) differs
+    // each run. Offline renders pass one so the same patch and score give the same audio.
+    explicit MonoValues(std::optional<uint32_t> rngSeed = std::nullopt) : sr(twoToTheX)
     {
+        if (rngSeed)
+            rng = sst::basic_blocks::dsp::RNG(*rngSeed);
         tuningProvider.init();
         twoToTheX.init();
         dbToLinear.init();
@@ -79,6 +86,12 @@ struct MonoValues
 
     bool attackFloorOnRetrig{true};
     bool designModeRunAll{false};
+    // Peak level under which a voice counts as silent for early retirement (see
+    // Voice::trackSilence). 0 disables it. Set from the voiceSleepThresholdDb user default.
+    float voiceSleepThreshold{1e-6f};
+    // Operators on SIN and the TX shapes evaluate with the SinTable POLY backend rather
+    // than the tables, latched at attack. Set from the polySineBackend user default.
+    bool polySine{false};
 
     std::array<float *, numMacros> macroPtr;
 
@@ -90,6 +103,9 @@ struct MonoValues
 
     sst::basic_blocks::dsp::RNG rng;
 
+    // Engine time by category, filled only in SIX_SINES_NODE_PROFILING builds
+    mutable node_profiler::Totals nodeProfile;
+
     ModMatrixConfig modMatrixConfig;
 
     SRProvider sr;
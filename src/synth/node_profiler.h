@@ -0,0 +1,217 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_SYNTH_NODE_PROFILER_H
+#define BACONPAUL_SIX_SINES_SYNTH_NODE_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#if SIX_SINES_NODE_PROFILING
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define SIX_SINES_NODE_PROFILING_TSC 1
+#else
+#include <chrono>
+#endif
+#endif
+
+/*
+ * Optional per category timing of the engine, for the profiler in the settings panel.
+ * Built only with the SIX_SINES_NODE_PROFILING cmake option; otherwise every Session
+ * and Scope is empty and compiles away.
+ *
+ * Time is exclusive: opening a Scope charges the time since the last transition to
+ * the enclosing category, so the envelope and LFO work inside an operator's render is
+ * counted under MODULATORS and not the operator. Each thread which renders for a synth
+ * (the audio thread and any render pool worker) opens a Session, accumulates into
+ * thread local counters and adds them to the synth's Totals when the session closes.
+ * Time inside a session but outside any scope is OTHER: voice management, the pitch
+ * and portamento setup of each voice, and the rest of the block loop.
+ *
+ * The tick is the TSC on x86 and steady_clock elsewhere. Only the shares are reported,
+ * so the unit never matters.
+ */
+namespace baconpaul::six_sines::node_profiler
+{
+#if SIX_SINES_NODE_PROFILING
+static constexpr bool enabled{true};
+#else
+static constexpr bool enabled{false};
+#endif
+
+enum Category : uint32_t
+{
+    OP_SINE, // operators by extended mode, in ExtendedMode order
+    OP_PHASE_MAP,
+    OP_RESONANT_SWEEP,
+    OP_NOISE,
+    MATRIX,
+    SELF,
+    MIXER, // the mixer nodes and each voice's output stage
+    MODULATORS,
+    MACRO,
+    END_OF_CHAIN,
+    RESAMPLER,
+    OTHER,
+    numCategories
+};
+
+inline const char *categoryName(Category c)
+{
+    switch (c)
+    {
+    case OP_SINE:
+        return "Operators";
+    case OP_PHASE_MAP:
+        return "Operators (Phase Map)";
+    case OP_RESONANT_SWEEP:
+        return "Operators (Res Sweep)";
+    case OP_NOISE:
+        return "Operators (Noise)";
+    case MATRIX:
+        return "Matrix";
+    case SELF:
+        return "Feedback";
+    case MIXER:
+        return "Mixer and Output";
+    case MODULATORS:
+        return "Envelopes and LFOs";
+    case MACRO:
+        return "Macros";
+    case END_OF_CHAIN:
+        return "End of Chain";
+    case RESAMPLER:
+        return "Resampler";
+    case OTHER:
+    case numCategories:
+        break;
+    }
+    return "Other";
+}
+
+inline Category operatorCategory(uint32_t extendedMode)
+{
+    return extendedMode <= OP_NOISE - OP_SINE ? (Category)(OP_SINE + extendedMode) : OP_SINE;
+}
+
+inline uint64_t ticks()
+{
+#if SIX_SINES_NODE_PROFILING_TSC
+    return __rdtsc();
+#elif SIX_SINES_NODE_PROFILING
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#else
+    return 0;
+#endif
+}
+
+struct Totals
+{
+    std::array<std::atomic<uint64_t>, numCategories> ticks{};
+};
+
+struct ThreadState
+{
+    Totals *into{nullptr};
+    Category current{OTHER};
+    uint64_t last{0};
+    uint64_t local[numCategories]{};
+};
+inline thread_local ThreadState threadState;
+
+// Collects this thread's time into a synth's totals. Nested sessions (the audio thread
+// rendering its own voice slice) fold into the outer one.
+struct Session
+{
+    explicit Session(Totals &t)
+    {
+        if constexpr (enabled)
+        {
+            auto &s = threadState;
+            if (s.into)
+                return;
+            owner = true;
+            s.into = &t;
+            s.current = OTHER;
+            s.last = ticks();
+        }
+    }
+    ~Session()
+    {
+        if constexpr (enabled)
+        {
+            if (!owner)
+                return;
+            auto &s = threadState;
+            s.local[s.current] += ticks() - s.last;
+            for (uint32_t i = 0; i < numCategories; ++i)
+            {
+                if (s.local[i])
+                    s.into->ticks[i].fetch_add(s.local[i], std::memory_order_relaxed);
+                s.local[i] = 0;
+            }
+            s.into = nullptr;
+        }
+    }
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
+
+    bool owner{false};
+};
+
+struct Scope
+{
+    explicit Scope(Category c)
+    {
+        if constexpr (enabled)
+        {
+            auto &s = threadState;
+            if (!s.into)
+                return;
+            auto now = ticks();
+            s.local[s.current] += now - s.last;
+            s.last = now;
+            prior = s.current;
+            s.current = c;
+            open = true;
+        }
+    }
+    ~Scope()
+    {
+        if constexpr (enabled)
+        {
+            if (!open)
+                return;
+            auto &s = threadState;
+            auto now = ticks();
+            s.local[s.current] += now - s.last;
+            s.last = now;
+            s.current = prior;
+        }
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    Category prior{OTHER};
+    bool open{false};
+};
+} // namespace baconpaul::six_sines::node_profiler
+#endif // NODE_PROFILER_H
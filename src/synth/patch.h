@@ -1816,7 +1816,8 @@ struct Patch : pats::PatchBase<Patch, Param>
                                  .withName(name() + " Resampler Engine")
                                  .withGroupName(name())
                                  .withDefault(ResamplerEngine::SRC_FAST)
-                                 .withRange(ResamplerEngine::SRC_FAST, ResamplerEngine::ZOH)
+                                 .withRange(ResamplerEngine::SRC_FAST,
+                                            ResamplerEngine::POLYPHASE_HQ)
                                  .withID(id(41))
                                  .withUnorderedMapFormatting({
                                      {ResamplerEngine::SRC_FAST, "SRC Fast (rec)"},
@@ -1825,6 +1826,8 @@ struct Patch : pats::PatchBase<Patch, Param>
                                      {ResamplerEngine::LANCZOS, "Lanczos A=4"},
                                      {ResamplerEngine::LINTERP, "Linear Interp"},
                                      {ResamplerEngine::ZOH, "ZOH"},
+                                     {ResamplerEngine::POLYPHASE, "Polyphase FIR"},
+                                     {ResamplerEngine::POLYPHASE_HQ, "Polyphase FIR HQ"},
                                  })),
               saturationType(intMd(version_120e)
                                  .withName(name() + " Saturation Type")
@@ -0,0 +1,165 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_SYNTH_PROCESS_TIMING_H
+#define BACONPAUL_SIX_SINES_SYNTH_PROCESS_TIMING_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+/*
+ * Tail latency of the audio thread. The CPU meter is an average; a host drops out on the
+ * one slow buffer, such as the block which attacks five unison voices at once. Each
+ * duration is recorded as a fraction of the realtime it covers. Only a host buffer has a
+ * real deadline, where 1.0 is delivered just in time and anything over is an xrun; a
+ * single engine block over its own few samples is just an expensive block, which the
+ * rest of the buffer may well absorb, so those histograms are relative cost only.
+ *
+ * The audio thread is the only writer, so a record is a handful of relaxed loads and
+ * stores with no locked instructions. Any thread may read a summary or ask for a reset
+ * at any time; the reset lands at the next record.
+ */
+namespace baconpaul::six_sines
+{
+struct TimingHistogram
+{
+    // Without a deadline the over budget and late counts stay at zero
+    explicit TimingHistogram(bool deadline = true) : hasDeadline(deadline) {}
+    const bool hasDeadline;
+
+    // Eighth octave bins from 1/1024 of the deadline to 16 times it, about 9% wide, so
+    // the percentiles are upper bounds good to a bin. Anything outside lands in an end bin
+    static constexpr int binsPerOctave{8};
+    static constexpr int lowOctave{-10}, highOctave{4};
+    static constexpr int numBins{(highOctave - lowOctave) * binsPerOctave};
+
+    static int binFor(double fraction)
+    {
+        if (!(fraction > 0.0))
+            return 0;
+        auto b = (int)std::floor((std::log2(fraction) - lowOctave) * binsPerOctave);
+        return std::clamp(b, 0, numBins - 1);
+    }
+    static double binTop(int b) { return std::exp2(lowOctave + (b + 1.0) / binsPerOctave); }
+
+    // Audio thread only
+    void record(double fraction)
+    {
+        if (resetRequested.load(std::memory_order_acquire))
+        {
+            for (auto &c : counts)
+                c.store(0, std::memory_order_relaxed);
+            over.store(0, std::memory_order_relaxed);
+            late.store(0, std::memory_order_relaxed);
+            worst.store(0.0, std::memory_order_relaxed);
+            resetRequested.store(false, std::memory_order_release);
+        }
+
+        bump(counts[binFor(fraction)]);
+        if (hasDeadline)
+        {
+            if (fraction > overThreshold.load(std::memory_order_relaxed))
+                bump(over);
+            if (fraction > 1.0)
+                bump(late);
+        }
+        if (fraction > worst.load(std::memory_order_relaxed))
+            worst.store(fraction, std::memory_order_relaxed);
+    }
+
+    void requestReset() { resetRequested.store(true, std::memory_order_release); }
+
+    // Records above this fraction of the deadline count as over budget
+    void setOverThreshold(double f) { overThreshold.store(f, std::memory_order_relaxed); }
+    double getOverThreshold() const { return overThreshold.load(std::memory_order_relaxed); }
+
+    struct Summary
+    {
+        uint64_t count{0};
+        double p50{0}, p99{0}, max{0}; // fractions of the realtime covered
+        uint64_t over{0};              // above the over threshold, with a deadline
+        uint64_t late{0};              // above the deadline, with a deadline
+    };
+
+    // Any thread. Read while recording, so the totals can be a record apart
+    Summary summary() const
+    {
+        Summary s;
+        std::array<uint64_t, numBins> snap;
+        for (int b = 0; b < numBins; ++b)
+        {
+            snap[b] = counts[b].load(std::memory_order_relaxed);
+            s.count += snap[b];
+        }
+        s.max = worst.load(std::memory_order_relaxed);
+        s.over = over.load(std::memory_order_relaxed);
+        s.late = late.load(std::memory_order_relaxed);
+        if (s.count == 0)
+            return s;
+
+        auto percentile = [&](double q)
+        {
+            auto want = (uint64_t)std::ceil(q * s.count);
+            uint64_t seen{0};
+            for (int b = 0; b < numBins; ++b)
+            {
+                seen += snap[b];
+                if (seen >= want)
+                    return std::min(binTop(b), s.max);
+            }
+            return s.max;
+        };
+        s.p50 = percentile(0.5);
+        s.p99 = percentile(0.99);
+        return s;
+    }
+
+  private:
+    static void bump(std::atomic<uint64_t> &c)
+    {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, numBins> counts{};
+    std::atomic<uint64_t> over{0}, late{0};
+    std::atomic<double> worst{0.0};
+    std::atomic<double> overThreshold{0.8};
+    std::atomic<bool> resetRequested{false};
+};
+
+struct ProcessTiming
+{
+    // Relative block cost: each Synth::process call, against blockSize frames at the
+    // host rate
+    TimingHistogram block{false};
+    // The voice attacks for one note, every unison voice of it, against the same
+    // blockSize frames, since they land inside (or just ahead of) a single block
+    TimingHistogram attack{false};
+    // Each host process call, against its frame count. The only real deadline, so the
+    // only xrun and over budget counts. Only the plugin records these
+    TimingHistogram buffer{true};
+
+    void requestReset()
+    {
+        block.requestReset();
+        attack.requestReset();
+        buffer.requestReset();
+    }
+};
+} // namespace baconpaul::six_sines
+#endif // PROCESS_TIMING_H
@@ -17,12 +17,16 @@
 #include "sst/cpputils/constructors.h"
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "sst/basic-blocks/dsp/PanLaws.h"
+#include "sst/voicemanager/midi1_to_voicemanager.h"
+#include "sst/plugininfra/patch-support/patch_base_clap_adapter.h"
 
 #include "tinyxml/tinyxml.h"
 #include "sst/plugininfra/paths.h"
 
 #include "libMTSClient.h"
 
+#include <new>
+
 namespace baconpaul::six_sines
 {
 
@@ -31,8 +35,8 @@ int debugLevel{0};
 namespace mech = sst::basic_blocks::mechanics;
 namespace sdsp = sst::basic_blocks::dsp;
 
-Synth::Synth(bool mo)
-    : isMultiOut(mo), responder(*this), monoResponder(*this),
+Synth::Synth(bool mo, std::optional<uint32_t> randomSeed)
+    : isMultiOut(mo), responder(*this), monoResponder(*this), monoValues(randomSeed),
       voices(sst::cpputils::make_array<Voice, VMConfig::maxVoiceCount>(patch, monoValues))
 {
     voiceManager = std::make_unique<voiceManager_t>(responder, monoResponder);
@@ -49,8 +53,9 @@ Synth::Synth(bool mo)
     patchMain.dawExtraStateTo = [this](TiXmlElement &e) { toDawExtraState(e, dawStateMain); };
     patchMain.dawExtraStateFrom = [this](TiXmlElement &e) { fromDawExtraState(e, dawStateMain); };
 
-    std::fill(lState.begin(), lState.end(), nullptr);
-    std::fill(rState.begin(), rState.end(), nullptr);
+    std::fill(srcState.begin(), srcState.end(), nullptr);
+
+    mainToAudio.patchSnapshot.prepare(patch.params.size());
 
     // User-defaults reader. Uses the same path/product name as the editor so both share the
     // one preferences file. Construction only reads it; nothing is written here.
@@ -95,6 +100,31 @@ Synth::Synth(bool mo)
     audioDawState = dawStateMain.audio;
     applyAudioDawState(audioDawState);
 
+    // Multi-core voice rendering is opt-in and per machine, so it lives in the user
+    // defaults rather than the session. Changes apply to newly created instances.
+    {
+        auto rt = defaultsProvider->getUserDefaultValue(ui::renderWorkerThreads, 0);
+        auto hw = (int)std::thread::hardware_concurrency();
+        if (hw > 1)
+            rt = std::min(rt, hw - 1);
+        renderPool.start(rt);
+
+        // Render batching trades event timing for throughput, so it is opt-in the same way
+        macroBlocks = std::clamp(defaultsProvider->getUserDefaultValue(ui::macroRenderBlocks, 1),
+                                 1, (int)maxMacroBlocks);
+        srcBatchBlocks = std::clamp(defaultsProvider->getUserDefaultValue(ui::srcBatchBlocks, 1),
+                                    1, (int)maxSRCBatchBlocks);
+        // as is the POLY sine backend, which trades table reads for arithmetic
+        monoValues.polySine = defaultsProvider->getUserDefaultValue(ui::polySineBackend, false);
+    }
+    setVoiceSleepThresholdDb(defaultsProvider->getUserDefaultValue(
+        ui::voiceSleepThresholdDb, defaultVoiceSleepThresholdDb));
+    eventTiming = (EventTiming)std::clamp(
+        defaultsProvider->getUserDefaultValue(ui::eventTiming, (int)BLOCK_EVENTS),
+        (int)BLOCK_EVENTS, (int)SAMPLE_ACCURATE);
+
+    dispatchEvent = [this](auto *e) { handleEvent(e); };
+
     reapplyControlSettings();
     resetSoloState();
 
@@ -128,12 +158,10 @@ Synth::~Synth()
         MTS_DeregisterClient(monoValues.mtsClient);
     }
 
-    for (auto ls : lState)
-        if (ls)
-            src_delete(ls);
-    for (auto rs : rState)
-        if (rs)
-            src_delete(rs);
+    for (auto &modeStates : srcStatePool)
+        for (auto st : modeStates)
+            if (st)
+                src_delete(st);
 }
 
 fs::path Synth::userDocumentsPath()
@@ -227,23 +255,18 @@ void Synth::fromDawExtraState(TiXmlElement &e, DawStateMain &s)
     }
 }
 
-void Synth::setSampleRate(double sampleRate)
+double Synth::engineSampleRateFor(double hostRate, SampleRateStrategy strategy)
 {
-    auto ohsr = hostSampleRate;
-    auto oesr = engineSampleRate;
-
-    hostSampleRate = sampleRate;
     // Look for 44 variants
     bool is441{false};
-    auto hsrBy441 = hostSampleRate / (44100 / 2);
+    auto hsrBy441 = hostRate / (44100 / 2);
     if (std::fabs(hsrBy441 - std::round(hsrBy441)) < 1e-3)
     {
         is441 = true;
     }
 
-    double internalRate{0.f};
     double mul{0.f};
-    switch (sampleRateStrategy)
+    switch (strategy)
     {
     case SR_110120:
     {
@@ -268,15 +291,84 @@ void Synth::setSampleRate(double sampleRate)
     }
 
     if (is441)
-        internalRate = 44100 * mul;
-    else
-        internalRate = 48000 * mul;
+        return 44100 * mul;
+    return 48000 * mul;
+}
+
+void Synth::setSampleRate(double sampleRate)
+{
+    hostSampleRate = sampleRate;
+    sampleRateStrategy = (SampleRateStrategy)patch.output.sampleRateStrategy.value;
+    resamplerEngine = (ResamplerEngine)patch.output.resampleEngine.value;
+    resamplerSwitchPending = false;
+    resamplerFadeBlocks =
+        std::max(8, (int)std::round(resamplerFadeSeconds * hostSampleRate / blockSize));
+    resamplerFadeLevel = resamplerFadeBlocks;
+
+    auto buses = isMultiOut ? 1 + numOps : 1;
+    for (int s = 0; s < numSampleRateStrategies; ++s)
+    {
+        auto esr = (float)engineSampleRateFor(hostSampleRate, (SampleRateStrategy)s);
+        for (int i = 0; i < buses; ++i)
+        {
+            lanczosPool[s][i] = std::make_unique<resampler_t>(esr, (float)hostSampleRate);
+            decimatorPool[s][i] = std::make_unique<PolyphaseDecimator>();
+        }
+        // Designs the coefficients here rather than on first use on the audio thread
+        for (int t = 0; t < PolyphaseDecimator::numTiers; ++t)
+            PolyphaseDecimator::coefficientsFor((SampleRateStrategy)s,
+                                                (PolyphaseDecimator::Tier)t);
+        audioInPool[s] = std::make_unique<audioInResampler_t>((float)hostSampleRate, esr);
+    }
+
+    for (int m = 0; m < numSRCModes; ++m)
+    {
+        auto mode = SRC_SINC_FASTEST;
+        if (m == SRC_MEDIUM)
+        {
+            mode = SRC_SINC_MEDIUM_QUALITY;
+        }
+        else if (m == SRC_BEST)
+        {
+            mode = SRC_SINC_BEST_QUALITY;
+        }
+
+        for (int i = 0; i < buses; ++i)
+        {
+            auto &st = srcStatePool[m][i];
+            if (st)
+            {
+                src_delete(st);
+            }
+            int ec;
+            st = src_new(mode, 2, &ec);
+        }
+    }
+
+    applyEngineSampleRate();
+}
+
+namespace
+{
+// The Lanczos resampler has no reset, but its constructor only sets rates and zeroes its
+// buffers (the shared tables are built once), so rebuilding in place clears it with no
+// allocation.
+template <typename R> void clearResampler(R *r, float inputRate, float outputRate)
+{
+    r->~R();
+    new (r) R(inputRate, outputRate);
+}
+} // namespace
 
-    engineSampleRate = internalRate;
+void Synth::applyEngineSampleRate()
+{
+    engineSampleRate = engineSampleRateFor(hostSampleRate, sampleRateStrategy);
 
-    monoValues.sr.setSampleRate(internalRate);
+    monoValues.sr.setSampleRate(engineSampleRate);
 
     lagHandler.setRate(60, blockSize, monoValues.sr.sampleRate);
+    macroBusPos = 0;
+    macroBusLen = 0;
     vuPeak.setSampleRate(monoValues.sr.sampleRate, 20);
     for (int i = 0; i < numOps; ++i)
     {
@@ -284,48 +376,44 @@ void Synth::setSampleRate(double sampleRate)
     }
     sampleRateRatio = hostSampleRate / engineSampleRate;
 
+    auto buses = isMultiOut ? 1 + numOps : 1;
+    busSleepFrames = (int)(engineSampleRate * busSleepSeconds);
+    clearBusSleep();
+    idleBlocks = 0;
+    idleBlocksNeeded = std::max(1, (int)(hostSampleRate * idleSeconds / blockSize));
+    resetEventClock();
     if (usesLanczos())
     {
-        for (int i = 0; i < (isMultiOut ? (1 + numOps) : 1); ++i)
-            resampler[i] = std::make_unique<resampler_t>((float)monoValues.sr.sampleRate,
-                                                         (float)hostSampleRate);
-    }
-    else
-    {
-        auto mode = SRC_SINC_FASTEST;
-        if (resamplerEngine == SRC_MEDIUM)
+        for (int i = 0; i < buses; ++i)
         {
-            mode = SRC_SINC_MEDIUM_QUALITY;
+            resampler[i] = lanczosPool[sampleRateStrategy][i].get();
+            clearResampler(resampler[i], (float)engineSampleRate, (float)hostSampleRate);
         }
-        else if (resamplerEngine == SRC_BEST)
+    }
+    else if (usesPolyphase())
+    {
+        decimatorTier = wantedDecimatorTier();
+        for (int i = 0; i < buses; ++i)
         {
-            mode = SRC_SINC_BEST_QUALITY;
+            decimator[i] = decimatorPool[sampleRateStrategy][i].get();
+            decimator[i]->reset(
+                PolyphaseDecimator::coefficientsFor(sampleRateStrategy, decimatorTier));
         }
-
-        for (int i = 0; i < (isMultiOut ? (1 + numOps) : 1); ++i)
+    }
+    else
+    {
+        for (int i = 0; i < buses; ++i)
         {
-            if (lState[i])
-            {
-                src_delete(lState[i]);
-            }
-            if (rState[i])
-            {
-                src_delete(rState[i]);
-            }
-            int ec;
-
-            lState[i] = src_new(mode, 1, &ec);
-            rState[i] = src_new(mode, 1, &ec);
-            src_set_ratio(lState[i], sampleRateRatio);
-            src_set_ratio(rState[i], sampleRateRatio);
+            srcState[i] = srcStatePool[resamplerEngine][i];
+            src_reset(srcState[i]);
+            src_set_ratio(srcState[i], sampleRateRatio);
         }
+        clearSRCBatch();
     }
 
-    // (Re)construct the audio-in resampler whenever the sample rate changes.
-    // LanczosResampler constructor zeroes its internal ring buffers, so this
-    // also acts as the "clear on rate change" requirement.
-    audioInResampler =
-        std::make_unique<audioInResampler_t>((float)hostSampleRate, (float)engineSampleRate);
+    // Clear the audio-in resampler whenever the sample rate changes.
+    audioInResampler = audioInPool[sampleRateStrategy].get();
+    clearResampler(audioInResampler, (float)hostSampleRate, (float)engineSampleRate);
 
     for (auto &[i, p] : patch.paramMap)
     {
@@ -346,17 +434,103 @@ void Synth::setSampleRate(double sampleRate)
         {AudioToMainMsg::SEND_SAMPLE_RATE, 0, (float)hostSampleRate, (float)engineSampleRate});
 
     // Refresh anything keyed off engineSampleRate (filter coefs, ZOH ratio).
-    // Safe vs. recursion: reapplyControlSettings only re-enters setSampleRate
+    // Safe vs. recursion: reapplyControlSettings only re-enters applyEngineSampleRate
     // when sampleRateStrategy diverges from the patch, which it doesn't here.
     reapplyControlSettings();
 }
 
+void Synth::advanceMonoBlock(bool op1IsAudioIn)
+{
+    lagHandler.process();
+
+    // Hoist mono unison params so per-voice renderBlock derives uniRatioMul / uniPanShift
+    // from the smoothed scalars without each voice repeating the twoToTheX lookup.
+    monoValues.unisonSpreadFactorMinus1 =
+        monoValues.twoToTheX.twoToThe(patch.output.unisonSpread.value) - 1.f;
+    monoValues.unisonPanScalar = patch.output.unisonPan.value;
+
+    if (audioInResampler && op1IsAudioIn)
+    {
+        float aiL[blockSize]{}, aiR[blockSize]{};
+        auto got = (int)audioInResampler->populateNext(aiL, aiR, blockSize);
+        for (int i = 0; i < blockSize; ++i)
+            monoValues.audioInBlock[i] = (i < got) ? (aiL[i] + aiR[i]) * 0.5f : 0.f;
+    }
+    else
+    {
+        memset(monoValues.audioInBlock, 0, sizeof(monoValues.audioInBlock));
+    }
+
+    if (portaContinuation.updateEveryBlock && portaContinuation.active)
+    {
+        portaContinuation.portaFrac += portaContinuation.dPortaFrac;
+        portaContinuation.sourceKey += portaContinuation.dKey;
+        if (portaContinuation.portaFrac >= 1.0)
+        {
+            portaContinuation.active = false;
+            portaContinuation.updateEveryBlock = false;
+        }
+    }
+}
+
+void Synth::renderMacroBlock(int subBlocks)
+{
+    // The mono state steps once per block as it would in single block rendering; the
+    // voices then see where it ended up for the whole macro-block.
+    for (int j = 0; j < subBlocks; ++j)
+        advanceMonoBlock(false);
+
+    Voice *renderList[maxVoices];
+    size_t renderCount{0};
+    for (auto v = head; v; v = v->next)
+        renderList[renderCount++] = v;
+    renderPool.render(renderList, renderCount, voicePackRendering, subBlocks);
+
+    memset(macroBus, 0, sizeof(macroBus));
+    auto cvoice = head;
+    Voice *removeVoice{nullptr};
+    while (cvoice)
+    {
+        assert(cvoice->used);
+
+        // A voice that ended part way wrote fewer blocks; the rest of its span is silent
+        auto ns = cvoice->macroRendered * (int)blockSize;
+        for (int c = 0; c < 2; ++c)
+        {
+            for (int i = 0; i < ns; ++i)
+                macroBus[c][i] += cvoice->macroOutput[c][i];
+        }
+
+        if (cvoice->macroEnded)
+        {
+            auto rvoice = cvoice;
+            cvoice = removeFromVoiceList(cvoice);
+            rvoice->next = removeVoice;
+            removeVoice = rvoice;
+        }
+        else
+        {
+            cvoice = cvoice->next;
+        }
+    }
+
+    while (removeVoice)
+    {
+        responder.doVoiceEndCallback(removeVoice);
+        auto v = removeVoice;
+        removeVoice = removeVoice->next;
+        v->next = nullptr;
+        assert(!v->next && !v->prior);
+    }
+
+    macroBusPos = 0;
+    macroBusLen = subBlocks;
+}
+
 template <bool multiOut> void Synth::processInternal(const clap_output_events_t *outq)
 {
     auto start = std::chrono::high_resolution_clock::now();
-    if (!SinTable::staticsInitialized)
-        SinTable::initializeStatics();
-
+    node_profiler::Session profile(monoValues.nodeProfile);
     processUIQueue(outq);
 
     if (!audioRunning)
@@ -395,172 +569,206 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
 
     int loops{0};
 
-    SRC_DATA d;
-
     int generated{0};
 
     if (usesLanczos())
         generated = (resampler[0]->inputsRequiredToGenerateOutputs(blockSize) > 0 ? 0 : blockSize);
+    else if (usesPolyphase())
+        generated = (decimator[0]->inputsRequiredToGenerateOutputs(blockSize) > 0 ? 0 : blockSize);
+    else
+        generated = srcOutFrames - srcOutPos;
 
     std::array<bool, numOps> mixerActive;
-    if constexpr (multiOut)
-    {
-        std::fill(mixerActive.begin(), mixerActive.end(), false);
-    }
 
     while (generated < blockSize)
     {
         loops++;
-        lagHandler.process();
 
-        // Hoist mono unison params so per-voice renderBlock derives uniRatioMul / uniPanShift
-        // from the smoothed scalars without each voice repeating the twoToTheX lookup.
-        monoValues.unisonSpreadFactorMinus1 =
-            monoValues.twoToTheX.twoToThe(patch.output.unisonSpread.value) - 1.f;
-        monoValues.unisonPanScalar = patch.output.unisonPan.value;
+        if (scheduledBegin != scheduledEnd)
+            dispatchScheduledEvents();
+
+        if constexpr (multiOut)
+        {
+            std::fill(mixerActive.begin(), mixerActive.end(), false);
+        }
+
+        float lOutput alignas(16)[2 * (1 + (multiOut ? numOps : 0))][blockSize];
+        memset(lOutput, 0, sizeof(lOutput));
 
         auto op1IsAudioIn =
             ((int)std::round(patch.sourceNodes[0].waveForm.value) == SinTable::AUDIO_IN);
-        if (audioInResampler && op1IsAudioIn)
+        auto subBlocks = (multiOut || op1IsAudioIn || sampleAccurateEvents())
+                             ? 1
+                             : std::clamp(macroBlocks, 1, (int)maxMacroBlocks);
+
+        if (macroBusPos >= macroBusLen && subBlocks > 1)
+            renderMacroBlock(subBlocks);
+
+        if (macroBusPos < macroBusLen)
         {
-            float aiL[blockSize]{}, aiR[blockSize]{};
-            auto got = (int)audioInResampler->populateNext(aiL, aiR, blockSize);
-            for (int i = 0; i < blockSize; ++i)
-                monoValues.audioInBlock[i] = (i < got) ? (aiL[i] + aiR[i]) * 0.5f : 0.f;
+            memcpy(lOutput[0], &macroBus[0][macroBusPos * blockSize], sizeof(lOutput[0]));
+            memcpy(lOutput[1], &macroBus[1][macroBusPos * blockSize], sizeof(lOutput[1]));
+            macroBusPos++;
         }
         else
         {
-            memset(monoValues.audioInBlock, 0, sizeof(monoValues.audioInBlock));
-        }
+            advanceMonoBlock(op1IsAudioIn);
 
-        if (portaContinuation.updateEveryBlock && portaContinuation.active)
-        {
-            portaContinuation.portaFrac += portaContinuation.dPortaFrac;
-            portaContinuation.sourceKey += portaContinuation.dKey;
-            if (portaContinuation.portaFrac >= 1.0)
             {
-                portaContinuation.active = false;
-                portaContinuation.updateEveryBlock = false;
+                // Voices render first (on the pool workers too, if there are any), then get
+                // summed below in list order on this thread so the mix is order-independent.
+                Voice *renderList[maxVoices];
+                size_t renderCount{0};
+                for (auto v = head; v; v = v->next)
+                    renderList[renderCount++] = v;
+                renderPool.render(renderList, renderCount, voicePackRendering);
             }
-        }
 
-        float lOutput alignas(16)[2 * (1 + (multiOut ? numOps : 0))][blockSize];
-        memset(lOutput, 0, sizeof(lOutput));
+            auto cvoice = head;
+            Voice *removeVoice{nullptr};
 
-        auto cvoice = head;
-        Voice *removeVoice{nullptr};
+            while (cvoice)
+            {
+                assert(cvoice->used);
 
-        while (cvoice)
-        {
-            assert(cvoice->used);
-            cvoice->renderBlock();
+                if (cvoice->startDelay)
+                    cvoice->applyStartDelay();
 
-            mech::accumulate_from_to<blockSize>(cvoice->output[0], lOutput[0]);
-            mech::accumulate_from_to<blockSize>(cvoice->output[1], lOutput[1]);
+                mech::accumulate_from_to<blockSize>(cvoice->output[0], lOutput[0]);
+                mech::accumulate_from_to<blockSize>(cvoice->output[1], lOutput[1]);
 
-            if constexpr (multiOut)
-            {
-                // TODO if voice active check
-                float stp[2][blockSize];
-                for (int i = 0; i < numOps; ++i)
+                if constexpr (multiOut)
                 {
-                    if (!cvoice->mixerNode[i].active)
+                    // TODO if voice active check
+                    float stp[2][blockSize];
+                    for (int i = 0; i < numOps; ++i)
                     {
-                        continue;
+                        if (!cvoice->mixerNode[i].active)
+                        {
+                            continue;
+                        }
+                        if (!cvoice->mixerNode[i].from.operatorOutputsToOp)
+                        {
+                            continue;
+                        }
+                        mixerActive[i] = true;
+                        mech::mul_block<blockSize>(cvoice->out.finalEnvLevel,
+                                                   cvoice->mixerNode[i].output[0], stp[0]);
+                        mech::mul_block<blockSize>(cvoice->out.finalEnvLevel,
+                                                   cvoice->mixerNode[i].output[1], stp[1]);
+                        mech::accumulate_from_to<blockSize>(stp[0], lOutput[2 + 2 * i]);
+                        mech::accumulate_from_to<blockSize>(stp[1], lOutput[2 + 2 * i + 1]);
                     }
-                    if (!cvoice->mixerNode[i].from.operatorOutputsToOp)
-                    {
-                        continue;
-                    }
-                    mixerActive[i] = true;
-                    mech::mul_block<blockSize>(cvoice->out.finalEnvLevel,
-                                               cvoice->mixerNode[i].output[0], stp[0]);
-                    mech::mul_block<blockSize>(cvoice->out.finalEnvLevel,
-                                               cvoice->mixerNode[i].output[1], stp[1]);
-                    mech::accumulate_from_to<blockSize>(stp[0], lOutput[2 + 2 * i]);
-                    mech::accumulate_from_to<blockSize>(stp[1], lOutput[2 + 2 * i + 1]);
                 }
-            }
 
-            if (cvoice->out.env.stage > OutputNode::env_t::s_release || cvoice->fadeBlocks == 0)
-            {
-                auto rvoice = cvoice;
-                cvoice = removeFromVoiceList(cvoice);
-                rvoice->next = removeVoice;
-                removeVoice = rvoice;
+                if (cvoice->isFinished())
+                {
+                    auto rvoice = cvoice;
+                    cvoice = removeFromVoiceList(cvoice);
+                    rvoice->next = removeVoice;
+                    removeVoice = rvoice;
+                }
+                else
+                {
+                    cvoice = cvoice->next;
+                }
             }
-            else
+
+            while (removeVoice)
             {
-                cvoice = cvoice->next;
+                responder.doVoiceEndCallback(removeVoice);
+                auto v = removeVoice;
+                removeVoice = removeVoice->next;
+                v->next = nullptr;
+                assert(!v->next && !v->prior);
             }
         }
 
-        while (removeVoice)
-        {
-            responder.doVoiceEndCallback(removeVoice);
-            auto v = removeVoice;
-            removeVoice = removeVoice->next;
-            v->next = nullptr;
-            assert(!v->next && !v->prior);
-        }
-
         // End-of-chain stages run on the main engine-rate stereo bus,
         // before downsampling. Per-op buses in multiOut are not processed yet.
         processEndOfBlock(lOutput[0], lOutput[1]);
 
-        if (usesLanczos())
+        if constexpr (multiOut)
+        {
+            // Wake before anything is pushed this block, so a waking bus takes the main
+            // bus's resampler clock from before this block's input
+            for (int i = 0; i < numOps; ++i)
+            {
+                if (mixerActive[i])
+                {
+                    busQuietFrames[i + 1] = 0;
+                    if (busAsleep[i + 1])
+                        wakeBus(i + 1);
+                }
+                else if (!busAsleep[i + 1])
+                {
+                    busQuietFrames[i + 1] += blockSize;
+                }
+            }
+        }
+
         {
-            if constexpr (multiOut)
+            node_profiler::Scope rsProfile(node_profiler::RESAMPLER);
+            if (usesLanczos())
             {
-                for (int rsi = 0; rsi < numOps + 1; ++rsi)
+                if constexpr (multiOut)
+                {
+                    for (int rsi = 0; rsi < numOps + 1; ++rsi)
+                    {
+                        if (busAsleep[rsi])
+                            continue;
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            resampler[rsi]->push(lOutput[rsi * 2][i], lOutput[rsi * 2 + 1][i]);
+                        }
+                    }
+                }
+                else
                 {
                     for (int i = 0; i < blockSize; ++i)
                     {
-                        resampler[rsi]->push(lOutput[rsi * 2][i], lOutput[rsi * 2 + 1][i]);
+                        resampler[0]->push(lOutput[0][i], lOutput[1][i]);
                     }
                 }
+                generated =
+                    (resampler[0]->inputsRequiredToGenerateOutputs(blockSize) > 0 ? 0 : blockSize);
+            }
+            else if (usesPolyphase())
+            {
+                for (int rsi = 0; rsi < (multiOut ? (numOps + 1) : 1); ++rsi)
+                    if (!busAsleep[rsi])
+                        decimator[rsi]->pushBlock(lOutput[rsi * 2], lOutput[rsi * 2 + 1]);
+                generated =
+                    (decimator[0]->inputsRequiredToGenerateOutputs(blockSize) > 0 ? 0 : blockSize);
             }
             else
             {
-                for (int i = 0; i < blockSize; ++i)
+                for (int rsi = 0; rsi < (multiOut ? (numOps + 1) : 1); ++rsi)
                 {
-                    resampler[0]->push(lOutput[0][i], lOutput[1][i]);
+                    auto *in = srcIn[rsi] + 2 * srcInFrames;
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        in[2 * i] = lOutput[2 * rsi][i];
+                        in[2 * i + 1] = lOutput[2 * rsi + 1][i];
+                    }
                 }
+                srcInFrames += blockSize;
+
+                // A macro-block pass already delivers its blocks together, so resample
+                // them in one call too
+                auto batch = std::clamp(std::max(srcBatchBlocks, subBlocks), 1,
+                                        (int)maxSRCBatchBlocks);
+                if (srcInFrames >= batch * (int)blockSize)
+                    processSRCBatch<multiOut>();
+                generated = srcOutFrames - srcOutPos;
             }
-            generated =
-                (resampler[0]->inputsRequiredToGenerateOutputs(blockSize) > 0 ? 0 : blockSize);
         }
-        else
+
+        if constexpr (multiOut)
         {
-            int gen0{0};
-            for (int rsi = 0; rsi < (multiOut ? (numOps + 1) : 1); ++rsi)
-            {
-                d.data_in = lOutput[2 * rsi];
-                d.data_out = output[2 * rsi] + generated;
-                d.input_frames = blockSize;
-                d.output_frames = blockSize - generated;
-                d.end_of_input = 0;
-                d.src_ratio = sampleRateRatio;
-
-                src_process(lState[rsi], &d);
-                auto lgen = d.output_frames_gen;
-
-                d.data_in = lOutput[2 * rsi + 1];
-                d.data_out = output[2 * rsi + 1] + generated;
-                d.input_frames = blockSize;
-                d.output_frames = blockSize - generated;
-                d.end_of_input = 0;
-                d.src_ratio = sampleRateRatio;
-
-                src_process(rState[rsi], &d);
-                auto rgen = d.output_frames_gen;
-                assert(lgen == rgen);
-                if (rsi == 0)
-                {
-                    gen0 = lgen;
-                }
-            }
-            generated += gen0;
+            for (int rsi = 1; rsi < numOps + 1; ++rsi)
+                if (busQuietFrames[rsi] >= busSleepFrames)
+                    busAsleep[rsi] = true;
         }
 
         if (editorActive.load(std::memory_order_relaxed))
@@ -618,6 +826,9 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
                 AudioToMainMsg msg4{AudioToMainMsg::MTS_POINTER, 0, 0, 0, monoValues.mtsClient};
                 audioToMain.push(msg4);
 
+                if constexpr (node_profiler::enabled)
+                    pushNodeProfile();
+
                 lastVuUpdate = 0;
             }
             else
@@ -625,57 +836,136 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
                 lastVuUpdate++;
             }
         }
+
+        engineSamplesRendered += blockSize;
     }
 
-    if (resamplerEngine == LANCZOS)
+    hostSamplesProcessed += blockSize;
+    if (eventLatency < 0)
     {
-        if constexpr (multiOut)
+        // How far the engine runs ahead of the host, plus room for it to wander by a block
+        // and for an event up to a block before the host block it was scheduled from
+        auto q = engineSampleRate / hostSampleRate;
+        eventLatency = engineSamplesRendered - (int64_t)std::floor(hostSamplesProcessed * q) +
+                       blockSize + (int64_t)std::ceil(blockSize * q);
+    }
+
+    if constexpr (multiOut)
+    {
+        for (int rsi = 1; rsi < numOps + 1; ++rsi)
         {
-            for (int rsi = 0; rsi < numOps + 1; ++rsi)
+            if (busAsleep[rsi])
             {
-                resampler[rsi]->populateNextBlockSize(output[rsi * 2], output[rsi * 2 + 1]);
-                resampler[rsi]->renormalizePhases();
+                memset(output[2 * rsi], 0, sizeof(output[2 * rsi]));
+                memset(output[2 * rsi + 1], 0, sizeof(output[2 * rsi + 1]));
             }
         }
-        else
-        {
-            resampler[0]->populateNextBlockSize(output[0], output[1]);
-            resampler[0]->renormalizePhases();
-        }
     }
-    if (resamplerEngine == ZOH)
+
     {
-        if constexpr (multiOut)
+        node_profiler::Scope rsProfile(node_profiler::RESAMPLER);
+        if (resamplerEngine == LANCZOS)
         {
-            for (int rsi = 0; rsi < numOps + 1; ++rsi)
+            if constexpr (multiOut)
             {
-                resampler[rsi]->populateNextBlockSizeZOH(output[rsi * 2], output[rsi * 2 + 1]);
-                resampler[rsi]->renormalizePhases();
+                for (int rsi = 0; rsi < numOps + 1; ++rsi)
+                {
+                    if (busAsleep[rsi])
+                        continue;
+                    resampler[rsi]->populateNextBlockSize(output[rsi * 2], output[rsi * 2 + 1]);
+                    resampler[rsi]->renormalizePhases();
+                }
+            }
+            else
+            {
+                resampler[0]->populateNextBlockSize(output[0], output[1]);
+                resampler[0]->renormalizePhases();
             }
         }
-        else
+        if (resamplerEngine == ZOH)
         {
-            resampler[0]->populateNextBlockSizeZOH(output[0], output[1]);
-            resampler[0]->renormalizePhases();
+            if constexpr (multiOut)
+            {
+                for (int rsi = 0; rsi < numOps + 1; ++rsi)
+                {
+                    if (busAsleep[rsi])
+                        continue;
+                    resampler[rsi]->populateNextBlockSizeZOH(output[rsi * 2], output[rsi * 2 + 1]);
+                    resampler[rsi]->renormalizePhases();
+                }
+            }
+            else
+            {
+                resampler[0]->populateNextBlockSizeZOH(output[0], output[1]);
+                resampler[0]->renormalizePhases();
+            }
         }
-    }
-    if (resamplerEngine == LINTERP)
-    {
-        if constexpr (multiOut)
+        if (resamplerEngine == LINTERP)
         {
-            for (int rsi = 0; rsi < numOps + 1; ++rsi)
+            if constexpr (multiOut)
             {
-                resampler[rsi]->populateNextBlockSizeLin(output[rsi * 2], output[rsi * 2 + 1]);
-                resampler[rsi]->renormalizePhases();
+                for (int rsi = 0; rsi < numOps + 1; ++rsi)
+                {
+                    if (busAsleep[rsi])
+                        continue;
+                    resampler[rsi]->populateNextBlockSizeLin(output[rsi * 2], output[rsi * 2 + 1]);
+                    resampler[rsi]->renormalizePhases();
+                }
+            }
+            else
+            {
+                resampler[0]->populateNextBlockSizeLin(output[0], output[1]);
+                resampler[0]->renormalizePhases();
             }
         }
-        else
+
+        if (usesPolyphase())
+        {
+            for (int rsi = 0; rsi < (multiOut ? (numOps + 1) : 1); ++rsi)
+                if (!busAsleep[rsi])
+                    decimator[rsi]->populateNextBlockSize(output[rsi * 2], output[rsi * 2 + 1]);
+        }
+        else if (!usesLanczos())
         {
-            resampler[0]->populateNextBlockSizeLin(output[0], output[1]);
-            resampler[0]->renormalizePhases();
+            for (int rsi = 0; rsi < (multiOut ? (numOps + 1) : 1); ++rsi)
+            {
+                auto *out = srcOut[rsi] + 2 * srcOutPos;
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    output[2 * rsi][i] = out[2 * i];
+                    output[2 * rsi + 1][i] = out[2 * i + 1];
+                }
+            }
+            srcOutPos += blockSize;
         }
     }
 
+    if (resamplerSwitchPending || resamplerFadeLevel < resamplerFadeBlocks)
+        processResamplerFade<multiOut>();
+
+    auto quiet = head == nullptr;
+    for (int c = 0; quiet && c < 2 * (1 + (multiOut ? numOps : 0)); ++c)
+        for (int i = 0; i < blockSize; ++i)
+            quiet = quiet && std::fabs(output[c][i]) < idleThreshold;
+    if (!quiet)
+        idleBlocks = 0;
+    else if (idleBlocks < idleBlocksNeeded)
+        idleBlocks++;
+
+    // Silent, so the decimators can take up a new tier without anyone hearing it
+    if (idleBlocks >= idleBlocksNeeded && usesPolyphase() && !resamplerSwitchPending &&
+        wantedDecimatorTier() != decimatorTier)
+    {
+        decimatorTier = wantedDecimatorTier();
+        for (int i = 0; i < (multiOut ? 1 + numOps : 1); ++i)
+            decimator[i]->retier(
+                PolyphaseDecimator::coefficientsFor(sampleRateStrategy, decimatorTier));
+        reapplyEndStages();
+    }
+
+    auto pct = blockRealtimeUsed(start);
+    processTiming.block.record(pct);
+
     if (editorActive.load(std::memory_order_relaxed))
     {
         // Tap host-SR main bus for visualizers (only when someone is listening).
@@ -685,16 +975,219 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
         }
 
         // Finish CPU calculation
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-        auto micros = duration.count();
-        auto availmicrosinv = hostSampleRate * 1e-9 / blockSize;
-        auto pct = micros * availmicrosinv;
         auto cpuFac = 0.995;
         cpuUsage = cpuUsage * cpuFac + pct * (1 - cpuFac);
     }
 }
 
+void Synth::pushNodeProfile()
+{
+    uint64_t t[node_profiler::numCategories], total{0};
+    for (uint32_t i = 0; i < node_profiler::numCategories; ++i)
+    {
+        t[i] = monoValues.nodeProfile.ticks[i].exchange(0, std::memory_order_relaxed);
+        total += t[i];
+    }
+    if (total == 0)
+        return;
+
+    for (uint32_t i = 0; i < node_profiler::numCategories; ++i)
+    {
+        AudioToMainMsg msg{AudioToMainMsg::UPDATE_NODE_PROFILE, i, (float)(100.0 * t[i] / total)};
+        audioToMain.push(msg);
+    }
+}
+
+void Synth::scheduleEvent(const clap_event_header_t *e, int32_t hostOffset)
+{
+    auto next = (scheduledEnd + 1) % maxScheduledEvents;
+    if (next == scheduledBegin || e->size > sizeof(ScheduledEvent::event))
+    {
+        // No room, or an event type we don't keep, so it goes in now and on the block
+        if (dispatchEvent)
+            dispatchEvent(e);
+        return;
+    }
+
+    auto &se = scheduledEvents[scheduledEnd];
+    if (eventLatency < 0)
+    {
+        // Until the first block has measured the latency, events go at the next engine block
+        se.engineSample = 0;
+    }
+    else
+    {
+        auto hostSample = std::max((int64_t)0, hostSamplesProcessed + hostOffset);
+        se.engineSample =
+            (int64_t)std::floor(hostSample * engineSampleRate / hostSampleRate) + eventLatency;
+    }
+    memcpy(&se.event, e, e->size);
+    scheduledEnd = next;
+}
+
+void Synth::dispatchScheduledEvents()
+{
+    while (scheduledBegin != scheduledEnd)
+    {
+        auto &se = scheduledEvents[scheduledBegin];
+        auto offset = se.engineSample - engineSamplesRendered;
+        if (offset >= (int64_t)blockSize)
+            break;
+
+        voiceStartDelay = (int)std::max((int64_t)0, offset);
+        if (dispatchEvent)
+            dispatchEvent(&se.event.header);
+        scheduledBegin = (scheduledBegin + 1) % maxScheduledEvents;
+    }
+    voiceStartDelay = 0;
+}
+
+void Synth::resetEventClock()
+{
+    hostSamplesProcessed = 0;
+    engineSamplesRendered = 0;
+    eventLatency = -1;
+    // Anything still waiting was timed against the old clock, so let it go straight away
+    for (auto i = scheduledBegin; i != scheduledEnd; i = (i + 1) % maxScheduledEvents)
+        scheduledEvents[i].engineSample = 0;
+}
+
+template <bool multiOut> void Synth::processSRCBatch()
+{
+    // Slide the undrained output (less than a host block) to the front to make room
+    auto left = srcOutFrames - srcOutPos;
+    if (srcOutPos > 0)
+    {
+        for (int rsi = 0; rsi < (multiOut ? (numOps + 1) : 1); ++rsi)
+            memmove(srcOut[rsi], srcOut[rsi] + 2 * srcOutPos, 2 * left * sizeof(float));
+        srcOutPos = 0;
+        srcOutFrames = left;
+    }
+
+    SRC_DATA d;
+    int gen0{0};
+    for (int rsi = 0; rsi < (multiOut ? (numOps + 1) : 1); ++rsi)
+    {
+        auto *out = srcOut[rsi] + 2 * srcOutFrames;
+        if (busAsleep[rsi])
+        {
+            memset(out, 0, 2 * gen0 * sizeof(float));
+            continue;
+        }
+
+        int gen{0};
+        if (srcBusWaking[rsi])
+        {
+            srcBusWaking[rsi] = false;
+            src_reset(srcState[rsi]);
+            src_set_ratio(srcState[rsi], sampleRateRatio);
+
+            // The main bus's outputs fall every M / L inputs from the last reset. Lead in
+            // with enough silence that the woken state's first output lands on that grid.
+            int L, M;
+            PolyphaseDecimator::ratioFor(sampleRateStrategy, L, M);
+            static constexpr float zeros[2 * 8]{};
+            d.data_in = zeros;
+            d.data_out = out;
+            d.input_frames = (long)(srcFramesIn % M);
+            d.output_frames = srcOutCapacity - srcOutFrames;
+            d.end_of_input = 0;
+            d.src_ratio = sampleRateRatio;
+            src_process(srcState[rsi], &d);
+            gen = d.output_frames_gen;
+        }
+
+        d.data_in = srcIn[rsi];
+        d.data_out = out + 2 * gen;
+        d.input_frames = srcInFrames;
+        d.output_frames = srcOutCapacity - srcOutFrames - gen;
+        d.end_of_input = 0;
+        d.src_ratio = sampleRateRatio;
+
+        src_process(srcState[rsi], &d);
+        // Output room is at least the input, and we only ever downsample, so it all goes in
+        assert(d.input_frames_used == srcInFrames);
+        gen += d.output_frames_gen;
+        if (rsi == 0)
+        {
+            gen0 = gen;
+        }
+        else if (gen < gen0)
+        {
+            // A woken state holds back its filter latency, which the main bus emitted
+            // long ago. It was silent then, so pad the front with zeros to stay in step.
+            auto lag = gen0 - gen;
+            memmove(out + 2 * lag, out, 2 * gen * sizeof(float));
+            memset(out, 0, 2 * lag * sizeof(float));
+        }
+        assert(gen <= gen0);
+    }
+    srcFramesIn += srcInFrames;
+    srcInFrames = 0;
+    srcOutFrames += gen0;
+}
+
+void Synth::wakeBus(int rsi)
+{
+    busAsleep[rsi] = false;
+    if (usesLanczos())
+    {
+        // Every bus resampler runs the same rates, so the main bus's copy with the history
+        // cleared is this bus as if it had been pushed silence all along
+        *resampler[rsi] = *resampler[0];
+        memset(resampler[rsi]->input, 0, sizeof(resampler[rsi]->input));
+    }
+    else if (usesPolyphase())
+    {
+        decimator[rsi]->syncClockTo(*decimator[0]);
+    }
+    else
+    {
+        srcBusWaking[rsi] = true;
+    }
+}
+
+template <bool multiOut> void Synth::processResamplerFade()
+{
+    auto from = resamplerFadeLevel;
+    auto to = resamplerSwitchPending ? from - 1 : from + 1;
+    auto g0 = (float)from / resamplerFadeBlocks;
+    auto dg = (float)(to - from) / (resamplerFadeBlocks * blockSize);
+    for (int c = 0; c < 2 * (1 + (multiOut ? numOps : 0)); ++c)
+    {
+        for (int i = 0; i < blockSize; ++i)
+            output[c][i] *= g0 + dg * (i + 1);
+    }
+    resamplerFadeLevel = to;
+
+    if (resamplerSwitchPending && resamplerFadeLevel == 0)
+    {
+        resamplerSwitchPending = false;
+
+        auto newStrategy = (SampleRateStrategy)patch.output.sampleRateStrategy.value;
+        auto newEngine = (ResamplerEngine)patch.output.resampleEngine.value;
+        if (newStrategy == sampleRateStrategy && newEngine == resamplerEngine)
+            return;
+
+        // Voices latch the engine rate at attack, so only a rate change needs them gone.
+        // The output is silent here, so drop them now rather than letting them fade out
+        // mistuned under the fade in.
+        if (engineSampleRateFor(hostSampleRate, newStrategy) != engineSampleRate)
+        {
+            voiceManager->allSoundsOff();
+            while (head)
+            {
+                auto v = head;
+                removeFromVoiceList(v);
+                responder.doVoiceEndCallback(v);
+            }
+        }
+        sampleRateStrategy = newStrategy;
+        resamplerEngine = newEngine;
+        applyEngineSampleRate();
+    }
+}
+
 void Synth::process(const clap_output_events_t *o)
 {
     if (isMultiOut)
@@ -790,6 +1283,11 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
         case MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING:
         case MainToAudioMsg::SET_PARAM:
         {
+            // Queued before a load whose snapshot was already adopted early; that snapshot
+            // holds this edit, or the load replaced it
+            if ((int32_t)(patchSnapshotHeld - patchSnapshotMarkerSeen) > 0)
+                break;
+
             bool notify = uiM->action == MainToAudioMsg::SET_PARAM;
 
             auto dest = patch.paramMap.at(uiM->paramId);
@@ -861,6 +1359,8 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
             if (lagHandler.active)
                 lagHandler.instantlySnap();
             voiceManager->allSoundsOff();
+            macroBusPos = 0;
+            macroBusLen = 0;
             audioRunning = false;
         }
         break;
@@ -877,6 +1377,31 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
             pendingRescan |= RescanRequest::VALUES;
         }
         break;
+        case MainToAudioMsg::ADOPT_PATCH_SNAPSHOT:
+        {
+            // A later load may already have replaced the snapshot this was queued for, in
+            // which case the first marker adopts the newest values, the param messages up to
+            // that snapshot's own marker are skipped, and the markers find nothing
+            patchSnapshotMarkerSeen = uiM->paramId;
+            auto *values = mainToAudio.patchSnapshot.adopt();
+            if (values)
+            {
+                patchSnapshotHeld = mainToAudio.patchSnapshot.adoptedSequence();
+                if (lagHandler.active)
+                    lagHandler.instantlySnap();
+                voiceManager->allSoundsOff();
+                macroBusPos = 0;
+                macroBusLen = 0;
+
+                auto n = std::min(values->size(), patch.params.size());
+                for (size_t i = 0; i < n; ++i)
+                    patch.params[i]->value = (*values)[i];
+
+                postLoad();
+                pendingRescan |= RescanRequest::VALUES;
+            }
+        }
+        break;
         case MainToAudioMsg::PANIC_STOP_VOICES:
         {
             voiceManager->allSoundsOff();
@@ -889,6 +1414,17 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
             monoValues.designModeRunAll = uiM->value > 0.5;
         }
         break;
+        case MainToAudioMsg::SET_VOICE_SLEEP_THRESHOLD:
+        {
+            setVoiceSleepThresholdDb(uiM->value);
+        }
+        break;
+        case MainToAudioMsg::SET_EVENT_TIMING:
+        {
+            eventTiming = (EventTiming)std::clamp((int)uiM->value, (int)BLOCK_EVENTS,
+                                                  (int)SAMPLE_ACCURATE);
+        }
+        break;
         case MainToAudioMsg::SET_AUDIO_DAW_STATE:
         {
             // The queue is the only main->audio channel for this: store the value-carried copy
@@ -907,18 +1443,40 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
         requestParamRescan(pendingRescan);
 }
 
+bool Synth::endChainIsLinear() const
+{
+    return (int)std::round(patch.output.saturationType.value) == SAT_NONE &&
+           (int)std::round(patch.output.bitRateAdjust.value) == BR_NONE &&
+           (int)std::round(patch.output.bitDepthAdjust.value) == BD_NONE;
+}
+
+PolyphaseDecimator::Tier Synth::wantedDecimatorTier() const
+{
+    if (resamplerEngine == POLYPHASE_HQ || patch.output.ultrasonicFilter.value > 0.5)
+        return PolyphaseDecimator::HQ;
+    return PolyphaseDecimator::STANDARD;
+}
+
 void Synth::reapplyControlSettings()
 {
     if (sampleRateStrategy != (SampleRateStrategy)patch.output.sampleRateStrategy.value ||
         resamplerEngine != (ResamplerEngine)patch.output.resampleEngine.value)
     {
-        sampleRateStrategy = (SampleRateStrategy)patch.output.sampleRateStrategy.value;
-        resamplerEngine = (ResamplerEngine)patch.output.resampleEngine.value;
-
-        if (hostSampleRate > 0)
+        if (hostSampleRate > 0 && audioRunning)
         {
-            voiceManager->allSoundsOff();
-            setSampleRate(hostSampleRate);
+            // processResamplerFade reads the new settings from the patch once it is silent
+            resamplerSwitchPending = true;
+        }
+        else
+        {
+            sampleRateStrategy = (SampleRateStrategy)patch.output.sampleRateStrategy.value;
+            resamplerEngine = (ResamplerEngine)patch.output.resampleEngine.value;
+
+            if (hostSampleRate > 0)
+            {
+                voiceManager->allSoundsOff();
+                applyEngineSampleRate();
+            }
         }
     }
 
@@ -1065,6 +1623,26 @@ void Synth::reapplyControlSettings()
         hpFilter.setCutoffAndSampleRate(freq, sr);
         hpFilter.reset();
     }
+
+    reapplyEndStages();
+}
+
+void Synth::reapplyEndStages()
+{
+    auto bits = 0;
+    switch ((int)std::round(patch.output.bitDepthAdjust.value))
+    {
+    case BD_8:
+        bits = 8;
+        break;
+    case BD_12:
+        bits = 12;
+        break;
+    case BD_16:
+        bits = 16;
+        break;
+    }
+    rebuildEndStages((int)std::round(patch.output.saturationType.value), bits);
 }
 
 void Synth::applyMpeState()
@@ -1088,83 +1666,153 @@ void Synth::applySmoothingTimes()
 
 void Synth::processEndOfBlock(float *L, float *R)
 {
-    if (ultrasonicActive)
-        ultrasonicFilter.processBlock(L, R, blockSize);
+    node_profiler::Scope profile(node_profiler::END_OF_CHAIN);
 
-    auto satType = (int)std::round(patch.output.saturationType.value);
-    if (satType != SAT_NONE)
+    // The continuous params are read once a block; the modes are in the stage list
+    output_shaper::Params sp;
+    if (endSaturates)
     {
         auto dv = patch.output.saturationDrive.value;
-        auto drive = dv * dv * dv;
-        if (satType == SAT_SOFT)
-        {
-            for (int i = 0; i < blockSize; ++i)
-            {
-                L[i] = softSaturator(L[i] * drive);
-                R[i] = softSaturator(R[i] * drive);
-            }
-        }
-        else if (satType == SAT_OJD)
+        sp.drive = dv * dv * dv;
+    }
+    sp.scale = endCrushScale;
+    sp.invScale = 1.f / endCrushScale;
+    // Output gain: param value v in [0, 2], applied gain = v^3 (display in dB).
+    auto v = patch.output.outputGain.value;
+    sp.gain = v * v * v;
+
+    for (int s = 0; s < numEndStages; ++s)
+    {
+        auto &st = endStages[s];
+        switch (st.kind)
         {
+        case ES_ULTRASONIC:
+            ultrasonicFilter.processBlock(L, R, blockSize);
+            break;
+        case ES_SHAPE:
+            st.shape(L, R, sp);
+            break;
+        case ES_BITRATE_PREFILTER:
+            bitRatePreFilter.processBlock(L, R, blockSize);
+            break;
+        case ES_BITRATE_ZOH:
             for (int i = 0; i < blockSize; ++i)
-            {
-                L[i] = ojdSaturator(L[i] * drive);
-                R[i] = ojdSaturator(R[i] * drive);
-            }
+                bitRateZOH.step(L[i], R[i]);
+            break;
+        case ES_LOWPASS:
+            lpFilter.processBlock(L, R, blockSize);
+            break;
+        case ES_HIGHPASS:
+            hpFilter.processBlock(L, R, blockSize);
+            break;
         }
     }
+}
+
+void Synth::rebuildEndStages(int satType, int bits)
+{
+    numEndStages = 0;
+    auto add = [this](EndStageKind k, output_shaper::shapeFn_t f = nullptr)
+    {
+        assert(numEndStages < maxEndStages);
+        endStages[numEndStages++] = {k, f};
+    };
+
+    endSaturates = satType == SAT_SOFT || satType == SAT_OJD;
+    auto sat = endSaturates ? satType : (int)SAT_NONE;
+    auto crush = bits > 0;
+    // bits levels span -1..1, so scale = 2^(bits-1) (e.g. 8 bit → 128 steps each side).
+    endCrushScale = crush ? (float)(1 << (bits - 1)) : 1.f;
+
+    // Until the decimators are on the HQ tier, the explicit filter keeps running
+    auto wasFolded = ultrasonicFolded;
+    ultrasonicFolded = ultrasonicActive && usesPolyphase() &&
+                       decimatorTier == PolyphaseDecimator::HQ && endChainIsLinear();
+    // Coming back, it starts from rest rather than from wherever it stopped
+    if (wasFolded && !ultrasonicFolded)
+        ultrasonicFilter.reset();
+
+    // Chain order is ultrasonic, saturate, rate crush, depth crush, lowpass, highpass, gain.
+    // A shaper run closes at each filter, carrying whatever stateless stages are pending.
+    if (ultrasonicActive && !ultrasonicFolded)
+        add(ES_ULTRASONIC);
+    if (bitRateActive)
+    {
+        if (sat != SAT_NONE)
+            add(ES_SHAPE, output_shaper::shapeFnFor(sat, false, false));
+        sat = SAT_NONE;
+        if (bitRatePreFilterActive)
+            add(ES_BITRATE_PREFILTER);
+        add(ES_BITRATE_ZOH);
+    }
+    if (lpActive || hpActive)
+    {
+        if (sat != SAT_NONE || crush)
+            add(ES_SHAPE, output_shaper::shapeFnFor(sat, crush, false));
+        sat = SAT_NONE;
+        crush = false;
+        if (lpActive)
+            add(ES_LOWPASS);
+        if (hpActive)
+            add(ES_HIGHPASS);
+    }
+    add(ES_SHAPE, output_shaper::shapeFnFor(sat, crush, true));
+}
+
+void Synth::handleEvent(const clap_event_header_t *nextEvent)
+{
+    if (nextEvent->space_id != CLAP_CORE_EVENT_SPACE_ID)
+        return;
 
-    if (bitRatePreFilterActive)
+    auto &vm = voiceManager;
+    switch (nextEvent->type)
     {
-        bitRatePreFilter.processBlock(L, R, blockSize);
+    case CLAP_EVENT_MIDI:
+    {
+        auto mevt = reinterpret_cast<const clap_event_midi *>(nextEvent);
+        sst::voicemanager::applyMidi1Message(*vm, mevt->port_index, mevt->data);
     }
-    if (bitRateActive)
+    break;
+
+    case CLAP_EVENT_NOTE_ON:
     {
-        for (int i = 0; i < blockSize; ++i)
-            bitRateZOH.step(L[i], R[i]);
+        auto nevt = reinterpret_cast<const clap_event_note *>(nextEvent);
+        vm->processNoteOnEvent(nevt->port_index, nevt->channel, nevt->key, nevt->note_id,
+                               nevt->velocity, 0.f);
     }
+    break;
 
-    auto bdVal = (int)std::round(patch.output.bitDepthAdjust.value);
-    if (bdVal != BD_NONE)
+    case CLAP_EVENT_NOTE_OFF:
     {
-        int bits = 0;
-        switch (bdVal)
-        {
-        case BD_8:
-            bits = 8;
-            break;
-        case BD_12:
-            bits = 12;
-            break;
-        case BD_16:
-            bits = 16;
-            break;
-        }
-        // bits levels span -1..1, so scale = 2^(bits-1) (e.g. 8 bit → 128 steps each side).
-        auto scale = (float)(1 << (bits - 1));
-        auto invScale = 1.f / scale;
-        for (int i = 0; i < blockSize; ++i)
+        auto nevt = reinterpret_cast<const clap_event_note *>(nextEvent);
+        auto nid = nevt->note_id;
+        // nid = -1;
+        vm->processNoteOffEvent(nevt->port_index, nevt->channel, nevt->key, nid, nevt->velocity);
+    }
+    break;
+    case CLAP_EVENT_PARAM_VALUE:
+    {
+        auto pevt = reinterpret_cast<const clap_event_param_value *>(nextEvent);
+        auto par = sst::plugininfra::patch_support::paramFromClapEvent<Param>(pevt, patch);
+        if (par)
         {
-            L[i] = std::round(L[i] * scale) * invScale;
-            R[i] = std::round(R[i] * scale) * invScale;
+            handleParamValue(par, pevt->param_id, pevt->value);
         }
     }
+    break;
 
-    if (lpActive)
-        lpFilter.processBlock(L, R, blockSize);
-    if (hpActive)
-        hpFilter.processBlock(L, R, blockSize);
-
-    // Output gain: param value v in [0, 2], applied gain = v^3 (display in dB).
-    auto v = patch.output.outputGain.value;
-    auto g = v * v * v;
-    if (g != 1.f)
+    case CLAP_EVENT_NOTE_EXPRESSION:
     {
-        for (int i = 0; i < blockSize; ++i)
-        {
-            L[i] *= g;
-            R[i] *= g;
-        }
+        auto nevt = reinterpret_cast<const clap_event_note_expression *>(nextEvent);
+        vm->routeNoteExpression(nevt->port_index, nevt->channel, nevt->key, nevt->note_id,
+                                nevt->expression_id, nevt->value);
+    }
+    break;
+    default:
+    {
+        SXSNLOG("Unknown inbound event of type " << nextEvent->type);
+    }
+    break;
     }
 }
 
@@ -1216,6 +1864,13 @@ void Synth::handleAudioThreadParamSideEffects(Param *dest)
         reapplyControlSettings();
     }
 
+    // Stateless stages, so only the stage list changes and the filters run on undisturbed
+    if (dest->meta.id == patch.output.saturationType.meta.id ||
+        dest->meta.id == patch.output.bitDepthAdjust.meta.id)
+    {
+        reapplyEndStages();
+    }
+
     if (dest->adhocFeatures & Param::AdHocFeatureValues::SOLO)
     {
         resetSoloState();
@@ -1348,16 +2003,13 @@ void Synth::paramsFlushMainThread(const clap_input_events_t *in, const clap_outp
 void Synth::sendEntirePatchToAudio(Patch &src, mainToAudioQueue_T &mainToAudio,
                                    const clap_host_t *h, const clap_host_params_t *hostParams)
 {
+    prepareWaveFormsFor(src);
     if (!h)
         return;
     if (hostParams == nullptr)
         hostParams = static_cast<const clap_host_params_t *>(h->get_extension(h, CLAP_EXT_PARAMS));
 
-    mainToAudio.push({MainToAudioMsg::STOP_AUDIO});
-    for (const auto *p : src.params)
-        mainToAudio.push({MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING, p->meta.id, p->value});
-    mainToAudio.push({MainToAudioMsg::START_AUDIO});
-    mainToAudio.push({MainToAudioMsg::SEND_POST_LOAD});
+    publishPatchToAudio(src, mainToAudio);
 
     // A load is a bulk out-of-band value change; the host reads values / text / param info (macro
     // names) from patchMain, which the caller updated first, so tell the host to re-read directly
@@ -1371,6 +2023,26 @@ void Synth::sendEntirePatchToAudio(Patch &src, mainToAudioQueue_T &mainToAudio,
     }
 }
 
+void Synth::publishPatchToAudio(const Patch &src, mainToAudioQueue_T &mainToAudio)
+{
+    auto seq = mainToAudio.patchSnapshot.publish(src);
+    mainToAudio.push({MainToAudioMsg::ADOPT_PATCH_SNAPSHOT, seq});
+}
+
+void Synth::prepareWaveFormsFor(const Patch &p)
+{
+    using RW = Patch::SourceNode::ResonantSweepWindow;
+    for (const auto &sn : p.sourceNodes)
+    {
+        SinTable::prepareWaveForm((SinTable::WaveForm)std::round(sn.waveForm.value));
+        auto rw = (RW)std::round(sn.resonantSweepWindowShape.value);
+        if (rw == RW::BLACKMAN_HARRIS)
+            SinTable::prepareWaveForm(SinTable::BLACKMAN_HARRIS_WINDOW);
+        else if (rw == RW::TUKEY)
+            SinTable::prepareWaveForm(SinTable::TUKEY_WINDOW);
+    }
+}
+
 void Synth::resetSoloState()
 {
     bool anySolo = false;
@@ -20,10 +20,15 @@
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <string>
+#include <vector>
+#include <functional>
+#include <optional>
 
 #include "sst/basic-blocks/dsp/LanczosResampler.h"
 #include "sst/filters/ButterworthLPHP.h"
+#include "dsp/output_shaper.h"
 #include "samplerate.h"
 
 class TiXmlElement;
@@ -39,10 +44,13 @@ class TiXmlElement;
 
 #include "configuration.h"
 
+#include "dsp/polyphase_decimator.h"
 #include "synth/voice.h"
+#include "synth/voice_render_pool.h"
 #include "synth/patch.h"
 #include "mono_values.h"
 #include "mod_matrix.h"
+#include "process_timing.h"
 #include "ui/ui-defaults.h"
 #include "sst/basic-blocks/dsp/LagCollection.h"
 
@@ -62,18 +70,122 @@ struct Synth
         return resamplerEngine == ResamplerEngine::LANCZOS || resamplerEngine == ZOH ||
                resamplerEngine == LINTERP;
     }
+    inline bool usesPolyphase() const
+    {
+        return resamplerEngine == ResamplerEngine::POLYPHASE || resamplerEngine == POLYPHASE_HQ;
+    }
+
+    /*
+     * Every resampler variant, built for the host rate by setSampleRate (main thread, at
+     * activate): a Lanczos and a polyphase decimator per bus per sample rate strategy, and a
+     * stereo libsamplerate state per bus per SRC quality. The audio thread only re-points
+     * resampler / decimator / srcState / audioInResampler into these and clears them, so a
+     * strategy or engine change from automation or a patch load never touches the heap.
+     */
+    static constexpr int numSampleRateStrategies{SR_220240 + 1};
+    static constexpr int numSRCModes{SRC_BEST + 1};
 
     using resampler_t = sst::basic_blocks::dsp::LanczosResampler<blockSize>;
-    std::array<std::unique_ptr<resampler_t>, 1 + numOps> resampler;
-    std::array<SRC_STATE *, 1 + numOps> lState{}, rState{};
+    std::array<std::array<std::unique_ptr<resampler_t>, 1 + numOps>, numSampleRateStrategies>
+        lanczosPool;
+    std::array<std::array<SRC_STATE *, 1 + numOps>, numSRCModes> srcStatePool{};
+    std::array<resampler_t *, 1 + numOps> resampler{};
+    std::array<std::array<std::unique_ptr<PolyphaseDecimator>, 1 + numOps>,
+               numSampleRateStrategies>
+        decimatorPool;
+    std::array<PolyphaseDecimator *, 1 + numOps> decimator{};
+    /*
+     * The polyphase engines decimate through the HQ tier, which stops at host nyquist, and
+     * so does the ultrasonic brickwall. Between the two the output chain only filters and
+     * scales unless saturation or a crusher is on, so with a linear chain the brickwall
+     * folds into the decimator: with the ultrasonic filter on POLYPHASE decimates through
+     * the HQ tier on every bus and the explicit ButterworthLP<16> stage drops out.
+     *
+     * The fold follows the chain from the next block: any non-linear stage puts the explicit
+     * filter back, and the decimator keeps its tier. The tier itself only moves with the
+     * engine, when the strategy or engine changes, or once the engine is idle and silent,
+     * so toggling the ultrasonic filter never fades the output. Until then the explicit
+     * filter runs.
+     */
+    PolyphaseDecimator::Tier decimatorTier{PolyphaseDecimator::STANDARD};
+    bool ultrasonicFolded{false};
+    bool endChainIsLinear() const;
+    PolyphaseDecimator::Tier wantedDecimatorTier() const;
+    std::array<SRC_STATE *, 1 + numOps> srcState{};
+
+    /*
+     * libsamplerate has a large fixed cost per src_process call, so rather than calling it
+     * per channel per engine block the SRC engines run one interleaved stereo state per bus
+     * and batch engine blocks. Engine output collects in srcIn until srcBatchBlocks blocks
+     * are there, one src_process per bus moves them to srcOut, and host blocks drain srcOut.
+     * Above one, like macroBlocks, incoming events land on batch boundaries. A batch is
+     * never shorter than the current macro-block, so macro rendering calls the resampler
+     * once per pass. Both come from the user defaults, set from the main menu.
+     */
+    int srcBatchBlocks{1};
+    static constexpr int srcOutCapacity{blockSize * (maxSRCBatchBlocks + 1)};
+    float srcIn alignas(16)[1 + numOps][2 * blockSize * maxSRCBatchBlocks];
+    float srcOut alignas(16)[1 + numOps][2 * srcOutCapacity];
+    int srcInFrames{0}, srcOutPos{0}, srcOutFrames{0};
+    void clearSRCBatch()
+    {
+        srcInFrames = 0;
+        srcOutPos = 0;
+        srcOutFrames = 0;
+        srcFramesIn = 0;
+    }
+    template <bool multiOut> void processSRCBatch();
+
+    /*
+     * Multi-out operator buses with nothing routed to them go to sleep once their input has
+     * been silent for busSleepSeconds, well past any resampler's history, and stop being
+     * resampled; their output is zero until they wake. A bus wakes with a cleared history on
+     * the main bus's resampler clock, so it comes back in step without a fade. The main bus
+     * never sleeps.
+     */
+    static constexpr double busSleepSeconds{0.1};
+    int busSleepFrames{0};
+    std::array<int, 1 + numOps> busQuietFrames{};
+    std::array<bool, 1 + numOps> busAsleep{};
+    // SRC buses wake at the next batch, on a frame where the output grid lines up
+    std::array<bool, 1 + numOps> srcBusWaking{};
+    int64_t srcFramesIn{0};
+    void clearBusSleep()
+    {
+        std::fill(busQuietFrames.begin(), busQuietFrames.end(), 0);
+        std::fill(busAsleep.begin(), busAsleep.end(), false);
+        std::fill(srcBusWaking.begin(), srcBusWaking.end(), false);
+    }
+    void wakeBus(int rsi);
+    // Bit rsi is set while bus rsi's output is constant silence
+    uint32_t silentBusMask() const
+    {
+        uint32_t res{0};
+        for (int rsi = 1; rsi < 1 + numOps; ++rsi)
+            if (busAsleep[rsi])
+                res |= 1U << rsi;
+        return res;
+    }
 
     // Audio input upsampling: host rate -> engine rate
     using audioInResampler_t = sst::basic_blocks::dsp::LanczosResampler<blockSize>;
-    std::unique_ptr<audioInResampler_t> audioInResampler;
-    void pushAudioIn(float L, float R)
+    std::array<std::unique_ptr<audioInResampler_t>, numSampleRateStrategies> audioInPool;
+    audioInResampler_t *audioInResampler{nullptr};
+    // Host rate audio input, n frames at a time; a null channel pushes silence
+    void pushAudioIn(const float *L, const float *R, uint32_t n)
     {
-        if (audioInResampler)
-            audioInResampler->push(L, R);
+        if (!audioInResampler)
+            return;
+        if (L && R)
+        {
+            for (uint32_t i = 0; i < n; ++i)
+                audioInResampler->push(L[i], R[i]);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < n; ++i)
+                audioInResampler->push(L ? L[i] : 0.f, R ? R[i] : 0.f);
+        }
     }
 
     Patch patch;     // audio-thread working copy
@@ -94,6 +206,103 @@ struct Synth
     void dumpVoiceList();
     int voiceCount{0};
 
+    // Render the voice list operator-by-operator so matching operators across voices
+    // run in SIMD packs (see Voice::renderBlocksPacked). Off renders voice-by-voice.
+    bool voicePackRendering{true};
+
+    // Optional worker threads which render slices of the voice list in parallel.
+    // Empty (all voices on the audio thread) unless the user opts in.
+    VoiceRenderPool renderPool;
+
+    /*
+     * Once the voice list is empty and every output has stayed under idleThreshold for
+     * idleSeconds, long enough for the resampler and end-of-chain tails to ring out, the
+     * engine is idle. The plugin then stops calling process, reports constant silence and
+     * returns CLAP_PROCESS_SLEEP until an event or a main thread message arrives.
+     */
+    static constexpr float idleThreshold{1e-6f}; // -120dB
+    static constexpr double idleSeconds{0.25};
+    int idleBlocks{0}, idleBlocksNeeded{1};
+    bool isIdle() const
+    {
+        return idleBlocks >= idleBlocksNeeded && !resamplerSwitchPending &&
+               resamplerFadeLevel == resamplerFadeBlocks && scheduledBegin == scheduledEnd;
+    }
+
+    static constexpr int defaultVoiceSleepThresholdDb{-120};
+    void setVoiceSleepThresholdDb(float db)
+    {
+        monoValues.voiceSleepThreshold = (db < 0.f) ? std::pow(10.f, db / 20.f) : 0.f;
+    }
+
+    // Blocks each voice renders per pass, 1 to maxMacroBlocks. Above one, voices render
+    // that many blocks back to back into macroBus and the engine drains it a block at a
+    // time. Voice modulation still runs every block, but the mono per-block work (UI
+    // parameter lag, unison hoists) and incoming events land on macro-block boundaries.
+    // Multi-out and audio-in patches always render single blocks.
+    int macroBlocks{1};
+    float macroBus alignas(16)[2][blockSize * maxMacroBlocks];
+    int macroBusPos{0}, macroBusLen{0};
+    void advanceMonoBlock(bool op1IsAudioIn);
+    void renderMacroBlock(int subBlocks);
+
+    /*
+     * Event timing. By default the plugin dispatches events when the host block they fall
+     * in starts, so they land up to blockSize host samples early or late depending on where
+     * the engine's resampling has got to. With sample accurate events the plugin instead
+     * hands each event to scheduleEvent with its host time. That maps to an engine sample a
+     * fixed eventLatency ahead of the host, and the engine dispatches the event before the
+     * engine block holding that sample. Voices a note starts are delayed by the event's
+     * offset into the block (Voice::startDelay), so notes land on their engine sample.
+     * Param changes land on the engine block. Macro blocks are off while scheduling.
+     *
+     * The eventLatency shift is not reported to the host, so a sample accurate bounce plays
+     * its notes that much later than the same session in realtime. Block events stay the
+     * default so existing sessions bounce as they always have.
+     */
+    enum EventTiming : int
+    {
+        BLOCK_EVENTS = 0,
+        SAMPLE_ACCURATE_OFFLINE = 1, // when the host renders offline (CLAP render extension)
+        SAMPLE_ACCURATE = 2
+    };
+    EventTiming eventTiming{BLOCK_EVENTS};
+    std::atomic<bool> renderingOffline{false};
+    bool sampleAccurateEvents() const
+    {
+        return eventTiming == SAMPLE_ACCURATE ||
+               (eventTiming == SAMPLE_ACCURATE_OFFLINE &&
+                renderingOffline.load(std::memory_order_relaxed));
+    }
+
+    struct ScheduledEvent
+    {
+        int64_t engineSample{0};
+        union
+        {
+            clap_event_header_t header;
+            clap_event_note_t note;
+            clap_event_midi_t midi;
+            clap_event_param_value_t paramValue;
+            clap_event_note_expression_t noteExpression;
+        } event;
+    };
+    static constexpr size_t maxScheduledEvents{4096};
+    std::array<ScheduledEvent, maxScheduledEvents> scheduledEvents;
+    size_t scheduledBegin{0}, scheduledEnd{0};
+    // Host samples processed and engine samples rendered since the resamplers last reset
+    int64_t hostSamplesProcessed{0}, engineSamplesRendered{0};
+    // Measured after the first block and fixed until the next reset; -1 is not yet known
+    int64_t eventLatency{-1};
+    // Applies an event now; handleEvent unless a test or tool swaps it
+    std::function<void(const clap_event_header_t *)> dispatchEvent;
+    // The start delay for any voice created by the event being dispatched
+    int voiceStartDelay{0};
+    // hostOffset is relative to the start of the next host block process() renders
+    void scheduleEvent(const clap_event_header_t *e, int32_t hostOffset);
+    void dispatchScheduledEvents();
+    void resetEventClock();
+
     struct PortaContinuation
     {
         bool active{false};
@@ -158,6 +367,7 @@ struct Synth
             typename sst::voicemanager::VoiceInitBufferEntry<VMConfig>::buffer_t &obuf, uint16_t pt,
             uint16_t ch, uint16_t key, int32_t nid, float vel, float rt)
         {
+            auto attackStart = std::chrono::high_resolution_clock::now();
             int made{0};
 
             int lastStart{0};
@@ -207,6 +417,7 @@ struct Synth
                                                                key, synth.patch.output.portaTime,
                                                                synth.portaContinuation.portaFrac);
                             }
+                            synth.voices[i].setStartDelay(synth.voiceStartDelay);
                             synth.voices[i].attack();
 
                             synth.addToVoiceList(&synth.voices[i]);
@@ -222,6 +433,9 @@ struct Synth
             if (ct > 0)
                 synth.portaContinuation.active = false;
 
+            if (made > 0)
+                synth.processTiming.attack.record(synth.blockRealtimeUsed(attackStart));
+
             return made;
         }
         void releaseVoice(Voice *v, float rv)
@@ -293,14 +507,33 @@ struct Synth
     VMMonoResponder monoResponder;
     std::unique_ptr<voiceManager_t> voiceManager;
 
-    Synth(bool isMultiOut);
+    Synth(bool isMultiOut, std::optional<uint32_t> randomSeed = std::nullopt);
     ~Synth();
 
     bool audioRunning{true};
     int beginEndParamGestureCount{0};
+    // Audio thread: the sequence of the last ADOPT_PATCH_SNAPSHOT marker handled and of the
+    // snapshot held. While the held one is newer, param messages in the queue predate it.
+    uint32_t patchSnapshotMarkerSeen{0}, patchSnapshotHeld{0};
 
     double hostSampleRate{0}, engineSampleRate{0}, sampleRateRatio{0};
+    static double engineSampleRateFor(double hostRate, SampleRateStrategy s);
+    // Main thread: builds the resampler pools for this host rate, then applies the strategy
     void setSampleRate(double sampleRate);
+    // Audio thread safe: picks and clears the pooled resamplers for the current strategy and
+    // engine, and re-rates everything keyed off the engine rate
+    void applyEngineSampleRate();
+
+    // A strategy or engine change while running fades the host-rate output out over
+    // resamplerFadeSeconds, switches at silence, and fades back in. An engine change keeps
+    // every voice. A strategy change moves the engine rate, which voices latch at attack,
+    // so it cuts every sounding note, held ones included, at the silent point; the output
+    // stage panel says so next to the control. setSampleRate sizes the fade in blocks.
+    static constexpr double resamplerFadeSeconds{0.02};
+    int resamplerFadeBlocks{8};
+    int resamplerFadeLevel{8};
+    bool resamplerSwitchPending{false};
+    template <bool multiOut> void processResamplerFade();
 
     template <bool multiOut> void processInternal(const clap_output_events_t *);
 
@@ -311,6 +544,32 @@ struct Synth
     // Runs the saturator / lowpass / decimator / bitcrush / highpass stages.
     void processEndOfBlock(float *L, float *R);
 
+    // The end-of-chain stages the output settings switch on, in chain order, resolved
+    // in reapplyControlSettings. The stateless ones (saturation, bit depth and output
+    // gain) fuse into one SHAPE stage per run between filters; see output_shaper.h.
+    enum EndStageKind : uint8_t
+    {
+        ES_ULTRASONIC,
+        ES_SHAPE,
+        ES_BITRATE_PREFILTER,
+        ES_BITRATE_ZOH,
+        ES_LOWPASS,
+        ES_HIGHPASS
+    };
+    struct EndStage
+    {
+        EndStageKind kind{ES_SHAPE};
+        output_shaper::shapeFn_t shape{nullptr};
+    };
+    static constexpr int maxEndStages{8};
+    std::array<EndStage, maxEndStages> endStages{};
+    int numEndStages{0};
+    bool endSaturates{false};
+    float endCrushScale{1.f};
+    void rebuildEndStages(int satType, int bits);
+    // Rebuilds the stage list from the saturation and bit depth params
+    void reapplyEndStages();
+
     // End-of-chain stage state. Coefficients are recomputed in
     // reapplyControlSettings; the active flags gate the per-block work.
     sst::filters::ButterworthLP<6> lpFilter;
@@ -399,6 +658,8 @@ struct Synth
     }
 
     void handleParamValue(Param *p, uint32_t pid, float value);
+    // A CLAP note, MIDI, param or note expression event, applied now
+    void handleEvent(const clap_event_header_t *e);
 
     static_assert(sst::voicemanager::constraints::ConstraintsChecker<VMConfig, VMResponder,
                                                                      VMMonoResponder>::satisfies());
@@ -484,7 +745,10 @@ struct Synth
             UPDATE_VOICE_COUNT,
             UPDATE_CPU_USAGE,
             SEND_SAMPLE_RATE,
-            MTS_POINTER // dawExtraStatePointer = MTSClient* (or nullptr)
+            MTS_POINTER, // dawExtraStatePointer = MTSClient* (or nullptr)
+            // paramId is a node_profiler::Category, value its percent of the engine time
+            // since the last update. Only sent by SIX_SINES_NODE_PROFILING builds.
+            UPDATE_NODE_PROFILE
         } action;
         uint32_t paramId{0};
         float value{0}, value2{0};
@@ -506,9 +770,17 @@ struct Synth
             SEND_POST_LOAD,
             PANIC_STOP_VOICES,
             SET_DESIGN_MODE_RUN_ALL,
+            // value is the threshold in dB; 0 turns voice sleeping off
+            SET_VOICE_SLEEP_THRESHOLD,
+            // value is an EventTiming
+            SET_EVENT_TIMING,
             // Transport the main-owned AudioDawState (MPE + smoothing) to the audio thread, by
             // value in the `audioDawState` field. Engine-instance session state, not a patch param.
-            SET_AUDIO_DAW_STATE
+            SET_AUDIO_DAW_STATE,
+            // Take every param value from the queue's patchSnapshot and run postLoad. Queued
+            // after the snapshot is published so it lands in order with the edits around it;
+            // paramId carries the snapshot's sequence number.
+            ADOPT_PATCH_SNAPSHOT
         } action;
         uint32_t paramId{0};
         float value{0};
@@ -531,7 +803,77 @@ struct Synth
     // thread, where onMainThread() will issue the actual clap rescans.
     void requestParamRescan(uint32_t flags);
     using audioToMainQueue_t = sst::cpputils::SimpleRingBuffer<AudioToMainMsg, 1024 * 16>;
-    using mainToAudioQueue_T = sst::cpputils::SimpleRingBuffer<MainToAudioMsg, 1024 * 64>;
+
+    /*
+     * Every param value of a patch, crossing main -> audio in one go rather than as a
+     * SET_PARAM_WITHOUT_NOTIFYING per param. Three preallocated value buffers form a triple
+     * buffer: the main thread fills its back buffer and swaps it into the middle slot with one
+     * atomic exchange, and the audio thread swaps a fresh middle out as its front buffer.
+     * Neither side waits and neither touches the buffer the other holds. Values are in
+     * Patch::params order, which is the same for every Patch.
+     *
+     * Each publish is numbered, and its ADOPT_PATCH_SNAPSHOT marker carries that number. A
+     * marker can find a newer snapshot than its own waiting; the audio thread adopts it and
+     * drops the param messages queued ahead of that snapshot's marker, which it already holds.
+     */
+    struct PatchSnapshotExchange
+    {
+        static constexpr uint32_t freshBit{1u << 2};
+        std::array<std::vector<float>, 3> values;
+        std::array<uint32_t, 3> sequence{};
+        uint32_t back{0}, front{1};
+        std::atomic<uint32_t> middle{2};
+        uint32_t lastPublished{0}; // main thread
+
+        // Before the audio thread runs
+        void prepare(size_t paramCount)
+        {
+            for (auto &v : values)
+                v.resize(paramCount);
+        }
+
+        // Main thread. Returns the sequence number for the snapshot's marker
+        uint32_t publish(const Patch &src)
+        {
+            auto &v = values[back];
+            v.resize(src.params.size());
+            for (size_t i = 0; i < src.params.size(); ++i)
+                v[i] = src.params[i]->value;
+            sequence[back] = ++lastPublished;
+            back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & ~freshBit;
+            return lastPublished;
+        }
+
+        // Audio thread. The newest published values, or nullptr if none since the last adopt.
+        const std::vector<float> *adopt()
+        {
+            if (!(middle.load(std::memory_order_acquire) & freshBit))
+                return nullptr;
+            front = middle.exchange(front, std::memory_order_acq_rel) & ~freshBit;
+            return &values[front];
+        }
+        // Audio thread. The sequence number of the values adopt last returned
+        uint32_t adoptedSequence() const { return sequence[front]; }
+    };
+
+    struct MainToAudioQueue : sst::cpputils::SimpleRingBuffer<MainToAudioMsg, 1024 * 64>
+    {
+        using base_t = sst::cpputils::SimpleRingBuffer<MainToAudioMsg, 1024 * 64>;
+        PatchSnapshotExchange patchSnapshot;
+
+        // Set by the audio thread while the plugin has told the host it can stop processing,
+        // so a push asks the host to resume and deliver it
+        std::atomic<bool> audioSleeping{false};
+        const clap_host_t *host{nullptr};
+        bool push(const MainToAudioMsg &m)
+        {
+            auto res = base_t::push(m);
+            if (host && audioSleeping.load(std::memory_order_acquire))
+                host->request_process(host);
+            return res;
+        }
+    };
+    using mainToAudioQueue_T = MainToAudioQueue;
     audioToMainQueue_t audioToMain;
     mainToAudioQueue_T mainToAudio;
 
@@ -585,6 +927,12 @@ struct Synth
     static void sendEntirePatchToAudio(Patch &src, mainToAudioQueue_T &mainToAudio,
                                        const clap_host_t *host,
                                        const clap_host_params_t *hostParams = nullptr);
+    // Publish src's values as the queue's patch snapshot and queue its adoption. Main thread.
+    static void publishPatchToAudio(const Patch &src, mainToAudioQueue_T &mainToAudio);
+
+    // Build the SinTable waveforms (and resonant sweep windows) `p` selects so its notes don't
+    // build a table on the audio thread. Main thread only; see SinTable::prepareWaveForm.
+    static void prepareWaveFormsFor(const Patch &p);
 
     void postLoad()
     {
@@ -618,6 +966,19 @@ struct Synth
     sst::basic_blocks::dsp::VUPeak vuPeak;
     std::array<sst::basic_blocks::dsp::VUPeak, numOps> opVuPeak;
     double cpuUsage{0};
+    void pushNodeProfile();
+
+    // Tail latency histograms, read directly by the editor and the perf harness
+    ProcessTiming processTiming;
+    // Time since start as a fraction of the realtime of one block, blockSize frames at the
+    // host rate. Relative cost, not a deadline; the host buffer is the deadline
+    double blockRealtimeUsed(std::chrono::high_resolution_clock::time_point start) const
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::high_resolution_clock::now() - start)
+                      .count();
+        return ns * hostSampleRate * 1e-9 / blockSize;
+    }
     int32_t updateVuEvery{(int32_t)(48000 * 2.5 / 60 / blockSize)}; // approx
     int32_t lastVuUpdate{updateVuEvery};
 
@@ -14,6 +14,10 @@
  */
 
 #include "voice.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include "sst/cpputils/constructors.h"
 #include "synth/matrix_index.h"
 #include "synth/patch.h"
@@ -25,7 +29,8 @@ namespace baconpaul::six_sines
 namespace scpu = sst::cpputils;
 
 Voice::Voice(const Patch &p, MonoValues &mv)
-    : monoValues(mv), out(p.output, p.mainPanMod, p.fineTuneMod, mixerNode, mv, voiceValues),
+    : monoValues(mv), voiceValues(mv.rng.unifU32()),
+      out(p.output, p.mainPanMod, p.fineTuneMod, mixerNode, mv, voiceValues),
       output{out.output[0], out.output[1]},
       src(scpu::make_array_lambda<OpSource, numOps>(
           [this, &p, &mv](auto i) { return OpSource(p.sourceNodes[i], mv, voiceValues); })),
@@ -74,6 +79,8 @@ void Voice::attack()
     voiceValues.noteExpressionPanBipolarLag.setRateInMilliseconds(
         mpeLagMs, monoValues.sr.sampleRate, 1.0 / blockSize);
     voiceValues.firstBlockAfterAttack = true;
+    silentBlocks = 0;
+    asleep = false;
 
     for (auto &n : macroNode)
         n.attack();
@@ -91,6 +98,136 @@ void Voice::attack()
 }
 
 void Voice::renderBlock()
+{
+    beginBlock();
+    for (int i = 0; i < numOps; ++i)
+    {
+        if (!prepareOperator(i))
+            continue;
+        src[i].renderBlock();
+        mixerNode[i].renderBlock();
+    }
+    endBlock();
+}
+
+void Voice::renderBlocksPacked(Voice *const *vs, size_t n)
+{
+    static constexpr size_t W{OpSource::voicePackWidth};
+
+    for (size_t v = 0; v < n; ++v)
+        vs[v]->beginBlock();
+
+    // Operator i of every voice depends only on operators j < i of the same voice,
+    // so we can walk the operators in the outer loop and the voices in the inner one.
+    // That lines up the same operator across voices so the eligible ones can run
+    // their inner loop as one SIMD pack.
+    for (int i = 0; i < numOps; ++i)
+    {
+        // One pending pack per feedback mode, since that picks the template
+        OpSource *pack[2][W];
+        float rf[2][W], dRF[2][W];
+        size_t np[2]{0, 0};
+
+        auto flush = [&](int fb)
+        {
+            if (np[fb] == 1)
+            {
+                auto *s = pack[fb][0];
+                node_profiler::Scope profile(s->profileCategory());
+                s->innerLoop(s->output, s->fbVal, rf[fb][0], dRF[fb][0], s->phase);
+            }
+            else if (np[fb] > 1)
+            {
+                if (fb)
+                    OpSource::innerLoopVoicePack<true>(pack[fb], np[fb], rf[fb], dRF[fb]);
+                else
+                    OpSource::innerLoopVoicePack<false>(pack[fb], np[fb], rf[fb], dRF[fb]);
+            }
+            np[fb] = 0;
+        };
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            auto *voice = vs[v];
+            if (!voice->prepareOperator(i))
+                continue;
+
+            auto &s = voice->src[i];
+            if (!s.canRenderInVoicePack())
+            {
+                s.renderBlock();
+                continue;
+            }
+
+            auto fb = s.hasActiveFeedback ? 1 : 0;
+            if (!s.renderBlockPrologue(rf[fb][np[fb]], dRF[fb][np[fb]]))
+                continue;
+            pack[fb][np[fb]++] = &s;
+            if (np[fb] == W)
+                flush(fb);
+        }
+        flush(0);
+        flush(1);
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (vs[v]->src[i].active && !vs[v]->src[i].dormant)
+                vs[v]->mixerNode[i].renderBlock();
+        }
+    }
+
+    for (size_t v = 0; v < n; ++v)
+        vs[v]->endBlock();
+}
+
+void Voice::renderMacroBlocks(Voice *const *vs, size_t n, int subBlocks, bool pack)
+{
+    static constexpr size_t W{OpSource::voicePackWidth};
+    auto group = pack ? W : (size_t)1;
+
+    for (size_t g = 0; g < n; g += group)
+    {
+        auto gn = std::min(group, n - g);
+        for (size_t v = 0; v < gn; ++v)
+        {
+            vs[g + v]->macroEnded = false;
+            vs[g + v]->macroRendered = 0;
+        }
+
+        for (int j = 0; j < subBlocks; ++j)
+        {
+            Voice *live[W];
+            size_t nl{0};
+            for (size_t v = 0; v < gn; ++v)
+            {
+                if (!vs[g + v]->macroEnded)
+                    live[nl++] = vs[g + v];
+            }
+            if (nl == 0)
+                break;
+
+            if (nl > 1)
+                renderBlocksPacked(live, nl);
+            else
+                live[0]->renderBlock();
+
+            for (size_t v = 0; v < nl; ++v)
+            {
+                auto *voice = live[v];
+                memcpy(&voice->macroOutput[0][j * blockSize], voice->output[0],
+                       sizeof(float) * blockSize);
+                memcpy(&voice->macroOutput[1][j * blockSize], voice->output[1],
+                       sizeof(float) * blockSize);
+                voice->macroRendered = j + 1;
+                // Same test the synth uses to retire a voice after a single block
+                if (voice->isFinished())
+                    voice->macroEnded = true;
+            }
+        }
+    }
+}
+
+void Voice::beginBlock()
 {
     // Advance MPE / note-expression lags before any pitch math or per-node mod
     // matrix evaluation. On the first block after attack, snap (voicemanager
@@ -170,10 +307,8 @@ void Voice::renderBlock()
         voiceValues.portaFrac = 0;
     }
 
-    auto octSh = std::clamp((int)std::round(out.octTranspose), -3, 3);
-    static constexpr float octFac[7] = {1.0 / 8.0, 1.0 / 4.0, 1.0 / 2.0, 1.0, 2.0, 4.0, 8.0};
-
-    auto baseFreq = monoValues.tuningProvider.note_to_pitch(retuneKey - 69) * 440.0;
+    octShift = std::clamp((int)std::round(out.octTranspose), -3, 3);
+    baseFreq = monoValues.tuningProvider.note_to_pitch(retuneKey - 69) * 440.0;
 
     voiceValues.velocityLag.setTarget(voiceValues.velocity);
     voiceValues.velocityLag.process();
@@ -199,28 +334,47 @@ void Voice::renderBlock()
         mn.wasPowerOn = mn.macroPowerOn;
     }
 
-    for (int i = 0; i < numOps; ++i)
+    updateReachability();
+}
+
+bool Voice::prepareOperator(int i)
+{
+    static constexpr float octFac[7] = {1.0 / 8.0, 1.0 / 4.0, 1.0 / 2.0, 1.0, 2.0, 4.0, 8.0};
+
+    if (!src[i].active)
+    {
+        src[i].clearOutputs();
+        return false;
+    }
+    if (!operatorLive[i])
     {
-        if (!src[i].active)
+        if (!src[i].dormant)
         {
             src[i].clearOutputs();
-            continue;
+            src[i].fbVal[0] = 0.f;
+            src[i].fbVal[1] = 0.f;
+            memset(mixerNode[i].output, 0, sizeof(mixerNode[i].output));
+            src[i].dormant = true;
         }
-        src[i].zeroInputs();
-        auto octPer = std::clamp((int)std::round(src[i].octTranspose), -3, 3);
+        return false;
+    }
+    src[i].dormant = false;
+    src[i].zeroInputs();
+    auto octPer = std::clamp((int)std::round(src[i].octTranspose), -3, 3);
 
-        src[i].setBaseFrequency(baseFreq, octFac[octSh + 3] * octFac[octPer + 3]);
-        for (auto j = 0; j < i; ++j)
-        {
-            auto pos = MatrixIndex::positionForSourceTarget(j, i);
-            matrixNode[pos].applyBlock();
-        }
-        if (!src[i].isAudioInCachedAtAttack)
-            selfNode[i].applyBlock();
-        src[i].renderBlock();
-        mixerNode[i].renderBlock();
+    src[i].setBaseFrequency(baseFreq, octFac[octShift + 3] * octFac[octPer + 3]);
+    for (auto j = 0; j < i; ++j)
+    {
+        auto pos = MatrixIndex::positionForSourceTarget(j, i);
+        matrixNode[pos].applyBlock();
     }
+    if (!src[i].isAudioInCachedAtAttack)
+        selfNode[i].applyBlock();
+    return true;
+}
 
+void Voice::endBlock()
+{
     out.renderBlock();
 
     if (fadeBlocks > 0)
@@ -236,9 +390,93 @@ void Voice::renderBlock()
         fadeBlocks--;
     }
 
+    if (monoValues.voiceSleepThreshold > 0.f)
+        trackSilence();
+
     voiceValues.firstBlockAfterAttack = false;
 }
 
+void Voice::updateReachability()
+{
+    // Design mode wants every node running so it can be seen
+    if (monoValues.designModeRunAll)
+    {
+        operatorLive.fill(true);
+        return;
+    }
+
+    // Matrix routes only run from lower to higher ops, so one pass from the top is enough
+    for (int i = numOps - 1; i >= 0; --i)
+    {
+        auto live = src[i].active && !mixerNode[i].contributesNothing();
+        for (int k = i + 1; k < numOps && !live && src[i].active; ++k)
+        {
+            live = operatorLive[k] &&
+                   !matrixNode[MatrixIndex::positionForSourceTarget(i, k)].contributesNothing();
+        }
+        operatorLive[i] = live;
+    }
+}
+
+void Voice::trackSilence()
+{
+    float pk{0.f};
+    for (int i = 0; i < blockSize; ++i)
+        pk = std::max({pk, std::fabs(out.output[0][i]), std::fabs(out.output[1][i])});
+
+    if (pk >= monoValues.voiceSleepThreshold)
+    {
+        silentBlocks = 0;
+        return;
+    }
+    auto blocksBeforeSleep = silenceSecondsBeforeSleep * monoValues.sr.sampleRate / blockSize;
+    if (++silentBlocks < blocksBeforeSleep)
+        return;
+
+    if (voiceValues.gated)
+    {
+        for (auto &m : mixerNode)
+        {
+            if (!m.contributesNothing())
+                return;
+        }
+    }
+    else
+    {
+        auto outRising = !out.constantEnv && out.env.stage < OutputNode::env_t::s_decay;
+        if (outRising || out.lfoDepth != 0.f || out.anySources)
+            return;
+        for (auto &m : mixerNode)
+        {
+            if (!m.contributesNothing() && m.levelCanRise())
+                return;
+        }
+    }
+    asleep = true;
+}
+
+void Voice::applyStartDelay()
+{
+    auto d = startDelay;
+    auto delay = [d](float *x, float *carry)
+    {
+        float tmp[blockSize];
+        memcpy(tmp, x, sizeof(tmp));
+        memcpy(x, carry, d * sizeof(float));
+        memcpy(x + d, tmp, (blockSize - d) * sizeof(float));
+        memcpy(carry, tmp + blockSize - d, d * sizeof(float));
+    };
+
+    delay(out.output[0], startDelayCarry[0]);
+    delay(out.output[1], startDelayCarry[1]);
+    delay(out.finalEnvLevel, startDelayCarry[2]);
+    for (int i = 0; i < numOps; ++i)
+    {
+        delay(mixerNode[i].output[0], startDelayCarry[3 + 2 * i]);
+        delay(mixerNode[i].output[1], startDelayCarry[4 + 2 * i]);
+    }
+}
+
 static_assert(numOps == 6, "Rebuild this table if not");
 
 OpSource &Voice::sourceAtMatrix(size_t pos) { return src[MatrixIndex::sourceIndexAt(pos)]; }
@@ -349,6 +587,8 @@ void Voice::cleanup()
 {
     used = false;
     fadeBlocks = -1;
+    silentBlocks = 0;
+    asleep = false;
     voiceValues.setGated(false);
     voiceValues.portaDiff = 0;
     voiceValues.portaFrac = 0;
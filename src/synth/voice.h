@@ -16,6 +16,7 @@
 #ifndef BACONPAUL_SIX_SINES_SYNTH_VOICE_H
 #define BACONPAUL_SIX_SINES_SYNTH_VOICE_H
 
+#include <cstring>
 #include <sst/basic-blocks/tables/EqualTuningProvider.h>
 #include "dsp/op_source.h"
 #include "dsp/matrix_node.h"
@@ -42,6 +43,33 @@ struct Voice
     void renderBlock();
     void cleanup();
 
+    /*
+     * Render a block for n voices at once, operator by operator, running the
+     * operators which qualify through OpSource::innerLoopVoicePack. Output is
+     * the same as calling renderBlock on each voice.
+     */
+    static void renderBlocksPacked(Voice *const *voices, size_t n);
+
+    // The phases of renderBlock, split so renderBlocksPacked can interleave voices.
+    // prepareOperator returns false (and clears the op) if operator i is inactive.
+    void beginBlock();
+    bool prepareOperator(int i);
+    void endBlock();
+    float baseFreq{0.f};
+    int octShift{0};
+
+    /*
+     * Render subBlocks consecutive blocks for n voices, a few voices at a time, so a
+     * voice's state stays in cache across its blocks instead of being evicted by the
+     * rest of the voice list in between. Modulation still updates every blockSize
+     * samples. Block j lands in macroOutput at j * blockSize; a voice which finishes
+     * part way stops there and sets macroEnded, with macroRendered blocks written.
+     */
+    static void renderMacroBlocks(Voice *const *voices, size_t n, int subBlocks, bool pack);
+    float macroOutput alignas(16)[2][blockSize * maxMacroBlocks];
+    int macroRendered{0};
+    bool macroEnded{false};
+
     bool used{false};
 
     std::array<OpSource, numOps> src;
@@ -62,10 +90,61 @@ struct Voice
 
     std::array<MixerNode, numOps> mixerNode;
     std::array<MacroVoiceNode, numMacros> macroNode;
-    static constexpr int32_t fadeOverBlocks{32};
+    static constexpr int32_t fadeOverBlocks{256 / blockSize}; // 256 engine samples
     float dFade{1.0 / (blockSize * fadeOverBlocks)};
     int32_t fadeBlocks{-1};
 
+    /*
+     * A voice whose output has stayed under monoValues.voiceSleepThreshold for
+     * silenceSecondsBeforeSleep, and which can't come back up on its own, goes to sleep
+     * and is retired like a finished one. A released voice qualifies once no envelope
+     * is still rising and no tremolo, additive LFO or modulation can lift a mixer or the
+     * output, so a long release tail under the threshold stops there rather than when
+     * its envelope runs out, but a tremolo dipping to zero never cuts a note. A held
+     * voice only qualifies once every mixer is pinned at zero (a bell with zero sustain),
+     * since it would otherwise sustain on. The hold is in seconds so it is the same
+     * whatever the engine rate.
+     */
+    static constexpr double silenceSecondsBeforeSleep{0.1};
+    int32_t silentBlocks{0};
+    bool asleep{false};
+    void trackSilence();
+
+    /*
+     * Which operators can reach the output this block, walking back from op 6 over the
+     * mixers and the matrix: an op is live if its mixer passes it on, or if it feeds a
+     * live op through a matrix node that does. Self feedback only feeds the op itself.
+     * Recomputed every block in beginBlock, so envelopes settling or reattacking take
+     * effect on the next block. Ops which aren't live go dormant and skip their
+     * modulation, envelope, lfo and inner loop work, so only a node which can't come back
+     * without a reattack (off, or at the end of its envelope) counts as passing nothing.
+     * A zero level or a solo leaves the op running, muted, so its envelopes are where
+     * they should be when the level comes back up.
+     */
+    void updateReachability();
+    std::array<bool, numOps> operatorLive{};
+
+    /*
+     * A voice started by a sample accurate event part way into an engine block renders
+     * from the block start as usual, and applyStartDelay then pushes everything the
+     * engine reads from it (the output, the final envelope and the mixer outputs) that
+     * many samples later, carrying the overhang into the next block.
+     */
+    int startDelay{0};
+    float startDelayCarry alignas(16)[3 + 2 * numOps][blockSize];
+    void setStartDelay(int d)
+    {
+        startDelay = d;
+        if (d)
+            memset(startDelayCarry, 0, sizeof(startDelayCarry));
+    }
+    void applyStartDelay();
+
+    bool isFinished() const
+    {
+        return out.env.stage > OutputNode::env_t::s_release || fadeBlocks == 0 || asleep;
+    }
+
     OutputNode out;
 
     Voice *prior{nullptr}, *next{nullptr};
@@ -0,0 +1,186 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "voice_render_pool.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "synth/voice.h"
+
+namespace baconpaul::six_sines
+{
+
+void VoiceRenderPool::start(int n)
+{
+    stop();
+
+    n = std::clamp(n, 0, maxWorkers);
+    if (n == 0)
+        return;
+
+    running.store(true, std::memory_order_release);
+    nWorkers = n;
+    // Hand each worker the generation as of now, so a render() which lands before the
+    // thread gets scheduled is still seen as new work rather than skipped.
+    auto g0 = generation.load(std::memory_order_acquire);
+    for (int i = 0; i < nWorkers; ++i)
+        workers[i] = std::thread([this, g0]() { workerLoop(g0); });
+    SXSNLOG("Started " << nWorkers << " voice render workers");
+}
+
+void VoiceRenderPool::stop()
+{
+    if (nWorkers == 0)
+        return;
+
+    running.store(false, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    generation.notify_all();
+    for (int i = 0; i < nWorkers; ++i)
+    {
+        if (workers[i].joinable())
+            workers[i].join();
+    }
+    nWorkers = 0;
+}
+
+void VoiceRenderPool::renderSlice(Voice *const *voices, size_t n, bool pack, int subBlocks)
+{
+    if (n == 0)
+        return;
+    // On a worker this opens the thread's profile; on the audio thread it folds into its own
+    node_profiler::Session profile(voices[0]->monoValues.nodeProfile);
+    if (subBlocks > 1)
+    {
+        Voice::renderMacroBlocks(voices, n, subBlocks, pack);
+    }
+    else if (pack)
+    {
+        Voice::renderBlocksPacked(voices, n);
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+            voices[i]->renderBlock();
+    }
+}
+
+void VoiceRenderPool::render(Voice *const *voices, size_t n, bool pack, int subBlocks)
+{
+    // Slice count is a function of n only, so the work split is stable block to block
+    auto slices = std::min((size_t)nWorkers + 1, n / minVoicesPerSlice);
+    if (slices <= 1)
+    {
+        renderSlice(voices, n, pack, subBlocks);
+        return;
+    }
+
+    // Every slice of the last job is complete, so nobody reads these until the cursor
+    // below publishes them
+    jobVoices = voices;
+    jobSize = n;
+    jobPack = pack;
+    jobSubBlocks = subBlocks;
+    completed.store(0, std::memory_order_relaxed);
+    job++;
+    cursor.store(cursorFor(job, (uint32_t)slices, 0), std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+
+    renderClaimedSlices();
+
+    // Only slices a worker is rendering at this moment are left to wait for
+    while (completed.load(std::memory_order_acquire) != slices)
+    {
+    }
+}
+
+void VoiceRenderPool::renderClaimedSlices()
+{
+    auto c = cursor.load(std::memory_order_acquire);
+    while (true)
+    {
+        auto slices = (c >> 16) & 0xFFFF;
+        auto next = c & 0xFFFF;
+        if (next >= slices)
+            return;
+        if (!cursor.compare_exchange_weak(c, c + 1, std::memory_order_acq_rel,
+                                          std::memory_order_acquire))
+            continue;
+
+        auto b = next * jobSize / slices, e = (next + 1) * jobSize / slices;
+        renderSlice(jobVoices + b, e - b, jobPack, jobSubBlocks);
+        completed.fetch_add(1, std::memory_order_acq_rel);
+        c = cursor.load(std::memory_order_acquire);
+    }
+}
+
+void VoiceRenderPool::workerLoop(uint32_t seen)
+{
+    raiseThreadPriority();
+
+    static constexpr int spinsBeforeWait{4096};
+    while (true)
+    {
+        int spins{0};
+        auto g = generation.load(std::memory_order_acquire);
+        while (g == seen)
+        {
+            if (++spins > spinsBeforeWait)
+            {
+                generation.wait(seen, std::memory_order_acquire);
+                spins = 0;
+            }
+            g = generation.load(std::memory_order_acquire);
+        }
+        seen = g;
+
+        if (!running.load(std::memory_order_acquire))
+            return;
+
+        // Woken late, the job may be fully claimed already; then there is nothing to do
+        renderClaimedSlices();
+    }
+}
+
+void VoiceRenderPool::raiseThreadPriority()
+{
+    // Best effort. Without the rights for a real-time class (common on linux without
+    // rtprio limits) the workers stay at normal priority. A worker which isn't scheduled
+    // then leaves its slices for the audio thread to claim, so the cost is the parallel
+    // speedup, not a stalled block; only a worker preempted mid slice is waited for.
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+    sched_param sp{};
+    sp.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) != 0)
+    {
+        SXSNLOG("Voice render worker could not get real-time priority; running at default");
+    }
+#endif
+}
+
+} // namespace baconpaul::six_sines
@@ -0,0 +1,96 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_SYNTH_VOICE_RENDER_POOL_H
+#define BACONPAUL_SIX_SINES_SYNTH_VOICE_RENDER_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "configuration.h"
+
+namespace baconpaul::six_sines
+{
+struct Voice;
+
+/*
+ * A fixed pool of pre-spawned worker threads which render disjoint slices of
+ * the voice list. The audio thread publishes the list and wakes the workers,
+ * then everyone, the audio thread included, claims slices from an atomic cursor
+ * until none are left. A worker which is asleep or preempted never holds up a
+ * slice it has not claimed, so the audio thread only ever waits for slices
+ * which are being rendered right now, and with no workers awake it renders the
+ * whole list itself. Nothing allocates or locks on the audio thread: workers
+ * spin briefly on a generation counter and then block on it with atomic wait (a
+ * futex on linux).
+ *
+ * Workers only render. Summing into the engine bus still happens afterwards on
+ * the audio thread in voice list order, and voices share no mutable state while
+ * rendering (each has its own RNG), so the output is bit-identical to the
+ * serial path no matter how the list is sliced.
+ *
+ * start() and stop() are main thread only and must not run while the audio
+ * thread is inside render().
+ */
+struct VoiceRenderPool
+{
+    static constexpr int maxWorkers{7};
+    // Below this many voices per slice the handoff costs more than it saves
+    static constexpr size_t minVoicesPerSlice{4};
+
+    VoiceRenderPool() = default;
+    ~VoiceRenderPool() { stop(); }
+
+    void start(int nWorkers);
+    void stop();
+    int workerCount() const { return nWorkers; }
+
+    // subBlocks > 1 renders that many blocks per voice with Voice::renderMacroBlocks
+    void render(Voice *const *voices, size_t n, bool pack, int subBlocks = 1);
+
+  private:
+    void workerLoop(uint32_t seen);
+    // Claim and render slices of the current job until none are left
+    void renderClaimedSlices();
+    static void renderSlice(Voice *const *voices, size_t n, bool pack, int subBlocks);
+    static void raiseThreadPriority();
+
+    std::array<std::thread, maxWorkers> workers;
+    int nWorkers{0};
+
+    Voice *const *jobVoices{nullptr};
+    size_t jobSize{0};
+    bool jobPack{true};
+    int jobSubBlocks{1};
+
+    /*
+     * The cursor packs the job number, its slice count and the next unclaimed slice
+     * into one word, so a claim is a single compare and swap which can only succeed
+     * against the job it read, and acquires that job's fields with it.
+     */
+    static constexpr uint64_t cursorFor(uint32_t job, uint32_t slices, uint32_t next)
+    {
+        return ((uint64_t)job << 32) | ((uint64_t)slices << 16) | next;
+    }
+    alignas(64) std::atomic<uint64_t> cursor{0};
+    alignas(64) std::atomic<uint32_t> completed{0};
+    alignas(64) std::atomic<uint32_t> generation{0};
+    uint32_t job{0};
+    std::atomic<bool> running{false};
+};
+} // namespace baconpaul::six_sines
+#endif // VOICE_RENDER_POOL_H
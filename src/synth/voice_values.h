@@ -20,6 +20,7 @@
 #include <sst/basic-blocks/tables/EqualTuningProvider.h>
 #include <sst/basic-blocks/tables/TwoToTheXProvider.h>
 #include "sst/basic-blocks/dsp/Lag.h"
+#include "sst/basic-blocks/dsp/RNG.h"
 #include "configuration.h"
 
 struct MTSClient;
@@ -28,7 +29,7 @@ namespace baconpaul::six_sines
 {
 struct VoiceValues
 {
-    VoiceValues() : gated(gatedV), key(keyV) {}
+    explicit VoiceValues(uint32_t rngSeed) : gated(gatedV), key(keyV), rng(rngSeed) {}
 
     const bool &gated;
     float gatedFloat{0.f}, ungatedFloat{1.f};
@@ -82,6 +83,11 @@ struct VoiceValues
 
     std::array<float, numMacros> macroOut{};
 
+    // Per-voice RNG for everything a voice draws while rendering (random LFO shapes,
+    // noise). Nodes hold VoiceValues const, hence mutable. Seeded from the mono RNG
+    // at construction so voices are decorrelated.
+    mutable sst::basic_blocks::dsp::RNG rng;
+
   private:
     bool gatedV{false};
     int keyV{0};
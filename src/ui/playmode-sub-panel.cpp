@@ -446,6 +446,10 @@ PlayModeSubPanel::PlayModeSubPanel(SixSinesEditor &e) : HasEditor(e)
         addAndMakeVisible(*slot);
     };
     mkLabel(sampleRateLabel, "Sample Rate:");
+    // A strategy change moves the engine rate, which voices latch at attack, so it
+    // cuts every sounding note. Say so next to the control rather than surprise anyone
+    mkLabel(sampleRateNoteLabel, "Changing stops notes", juce::Justification::centredLeft);
+    sampleRateNoteLabel->setEnabled(false);
     mkLabel(ultrasonicLabel, "Ultrasonic Filter:");
     mkLabel(saturationLabel, "Saturation:");
     mkLabel(lowpassLabel, "Low Pass:");
@@ -615,7 +619,7 @@ void PlayModeSubPanel::resized()
         return row;
     };
 
-    pathCol.add(stageRow(sampleRateLabel, srStrat));
+    pathCol.add(stageRow(sampleRateLabel, srStrat, sampleRateNoteLabel.get()));
     pathCol.add(stageRow(ultrasonicLabel, ultrasonicFilter));
     pathCol.add(stageRow(saturationLabel, satType, satDrive.get()));
     {
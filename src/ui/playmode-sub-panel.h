@@ -144,7 +144,7 @@ struct PlayModeSubPanel : juce::Component, HasEditor
     std::unique_ptr<PatchContinuous> outGainD;
     std::unique_ptr<jcmp::Label> outGainLabel;
 
-    std::unique_ptr<jcmp::Label> sampleRateLabel, downsamplerLabel;
+    std::unique_ptr<jcmp::Label> sampleRateLabel, sampleRateNoteLabel, downsamplerLabel;
     std::unique_ptr<jcmp::Label> saturationLabel, lowpassLabel, bitRateLabel, bitDepthLabel,
         highpassLabel, ultrasonicLabel;
 
@@ -14,6 +14,9 @@
  */
 
 #include "settings-panel.h"
+
+#include <algorithm>
+
 #include "ui-constants.h"
 #include "playmode-sub-panel.h"
 
@@ -21,7 +24,12 @@ namespace baconpaul::six_sines::ui
 {
 SettingsPanel::SettingsPanel(SixSinesEditor &e) : jcmp::NamedPanel("Settings"), HasEditor(e)
 {
-    hasHamburger = false;
+    hasHamburger = true;
+    onHamburger = [w = juce::Component::SafePointer(this)]()
+    {
+        if (w)
+            w->showTimingMenu();
+    };
 
     playScreenD = std::make_unique<
         sst::jucegui::component_adapters::DiscreteToValueReference<jcmp::ToggleButton, bool>>(
@@ -44,6 +52,10 @@ SettingsPanel::SettingsPanel(SixSinesEditor &e) : jcmp::NamedPanel("Settings"),
     cpuLabel = std::make_unique<jcmp::Label>();
     cpuLabel->setText("CPU: 0.0%");
     addAndMakeVisible(*cpuLabel);
+
+    timingLabel = std::make_unique<jcmp::Label>();
+    timingLabel->setText("p99: -");
+    addAndMakeVisible(*timingLabel);
 }
 
 SettingsPanel::~SettingsPanel() = default;
@@ -59,9 +71,94 @@ void SettingsPanel::resized()
     int labelX = btnX + settingsBtnSize + 2 * uicMargin;
     int labelW = sb.getRight() - labelX;
     int labelH = uicLabelHeight;
-    int labelsY = sb.getY() + (sb.getHeight() - 2 * labelH) / 2;
+    int labelsY = sb.getY() + (sb.getHeight() - 3 * labelH) / 2;
     voiceCount->setBounds(labelX, labelsY, labelW, labelH);
     cpuLabel->setBounds(labelX, labelsY + labelH, labelW, labelH);
+    timingLabel->setBounds(labelX, labelsY + 2 * labelH, labelW, labelH);
+}
+
+void SettingsPanel::updateTiming()
+{
+    auto s = editor.processTiming.buffer.summary();
+    if (s.count == 0)
+        return;
+    auto txt = fmt::format("p99: {} % max: {} %", std::round(s.p99 * 100), std::round(s.max * 100));
+    if (txt != timingLabel->getText())
+    {
+        timingLabel->setText(txt);
+        repaint();
+    }
+}
+
+void SettingsPanel::setNodeProfile(uint32_t category, float percent)
+{
+    if (category < node_profiler::numCategories)
+        nodeProfile[category] = percent;
+}
+
+void SettingsPanel::showTimingMenu()
+{
+    auto &timing = editor.processTiming;
+
+    auto p = juce::PopupMenu();
+    p.addSectionHeader("Share of Realtime Used");
+    p.addSeparator();
+    auto addSummary = [&p](const std::string &name, const TimingHistogram &h)
+    {
+        auto s = h.summary();
+        if (s.count == 0)
+        {
+            p.addItem(name + ": -", false, false, []() {});
+            return;
+        }
+        p.addItem(fmt::format("{}: p50 {:.0f} %  p99 {:.0f} %  max {:.0f} %", name, s.p50 * 100,
+                              s.p99 * 100, s.max * 100),
+                  false, false, []() {});
+        if (h.hasDeadline)
+            p.addItem(fmt::format("    {} of {} over {:.0f} %, {} late", s.over, s.count,
+                                  h.getOverThreshold() * 100, s.late),
+                      false, false, []() {});
+    };
+    addSummary("Host Buffers", timing.buffer);
+    p.addSeparator();
+    p.addSectionHeader("Relative Block Cost");
+    addSummary("Engine Blocks", timing.block);
+    addSummary("Note Attacks", timing.attack);
+    p.addSeparator();
+
+    // Only the host buffers have a deadline to be over
+    auto thresholds = juce::PopupMenu();
+    auto current = std::round(timing.buffer.getOverThreshold() * 100);
+    for (auto pct : {50, 65, 80, 90})
+    {
+        thresholds.addItem(fmt::format("{} %", pct), true, current == pct,
+                           [&timing, pct]()
+                           {
+                               timing.buffer.setOverThreshold(pct * 0.01);
+                               timing.requestReset();
+                           });
+    }
+    p.addSubMenu("Over Budget Above", thresholds);
+    p.addItem("Reset Timing", [&timing]() { timing.requestReset(); });
+
+    if constexpr (node_profiler::enabled)
+    {
+        std::array<int, node_profiler::numCategories> order;
+        for (uint32_t i = 0; i < node_profiler::numCategories; ++i)
+            order[i] = (int)i;
+        std::stable_sort(order.begin(), order.end(),
+                         [this](auto a, auto b) { return nodeProfile[a] > nodeProfile[b]; });
+
+        p.addSeparator();
+        p.addSectionHeader("Engine Time by Category");
+        for (auto c : order)
+        {
+            p.addItem(fmt::format("{:.1f} %  {}", nodeProfile[c],
+                                  node_profiler::categoryName((node_profiler::Category)c)),
+                      false, false, []() {});
+        }
+    }
+    p.showMenuAsync(juce::PopupMenu::Options().withParentComponent(&editor));
 }
 
 void SettingsPanel::beginEdit()
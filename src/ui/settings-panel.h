@@ -21,7 +21,9 @@
 #include <sst/jucegui/components/ToggleButton.h>
 #include <sst/jucegui/component-adapters/DiscreteToReference.h>
 #include <fmt/core.h>
+#include <array>
 #include "six-sines-editor.h"
+#include "synth/node_profiler.h"
 
 namespace baconpaul::six_sines::ui
 {
@@ -49,6 +51,16 @@ struct SettingsPanel : jcmp::NamedPanel, HasEditor
     std::unique_ptr<jcmp::Label> cpuLabel;
     double lastCpu{-2000};
 
+    // Tail latency from the engine's ProcessTiming: the label shows the host buffers' p99
+    // and worst share of their deadline, and the hamburger has the full breakdown
+    void updateTiming();
+    void showTimingMenu();
+    std::unique_ptr<jcmp::Label> timingLabel;
+
+    // Profiler view, in SIX_SINES_NODE_PROFILING builds only, listed in the hamburger
+    void setNodeProfile(uint32_t category, float percent);
+    std::array<float, node_profiler::numCategories> nodeProfile{};
+
     bool isPlayScreenShowing{false};
     bool suppressPowerOff{false};
     jcmp::ToggleButton *playScreen{nullptr};
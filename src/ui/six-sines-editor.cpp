@@ -117,13 +117,14 @@ static constexpr sheet_t::Class PatchMenu("six-sines.patch-menu");
 
 SixSinesEditor::SixSinesEditor(Patch &patchMain, Synth::audioToMainQueue_t &atou,
                                Synth::mainToAudioQueue_T &utoa, Synth::audioOutputQueue_t &aor,
-                               std::atomic<bool> &editorActiveIn,
+                               ProcessTiming &pt, std::atomic<bool> &editorActiveIn,
                                std::atomic<uint32_t> &uiForceRebuildIn,
                                Synth::DawStateMain &dawStateMain, defaultsProvder_t &defaults,
                                const clap_host_t *h)
     : jcmp::WindowPanel(true), patchMainRef(patchMain), audioToMain(atou), mainToAudio(utoa),
-      audioOutputRing(aor), editorActive(editorActiveIn), uiForceRebuild(uiForceRebuildIn),
-      dawStateMainRef(dawStateMain), defaultsProvider(&defaults), clapHost(h)
+      audioOutputRing(aor), processTiming(pt), editorActive(editorActiveIn),
+      uiForceRebuild(uiForceRebuildIn), dawStateMainRef(dawStateMain), defaultsProvider(&defaults),
+      clapHost(h)
 {
     lastForceRebuild = uiForceRebuild.load();
     setTitle("Six Sines - an Audio Rate Modulation Synthesizer");
@@ -390,6 +391,11 @@ void SixSinesEditor::idle()
         else if (aum->action == Synth::AudioToMainMsg::UPDATE_CPU_USAGE)
         {
             settingsPanel->setCpuUsage(aum->value);
+            settingsPanel->updateTiming();
+        }
+        else if (aum->action == Synth::AudioToMainMsg::UPDATE_NODE_PROFILE)
+        {
+            settingsPanel->setNodeProfile(aum->paramId, aum->value);
         }
         else if (aum->action == Synth::AudioToMainMsg::MTS_POINTER)
         {
@@ -905,6 +911,104 @@ void SixSinesEditor::showPresetPopup()
                });
     p.addSubMenu("Design Mode", dm);
 
+    auto tm = juce::PopupMenu();
+    auto prefThreads = defaultsProvider->getUserDefaultValue(Defaults::renderWorkerThreads, 0);
+    auto hwThreads = std::max((int)std::thread::hardware_concurrency() - 1, 0);
+    tm.addSectionHeader("Applies to newly loaded instances");
+    for (int i = 0; i <= std::min(VoiceRenderPool::maxWorkers, hwThreads); ++i)
+    {
+        tm.addItem(i == 0 ? "Audio thread only" : std::to_string(i) + " extra threads", true,
+                   prefThreads == i,
+                   [w = juce::Component::SafePointer(this), i]()
+                   {
+                       if (!w)
+                           return;
+                       w->defaultsProvider->updateUserDefaultValue(Defaults::renderWorkerThreads,
+                                                                   i);
+                   });
+    }
+    p.addSubMenu("Voice Render Threads", tm);
+
+    auto bm = juce::PopupMenu();
+    bm.addSectionHeader("Applies to newly loaded instances");
+    bm.addSectionHeader("Voice blocks per pass");
+    auto prefMacro = defaultsProvider->getUserDefaultValue(Defaults::macroRenderBlocks, 1);
+    for (int i = 1; i <= (int)maxMacroBlocks; i *= 2)
+    {
+        bm.addItem(i == 1 ? "1 (events on every block)" : std::to_string(i), true, prefMacro == i,
+                   [w = juce::Component::SafePointer(this), i]()
+                   {
+                       if (!w)
+                           return;
+                       w->defaultsProvider->updateUserDefaultValue(Defaults::macroRenderBlocks, i);
+                   });
+    }
+    bm.addSectionHeader("Blocks per libsamplerate call");
+    auto prefBatch = defaultsProvider->getUserDefaultValue(Defaults::srcBatchBlocks, 1);
+    for (int i = 1; i <= (int)maxSRCBatchBlocks; i *= 2)
+    {
+        bm.addItem(std::to_string(i), true, prefBatch == i,
+                   [w = juce::Component::SafePointer(this), i]()
+                   {
+                       if (!w)
+                           return;
+                       w->defaultsProvider->updateUserDefaultValue(Defaults::srcBatchBlocks, i);
+                   });
+    }
+    bm.addSectionHeader("Sine and TX waveforms");
+    auto prefPoly = defaultsProvider->getUserDefaultValue(Defaults::polySineBackend, false);
+    for (auto poly : {false, true})
+    {
+        bm.addItem(poly ? "Polynomial (no table reads)" : "Table lookup", true, prefPoly == poly,
+                   [w = juce::Component::SafePointer(this), poly]()
+                   {
+                       if (!w)
+                           return;
+                       w->defaultsProvider->updateUserDefaultValue(Defaults::polySineBackend,
+                                                                   poly);
+                   });
+    }
+    p.addSubMenu("Render Batching", bm);
+
+    auto sm = juce::PopupMenu();
+    auto prefSleep = defaultsProvider->getUserDefaultValue(Defaults::voiceSleepThresholdDb,
+                                                           Synth::defaultVoiceSleepThresholdDb);
+    for (auto db : {0, -90, -120, -144})
+    {
+        sm.addItem(db == 0 ? "Never" : "Below " + std::to_string(db) + " dB", true,
+                   prefSleep == db,
+                   [w = juce::Component::SafePointer(this), db]()
+                   {
+                       if (!w)
+                           return;
+                       w->defaultsProvider->updateUserDefaultValue(Defaults::voiceSleepThresholdDb,
+                                                                   db);
+                       w->mainToAudio.push(
+                           {Synth::MainToAudioMsg::SET_VOICE_SLEEP_THRESHOLD, 0, (float)db});
+                   });
+    }
+    p.addSubMenu("Retire Silent Voices", sm);
+
+    auto em = juce::PopupMenu();
+    auto prefTiming = defaultsProvider->getUserDefaultValue(
+        Defaults::eventTiming, (int)Synth::BLOCK_EVENTS);
+    em.addSectionHeader("Sample accurate notes sound a few samples later");
+    for (auto [t, n] : {std::make_pair(Synth::BLOCK_EVENTS, "Engine block (lightest)"),
+                        std::make_pair(Synth::SAMPLE_ACCURATE_OFFLINE,
+                                       "Sample accurate when rendering offline"),
+                        std::make_pair(Synth::SAMPLE_ACCURATE, "Always sample accurate")})
+    {
+        em.addItem(n, true, prefTiming == t,
+                   [w = juce::Component::SafePointer(this), t = t]()
+                   {
+                       if (!w)
+                           return;
+                       w->defaultsProvider->updateUserDefaultValue(Defaults::eventTiming, (int)t);
+                       w->mainToAudio.push({Synth::MainToAudioMsg::SET_EVENT_TIMING, 0, (float)t});
+                   });
+    }
+    p.addSubMenu("Event Timing", em);
+
     p.addSeparator();
     p.addItem(spectrumWindow ? "Hide Analyzer" : "Show Analyzer",
               [w = juce::Component::SafePointer(this)]()
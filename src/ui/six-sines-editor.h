@@ -85,6 +85,8 @@ struct SixSinesEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<S
     Synth::audioToMainQueue_t &audioToMain;
     Synth::mainToAudioQueue_T &mainToAudio;
     Synth::audioOutputQueue_t &audioOutputRing;
+    // The engine's tail latency histograms, lock free to read from here
+    ProcessTiming &processTiming;
     // Set true while this editor idles (owns draining audioToMain); gates the audio thread's
     // telemetry pushes and its request for onMainThread to drain.
     std::atomic<bool> &editorActive;
@@ -96,9 +98,9 @@ struct SixSinesEditor : jcmp::WindowPanel, sst::jucegui::screens::ScreenHolder<S
 
     SixSinesEditor(Patch &patchMain, Synth::audioToMainQueue_t &atou,
                    Synth::mainToAudioQueue_T &utoa, Synth::audioOutputQueue_t &aor,
-                   std::atomic<bool> &editorActive, std::atomic<uint32_t> &uiForceRebuild,
-                   Synth::DawStateMain &dawStateMain, defaultsProvder_t &defaults,
-                   const clap_host_t *ch);
+                   ProcessTiming &processTiming, std::atomic<bool> &editorActive,
+                   std::atomic<uint32_t> &uiForceRebuild, Synth::DawStateMain &dawStateMain,
+                   defaultsProvder_t &defaults, const clap_host_t *ch);
     virtual ~SixSinesEditor();
 
     // Rebuild every widget from patchMainRef after an out-of-band load (host stateLoad / preset).
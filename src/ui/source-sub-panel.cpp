@@ -62,6 +62,8 @@ struct WavPainter : juce::Component
         g.setColour(gridCol);
         g.drawHorizontalLine(getHeight() / 2, 0, getWidth());
 
+        // We're on the main thread, so build the table now rather than via a note's request
+        SinTable::prepareWaveForm(wfVal);
         st.setWaveForm(wfVal);
         uint32_t phase{0};
         phase += (1 << 26) * ph.value;
@@ -200,6 +202,7 @@ struct PDWavPainter : juce::Component
         g.drawHorizontalLine(waveBox.getY() + waveBox.getHeight() / 2, waveBox.getX(),
                              waveBox.getRight());
 
+        SinTable::prepareWaveForm(wfVal);
         st.setWaveForm(wfVal);
         uint32_t phs{0};
         phs += (1 << 26) * ph.value;
@@ -270,12 +273,15 @@ struct ResSweepPlotter : juce::Component
         switch (rw)
         {
         case RW::BLACKMAN_HARRIS:
+            SinTable::prepareWaveForm(SinTable::BLACKMAN_HARRIS_WINDOW);
             stWindow.setWaveForm(SinTable::BLACKMAN_HARRIS_WINDOW);
             break;
         case RW::TUKEY:
+            SinTable::prepareWaveForm(SinTable::TUKEY_WINDOW);
             stWindow.setWaveForm(SinTable::TUKEY_WINDOW);
             break;
         default:
+            SinTable::prepareWaveForm(SinTable::HANN_WINDOW);
             stWindow.setWaveForm(SinTable::HANN_WINDOW);
             break;
         }
@@ -336,6 +342,7 @@ struct ResSweepPlotter : juce::Component
             g.drawVerticalLine(x, midY - halfTick, midY + halfTick);
         }
 
+        SinTable::prepareWaveForm(wfVal);
         st.setWaveForm(wfVal);
         syncWindowTable();
         using RW = Patch::SourceNode::ResonantSweepWindow;
@@ -470,6 +477,7 @@ struct NoisePainter : juce::Component
             g.drawVerticalLine(x, midY - halfTick, midY + halfTick);
         }
 
+        SinTable::prepareWaveForm(wfVal);
         st.setWaveForm(wfVal);
 
         using NM = Patch::SourceNode::NoiseMode;
@@ -37,6 +37,12 @@ enum Defaults
     defaultMPEBend,        // int semitones; seeds DawExtraState.mpeBendRange on engine init
     defaultMIDISmoothing,  // ms, stored as string; seeds midiCCSmoothingTimeMs
     defaultParamSmoothing, // ms, stored as string; seeds paramAutomationSmoothingTimeMs
+    renderWorkerThreads,   // int; extra voice render threads, 0 = audio thread only
+    voiceSleepThresholdDb, // int dB; silent voices retire early below this, 0 = never
+    eventTiming,           // int Synth::EventTiming
+    macroRenderBlocks,     // int; Synth::macroBlocks, blocks each voice renders per pass
+    srcBatchBlocks,        // int; Synth::srcBatchBlocks, engine blocks per libsamplerate call
+    polySineBackend,       // bool; MonoValues::polySine, polynomial rather than table sines
     numDefaults
 };
 
@@ -76,6 +82,18 @@ inline std::string defaultName(Defaults d)
         return "defaultMIDISmoothing";
     case defaultParamSmoothing:
         return "defaultParamSmoothing";
+    case renderWorkerThreads:
+        return "renderWorkerThreads";
+    case voiceSleepThresholdDb:
+        return "voiceSleepThresholdDb";
+    case eventTiming:
+        return "eventTiming";
+    case macroRenderBlocks:
+        return "macroRenderBlocks";
+    case srcBatchBlocks:
+        return "srcBatchBlocks";
+    case polySineBackend:
+        return "polySineBackend";
     case numDefaults:
     {
         SXSNLOG("Software Error - defaults found");
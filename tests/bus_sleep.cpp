@@ -0,0 +1,108 @@
+/*
+ * Multi-out operator bus sleep.
+ *
+ * An operator bus with nothing routed to it stops being resampled once its
+ * input has been silent for Synth::busSleepSeconds, outputs zeros and is
+ * reported in silentBusMask. When a voice routes to it again it wakes on the
+ * main bus's resampler clock, so its output matches a bus which never slept.
+ */
+
+#include "catch2/catch2.hpp"
+#include "test_synth_setup.h"
+
+#include "configuration.h"
+#include "synth/patch.h"
+#include "synth/synth.h"
+
+#include <climits>
+#include <cmath>
+#include <memory>
+
+using namespace baconpaul::six_sines;
+
+namespace
+{
+std::unique_ptr<Synth> bringUpMultiOut(ResamplerEngine engine)
+{
+    test::TestSynthSetup setup;
+    setup.multiOut = true;
+    setup.engine = engine;
+    setup.playingOps = 2;
+    return test::bringUpTestSynth(setup);
+}
+
+int blocksFor(const Synth &s, double seconds)
+{
+    return (int)std::ceil(seconds * s.hostSampleRate / blockSize);
+}
+} // namespace
+
+TEST_CASE("idle operator buses sleep and output silence", "[bus_sleep]")
+{
+    for (auto engine : {SRC_FAST, LANCZOS, POLYPHASE})
+    {
+        DYNAMIC_SECTION("Engine " << engine)
+        {
+            auto s = bringUpMultiOut(engine);
+            s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+            for (int blk = 0; blk < blocksFor(*s, 2 * Synth::busSleepSeconds); ++blk)
+                s->process(nullptr);
+
+            // Ops 1 and 2 play out of buses 1 and 2; the other operator buses are idle
+            auto mask = s->silentBusMask();
+            REQUIRE((mask & 0x7) == 0);
+            for (int rsi = 3; rsi < 1 + (int)numOps; ++rsi)
+            {
+                INFO("Bus " << rsi);
+                REQUIRE((mask & (1U << rsi)) != 0);
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    REQUIRE(s->output[2 * rsi][i] == 0.f);
+                    REQUIRE(s->output[2 * rsi + 1][i] == 0.f);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("a woken bus matches one which never slept", "[bus_sleep]")
+{
+    for (auto engine : {SRC_FAST, SRC_BEST, LANCZOS, ZOH, POLYPHASE, POLYPHASE_HQ})
+    {
+        DYNAMIC_SECTION("Engine " << engine)
+        {
+            auto sleepy = bringUpMultiOut(engine);
+            auto awake = bringUpMultiOut(engine);
+            awake->busSleepFrames = INT_MAX;
+
+            // A strange number of blocks so the wake lands off any resampler grid
+            for (int blk = 0; blk < blocksFor(*sleepy, 2 * Synth::busSleepSeconds) + 3; ++blk)
+            {
+                sleepy->process(nullptr);
+                awake->process(nullptr);
+            }
+            REQUIRE(sleepy->silentBusMask() != 0);
+            REQUIRE(awake->silentBusMask() == 0);
+
+            for (auto *s : {sleepy.get(), awake.get()})
+                s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+
+            bool anyNonZero{false};
+            for (int blk = 0; blk < 400; ++blk)
+            {
+                sleepy->process(nullptr);
+                awake->process(nullptr);
+                for (int c = 0; c < 2 * (1 + (int)numOps); ++c)
+                {
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        INFO("block " << blk << " channel " << c << " sample " << i);
+                        REQUIRE(sleepy->output[c][i] == Approx(awake->output[c][i]).margin(1e-6));
+                        anyNonZero = anyNonZero || (c >= 2 && sleepy->output[c][i] != 0.f);
+                    }
+                }
+            }
+            REQUIRE(anyNonZero);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Sample accurate event timing.
+ *
+ * With sample accurate events a note scheduled at a host offset starts on the
+ * matching engine sample, delaying its voices into the engine block, so moving
+ * the note by some host samples moves the rendered output by the same amount.
+ */
+
+#include "catch2/catch2.hpp"
+#include "test_synth_setup.h"
+
+#include "configuration.h"
+#include "synth/patch.h"
+#include "synth/synth.h"
+
+#include <memory>
+#include <vector>
+
+using namespace baconpaul::six_sines;
+
+namespace
+{
+std::unique_ptr<Synth> bringUpScheduling(ResamplerEngine engine)
+{
+    test::TestSynthSetup setup;
+    setup.engine = engine;
+    setup.strategy = SR_176192;
+    auto s = test::bringUpTestSynth(setup);
+
+    s->eventTiming = Synth::SAMPLE_ACCURATE;
+    auto *sp = s.get();
+    s->dispatchEvent = [sp](const clap_event_header_t *e)
+    {
+        if (e->type == CLAP_EVENT_NOTE_ON)
+        {
+            auto *n = reinterpret_cast<const clap_event_note_t *>(e);
+            sp->voiceManager->processNoteOnEvent(n->port_index, n->channel, n->key,
+                                                 n->note_id, n->velocity, 0.f);
+        }
+    };
+    return s;
+}
+
+// The left channel of a note scheduled hostOffset into the fourth host block
+std::vector<float> renderScheduledNote(ResamplerEngine engine, int hostOffset)
+{
+    auto s = bringUpScheduling(engine);
+    for (int blk = 0; blk < 3; ++blk)
+        s->process(nullptr);
+    REQUIRE(s->eventLatency >= 0);
+
+    clap_event_note_t n{};
+    n.header.size = sizeof(clap_event_note_t);
+    n.header.type = CLAP_EVENT_NOTE_ON;
+    n.header.time = (uint32_t)hostOffset;
+    n.port_index = 0;
+    n.channel = 0;
+    n.key = 60;
+    n.note_id = -1;
+    n.velocity = 0.8;
+    s->scheduleEvent(&n.header, hostOffset);
+
+    std::vector<float> res;
+    for (int blk = 0; blk < 100; ++blk)
+    {
+        s->process(nullptr);
+        res.insert(res.end(), s->output[0], s->output[0] + blockSize);
+    }
+    return res;
+}
+} // namespace
+
+TEST_CASE("scheduled notes land on their host sample", "[event_timing]")
+{
+    for (auto engine : {POLYPHASE, LANCZOS})
+    {
+        DYNAMIC_SECTION("Engine " << engine)
+        {
+            auto ref = renderScheduledNote(engine, 0);
+            bool anyNonZero{false};
+            for (auto v : ref)
+                anyNonZero = anyNonZero || v != 0.f;
+            REQUIRE(anyNonZero);
+
+            for (int o = 1; o < 8; ++o)
+            {
+                auto moved = renderScheduledNote(engine, o);
+                for (int i = 0; i < o; ++i)
+                    REQUIRE(moved[i] == Approx(0.f).margin(1e-5));
+                for (size_t i = o; i < ref.size(); ++i)
+                {
+                    INFO("offset " << o << " sample " << i);
+                    REQUIRE(moved[i] == Approx(ref[i - o]).margin(1e-5));
+                }
+            }
+        }
+    }
+}
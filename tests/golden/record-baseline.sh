@@ -0,0 +1,83 @@
+#!/usr/bin/env bash
+# Record tests/golden/golden_audio.txt from the engine as it stood before the
+# performance work, so the golden gate shows that work kept the sound.
+#
+# Usage:
+#   tests/golden/record-baseline.sh [baseline-commit] [build-dir]
+#
+# The baseline commit (default 9c29de5) is checked out in a scratch worktree,
+# given the seedable Synth constructor from baseline-seed.patch (the random
+# streams are otherwise different every run), and this tree's golden_audio.cpp
+# is built against it with SIX_SINES_GOLDEN_BASELINE set. That records every
+# row the baseline can play the same way as this tree. The rest are then
+# recorded from this tree's six-sines-golden in build-dir (default build)
+# with SIX_SINES_GOLDEN_RECORD=missing, on the same machine so the platform
+# line holds for both:
+#   - the rows for features the baseline doesn't have
+#   - the rows which use random numbers. Voices draw from streams of their
+#     own now, seeded from the mono stream, so noise, random LFOs, random
+#     mod sources and unison starting phases all changed on purpose. The
+#     baseline skips any render a second seed changes.
+#
+# build-dir has to be configured already, as a Release build like the
+# baseline's. CI runs this whenever golden_audio.txt has no entries.
+#
+# Env vars:
+#   CMAKE_ARGS="-GNinja"   extra configure arguments for the baseline build
+
+set -euo pipefail
+
+BASELINE="${1:-9c29de55c9616ad52894bcfa80ed414be97527cc}"
+BUILD="${2:-build}"
+
+ROOT="$(git rev-parse --show-toplevel)"
+GOLDEN="$ROOT/tests/golden/golden_audio.txt"
+WORK="$(mktemp -d)"
+cleanup()
+{
+    git -C "$ROOT" worktree remove --force "$WORK/baseline" 2>/dev/null || true
+    rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+# A shallow clone doesn't have it
+git -C "$ROOT" cat-file -e "$BASELINE^{commit}" 2>/dev/null ||
+    git -C "$ROOT" fetch --quiet origin "$BASELINE"
+git -C "$ROOT" worktree add --detach "$WORK/baseline" "$BASELINE"
+cd "$WORK/baseline"
+git submodule update --init --recursive
+git apply "$ROOT/tests/golden/baseline-seed.patch"
+
+cp "$ROOT/tests/golden_audio.cpp" "$ROOT/tests/perf_scenario_setup.h" tests/
+mkdir -p tests/golden
+: > tests/golden/golden_audio.txt
+cat >> tests/CMakeLists.txt <<'EOF'
+
+add_executable(six-sines-golden
+		test_main.cpp
+		golden_audio.cpp
+)
+target_link_libraries(six-sines-golden
+		fmt
+		six-sines-impl
+		catch2
+		six-sines-patches
+)
+target_compile_definitions(six-sines-golden PRIVATE
+		SIX_SINES_GOLDEN_BASELINE=1
+		SIX_SINES_GOLDEN_FILE="${CMAKE_CURRENT_SOURCE_DIR}/golden/golden_audio.txt")
+EOF
+
+# shellcheck disable=SC2086
+cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DCOPY_AFTER_BUILD=FALSE ${CMAKE_ARGS:-}
+cmake --build build --config Release --target six-sines-golden --parallel
+SIX_SINES_GOLDEN_RECORD=1 ./build/tests/six-sines-golden
+cp tests/golden/golden_audio.txt "$GOLDEN"
+
+cd "$ROOT"
+cmake --build "$BUILD" --config Release --target six-sines-golden --parallel
+SIX_SINES_GOLDEN_RECORD=missing "$BUILD/tests/six-sines-golden"
+# And the whole file has to pass against this tree
+"$BUILD/tests/six-sines-golden"
+
+echo "Recorded $GOLDEN from $BASELINE; commit it"
@@ -0,0 +1,484 @@
+/*
+ * Golden audio: the perf scenario matrix and a handful of factory patches, rendered with
+ * a fixed random seed and checked against tests/golden/golden_audio.txt so DSP and
+ * performance work can't change the sound of a saved session unnoticed.
+ *
+ * On the platform which recorded the file (OS, CPU and compiler, see platformKey) each
+ * render has to hash bit for bit. Elsewhere the length has to match and the points
+ * sampled every sketchStride frames have to agree within goldenUlps.
+ *
+ * The file is recorded from the engine as it stood before the performance work, by
+ * tests/golden/record-baseline.sh, which builds this file against that commit with
+ * SIX_SINES_GOLDEN_BASELINE set and then records the rows the baseline can't play (the
+ * polyphase engine, scheduled note starts, the polynomial sine) from this tree with
+ *
+ *     SIX_SINES_GOLDEN_RECORD=missing ./six-sines-golden
+ *
+ * The renders which use random numbers come from this tree too. The baseline drew every
+ * voice's noise and random LFOs from the one mono stream; each voice now has its own
+ * stream, seeded from the mono one as it is built, which moves every later mono draw as
+ * well (unison starting phases, the random mod sources). That change is on purpose, so
+ * the baseline records only the renders a different seed leaves alone.
+ *
+ * After an intended change of sound, re-record everything and commit the file with it:
+ *
+ *     SIX_SINES_GOLDEN_RECORD=1 ./six-sines-golden
+ *
+ * A render with no recorded golden fails, as does a file with no platform line. The
+ * scenario rows which only change how the engine schedules its work (serial, worker
+ * threads, macro blocks, SRC batching) have no golden of their own; they must hash the
+ * same as the row they mirror.
+ *
+ * Factory patches play their notes straight into the voice manager at block starts, the
+ * way block events land, so the baseline engine renders them the same way.
+ */
+
+#include "catch2/catch2.hpp"
+#include "perf_scenario_setup.h"
+
+#include <cmrc/cmrc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef SIX_SINES_GOLDEN_FILE
+#define SIX_SINES_GOLDEN_FILE "golden_audio.txt"
+#endif
+
+CMRC_DECLARE(sixsines_patches);
+
+using namespace baconpaul::six_sines;
+using namespace baconpaul::six_sines::perf;
+
+namespace
+{
+static constexpr int sketchStride{509};
+static constexpr uint32_t goldenUlps{64};
+static constexpr float goldenAbsFloor{1e-6f}; // below this ulps mean nothing
+static constexpr double heldSeconds{0.25}, releasedSeconds{0.25};
+static constexpr double goldenSampleRate{48000.0}, patchSeconds{6.0};
+
+struct Capture
+{
+    int64_t frames{0};
+    uint64_t hash{0xcbf29ce484222325ull};
+    std::vector<float> points; // L then R at every sketchStride'th frame
+
+    void add(const float *L, const float *R, int n)
+    {
+        for (auto *ch : {L, R})
+        {
+            auto *bytes = reinterpret_cast<const uint8_t *>(ch);
+            for (size_t i = 0; i < n * sizeof(float); ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ull;
+            }
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            if ((frames + i) % sketchStride == 0)
+            {
+                points.push_back(L[i]);
+                points.push_back(R[i]);
+            }
+        }
+        frames += n;
+    }
+};
+
+std::string platformKey()
+{
+    std::ostringstream oss;
+#if defined(__APPLE__)
+    oss << "macos";
+#elif defined(_WIN32)
+    oss << "windows";
+#else
+    oss << "linux";
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+    oss << "-x86_64";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    oss << "-arm64";
+#else
+    oss << "-other";
+#endif
+#if defined(__clang__)
+    oss << "-clang-" << __clang_major__ << "." << __clang_minor__;
+#elif defined(__GNUC__)
+    oss << "-gcc-" << __GNUC__ << "." << __GNUC_MINOR__;
+#elif defined(_MSC_VER)
+    oss << "-msvc-" << _MSC_VER;
+#endif
+    return oss.str();
+}
+
+uint32_t bitsOf(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+float floatOf(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+uint32_t ulpDistance(float a, float b)
+{
+    // Map the sign magnitude bits onto one monotonic integer line
+    auto ordered = [](float f) -> int64_t
+    {
+        auto u = bitsOf(f);
+        return (u & 0x80000000u) ? -(int64_t)(u & 0x7FFFFFFFu) : (int64_t)u;
+    };
+    return (uint32_t)std::min<int64_t>(std::llabs(ordered(a) - ordered(b)), UINT32_MAX);
+}
+
+/*
+ * One line a render after the platform line:
+ *     <key> <frames> <hash> <point count> <points as hex float bits>...
+ */
+struct GoldenFile
+{
+    std::string platform;
+    std::map<std::string, Capture> entries;
+
+    void read(const std::string &path)
+    {
+        std::ifstream f(path);
+        std::string line;
+        while (std::getline(f, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::istringstream iss(line);
+            std::string key;
+            iss >> key;
+            if (key == "platform")
+            {
+                iss >> platform;
+                continue;
+            }
+            Capture c;
+            size_t n{0};
+            iss >> c.frames >> std::hex >> c.hash >> std::dec >> n;
+            for (size_t i = 0; i < n && iss; ++i)
+            {
+                uint32_t u;
+                iss >> std::hex >> u;
+                c.points.push_back(floatOf(u));
+            }
+            if (iss)
+                entries[key] = c;
+        }
+    }
+
+    bool write(const std::string &path) const
+    {
+        std::ofstream f(path);
+        f << "# Golden audio for tests/golden_audio.cpp. Recorded by tests/golden/"
+          << "record-baseline.sh, don't edit\n"
+          << "platform " << platform << "\n";
+        for (const auto &[key, c] : entries)
+        {
+            f << key << " " << c.frames << " " << std::hex << c.hash << std::dec << " "
+              << c.points.size() << std::hex;
+            for (auto p : c.points)
+                f << " " << bitsOf(p);
+            f << std::dec << "\n";
+        }
+        return f.good();
+    }
+};
+
+enum RecordMode
+{
+    CHECK,
+    RECORD_ALL,
+    RECORD_MISSING
+};
+
+RecordMode recordMode()
+{
+    auto *e = std::getenv("SIX_SINES_GOLDEN_RECORD");
+    if (!e || !*e || strcmp(e, "0") == 0)
+        return CHECK;
+    return strcmp(e, "missing") == 0 ? RECORD_MISSING : RECORD_ALL;
+}
+
+GoldenFile &golden()
+{
+    static GoldenFile g = []()
+    {
+        GoldenFile res;
+        res.read(SIX_SINES_GOLDEN_FILE);
+        return res;
+    }();
+    return g;
+}
+
+void checkGolden(const std::string &name, const Capture &c)
+{
+    // Keys are whitespace free, so the patch names lose their spaces
+    auto key = "bs" + std::to_string(blockSize) + "/" + name;
+    std::replace(key.begin(), key.end(), ' ', '_');
+    INFO("Golden audio for " << key);
+    REQUIRE(c.frames > 0);
+
+    auto &g = golden();
+    auto mode = recordMode();
+    if (mode == RECORD_MISSING && !g.platform.empty() && g.platform != platformKey())
+        FAIL("The file was recorded on " << g.platform << "; add to it there");
+    if (mode == RECORD_ALL || (mode == RECORD_MISSING && !g.entries.count(key)))
+    {
+        g.platform = platformKey();
+        g.entries[key] = c;
+        REQUIRE(g.write(SIX_SINES_GOLDEN_FILE));
+        return;
+    }
+    if (mode == RECORD_MISSING)
+        return;
+
+    if (g.platform.empty())
+        FAIL("No golden audio recorded in " << SIX_SINES_GOLDEN_FILE
+                                            << "; see tests/golden/record-baseline.sh");
+    auto it = g.entries.find(key);
+    if (it == g.entries.end())
+        FAIL("No golden audio for " << key << "; see tests/golden/record-baseline.sh");
+
+    auto &want = it->second;
+    REQUIRE(c.frames == want.frames);
+    REQUIRE(c.points.size() == want.points.size());
+    if (g.platform == platformKey())
+    {
+        REQUIRE(c.hash == want.hash);
+        return;
+    }
+
+    uint32_t worst{0};
+    for (size_t i = 0; i < c.points.size(); ++i)
+    {
+        if (std::fabs(c.points[i] - want.points[i]) > goldenAbsFloor)
+            worst = std::max(worst, ulpDistance(c.points[i], want.points[i]));
+    }
+    INFO("Recorded on " << g.platform << ", running on " << platformKey());
+    REQUIRE(worst <= goldenUlps);
+}
+
+// Checks render(scenarioRandomSeed). Recording the baseline, a render which changes with
+// the seed is left for this tree to record, as above
+template <typename F> void checkGoldenRender(const std::string &name, F render)
+{
+    auto c = render(scenarioRandomSeed);
+#if SIX_SINES_GOLDEN_BASELINE
+    if (recordMode() != CHECK && render(scenarioRandomSeed + 1).hash != c.hash)
+    {
+        WARN(name << " uses random numbers; record it from this tree");
+        return;
+    }
+#endif
+    checkGolden(name, c);
+}
+
+Capture renderScenario(const ScenarioSpec &spec, int numVoices, const RunOptions &opts = {},
+                       uint32_t randomSeed = scenarioRandomSeed)
+{
+    auto s = bringUpSynth(spec, numVoices, 48000.0, opts.polySine, randomSeed);
+    applyRunOptions(*s, opts);
+
+    Capture c;
+    auto blocks = [&](double seconds)
+    {
+        for (int i = 0; i < (int)(seconds * s->hostSampleRate / blockSize); ++i)
+        {
+            s->process(nullptr);
+            c.add(s->output[0], s->output[1], blockSize);
+        }
+    };
+    blocks(heldSeconds);
+    for (int v = 0; v < numVoices; ++v)
+        s->voiceManager->processNoteOffEvent(0, 0, 36 + (v % 60), -1, 0.f);
+    blocks(releasedSeconds);
+
+    return c;
+}
+
+Capture renderFactoryPatch(const std::string &patchData, uint32_t randomSeed)
+{
+    struct Note
+    {
+        double start, length;
+        int key, velocity;
+    };
+    static constexpr Note notes[]{{0.00, 0.60, 36, 40},  {0.75, 0.60, 48, 100},
+                                  {1.50, 0.60, 60, 127}, {2.25, 0.60, 72, 64},
+                                  {3.00, 0.60, 84, 100}, {3.75, 1.50, 60, 90},
+                                  {3.75, 1.50, 64, 90},  {3.75, 1.50, 67, 90}};
+    auto blockOf = [](double t) { return (int64_t)(t * goldenSampleRate) / blockSize; };
+
+    auto synth = std::make_unique<Synth>(false, randomSeed);
+    REQUIRE(synth->patch.fromState(patchData));
+#if !SIX_SINES_GOLDEN_BASELINE
+    Synth::prepareWaveFormsFor(synth->patch);
+#endif
+    synth->setSampleRate(goldenSampleRate);
+    synth->postLoad();
+
+    Capture c;
+    auto &vm = synth->voiceManager;
+    for (int64_t b = 0; b < blockOf(patchSeconds); ++b)
+    {
+        // Releases first, so a note retriggered on the same block starts again
+        for (const auto &n : notes)
+            if (blockOf(n.start + n.length) == b)
+                vm->processNoteOffEvent(0, 0, n.key, -1, 0.f);
+        for (const auto &n : notes)
+            if (blockOf(n.start) == b)
+                vm->processNoteOnEvent(0, 0, n.key, -1, n.velocity / 127.f, 0.f);
+        synth->process(nullptr);
+        c.add(synth->output[0], synth->output[1], blockSize);
+    }
+    return c;
+}
+
+ScenarioSpec denseSpec()
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    return spec;
+}
+} // namespace
+
+TEST_CASE("Golden audio: scenario matrix", "[golden]")
+{
+    struct Row
+    {
+        std::string tag;
+        ScenarioSpec spec;
+        int voices;
+        RunOptions opts{};
+        std::string sameAs{}; // a row this only reschedules, so must hash identically
+    };
+    std::vector<Row> rows;
+
+    auto minimal = ScenarioSpec{};
+    rows.push_back({"scn:minimal", minimal, 1});
+    rows.push_back({"scn:1v_dense", denseSpec(), 1});
+    rows.push_back({"scn:8v_dense", denseSpec(), 8});
+    rows.push_back({"scn:32v_dense", denseSpec(), 32});
+    rows.push_back({"scn:64v_dense", denseSpec(), 64});
+
+    auto srcBest = denseSpec();
+    srcBest.resampler = SRC_BEST;
+    rows.push_back({"scn:8v_dense_srcbest", srcBest, 8});
+
+    auto outStages = denseSpec();
+    outStages.outputStages = true;
+    rows.push_back({"scn:8v_dense_outstages", outStages, 8});
+    auto ultrasonic = denseSpec();
+    ultrasonic.ultrasonic = true;
+    rows.push_back({"scn:8v_dense_ultrasonic", ultrasonic, 8});
+
+#if !SIX_SINES_GOLDEN_BASELINE
+    RunOptions serial;
+    serial.voicePack = false;
+    rows.push_back({"scn:32v_dense_serial", denseSpec(), 32, serial, "scn:32v_dense"});
+    RunOptions workers;
+    workers.renderWorkers = 3;
+    rows.push_back({"scn:64v_dense_mt", denseSpec(), 64, workers, "scn:64v_dense"});
+    RunOptions macro;
+    macro.macroBlocks = 4;
+    rows.push_back({"scn:64v_dense_macro4", denseSpec(), 64, macro, "scn:64v_dense"});
+    RunOptions batch;
+    batch.srcBatchBlocks = 8;
+    rows.push_back({"scn:8v_dense_srcbest_batch8", srcBest, 8, batch, "scn:8v_dense_srcbest"});
+
+    // Features the baseline doesn't have, so their goldens come from this tree
+    ultrasonic.resampler = POLYPHASE;
+    rows.push_back({"scn:8v_dense_ultrasonic_poly", ultrasonic, 8});
+    auto delayed = denseSpec();
+    delayed.noteStartDelay = blockSize / 2 + 1;
+    rows.push_back({"scn:8v_dense_delayed", delayed, 8});
+    RunOptions polySine;
+    polySine.voicePack = false;
+    polySine.polySine = true;
+    rows.push_back({"scn:64v_dense_serial_poly", denseSpec(), 64, polySine});
+#endif
+
+    using EM = Patch::SourceNode::ExtendedMode;
+    for (auto [tag, em] : {std::pair{"scn:no_fb_simd", EM::NONE},
+                           std::pair{"scn:em_phaseremap", EM::PHASE_REMAP},
+                           std::pair{"scn:em_resonant", EM::RESONANT_SWEEP},
+                           std::pair{"scn:em_noise", EM::NOISE}})
+    {
+        auto spec = denseSpec();
+        spec.allSelfFB = false;
+        spec.em = em;
+        rows.push_back({tag, spec, 16});
+    }
+    auto worst = denseSpec();
+    worst.em = EM::NOISE;
+    rows.push_back({"scn:worst", worst, 64});
+
+    std::map<std::string, uint64_t> hashes;
+    for (const auto &r : rows)
+    {
+        if (r.sameAs.empty())
+        {
+            checkGoldenRender(r.tag,
+                              [&](uint32_t seed)
+                              {
+                                  auto c = renderScenario(r.spec, r.voices, r.opts, seed);
+                                  if (seed == scenarioRandomSeed)
+                                      hashes[r.tag] = c.hash;
+                                  return c;
+                              });
+        }
+        else
+        {
+            auto c = renderScenario(r.spec, r.voices, r.opts);
+            INFO(r.tag << " against " << r.sameAs);
+            REQUIRE(c.frames > 0);
+            REQUIRE(c.hash == hashes.at(r.sameAs));
+        }
+    }
+}
+
+TEST_CASE("Golden audio: factory patches", "[golden]")
+{
+    // One or two from each corner of the library, MPE and noise based ones included
+    const std::vector<std::string> picks{
+        "Bass/Power Through It",  "Bells/ED2-13 Iso-2 Bells", "Drums/Snare Short",
+        "Effects/Mothership",     "Keys/Out With The New",    "Leads/Cars Sync",
+        "MPE/Exp Bowed Glass",    "Pads/Beauty Grit",
+    };
+
+    auto fs = cmrc::sixsines_patches::get_filesystem();
+    for (const auto &name : picks)
+    {
+        INFO("Patch " << name);
+        auto path = "resources/factory_patches/" + name + ".sxsnp";
+        REQUIRE(fs.exists(path));
+        auto f = fs.open(path);
+        auto data = std::string(f.begin(), f.end());
+        checkGoldenRender("patch:" + name,
+                          [&data](uint32_t seed) { return renderFactoryPatch(data, seed); });
+    }
+}
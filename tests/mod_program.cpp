@@ -0,0 +1,200 @@
+/*
+ * The compiled modulation program (ModulationSupport::compileModulation) has to land
+ * bit for bit where the per slot switch it replaced did. The reference below is that
+ * switch as it stood, for an operator, which carries every op: envelope and lfo SET
+ * targets, scaled ADD targets, ATTEN and EXP2_RATE. Every assignment of targets to
+ * the slots is run, so repeated targets and every order of ops across slots are
+ * covered.
+ */
+
+#include "catch2/catch2.hpp"
+#include "configuration.h"
+#include "synth/mono_values.h"
+#include "synth/patch.h"
+#include "synth/voice_values.h"
+#include "dsp/op_source.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+using namespace baconpaul::six_sines;
+
+namespace
+{
+// The switch the compiled program replaced, kept with its original expressions
+void referenceModulation(OpSource &op, const Patch::SourceNode &sn, MonoValues &mv)
+{
+    op.resetModulation();
+    op.envResetMod();
+    op.lfoResetMod();
+
+    for (int i = 0; i < (int)numModsPer; ++i)
+    {
+        if (!op.sourcePointers[i] ||
+            (int)sn.modtarget[i].value == Patch::SourceNode::TargetID::NONE)
+            continue;
+        auto d = *op.depthPointers[i];
+        auto *s = op.sourcePointers[i];
+
+        switch ((int)sn.modtarget[i].value)
+        {
+        case Patch::DAHDSRMixin::ENV_DELAY:
+            op.delayMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_ATTACK:
+            op.attackMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_HOLD:
+            op.holdMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_DECAY:
+            op.decayMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_SUSTAIN:
+            op.sustainMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_RELEASE:
+            op.releaseMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_ASHAPE:
+            op.aShapeMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_DSHAPE:
+            op.dShapeMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_RSHAPE:
+            op.rShapeMod = d * *s;
+            break;
+        case Patch::DAHDSRMixin::ENV_RATE:
+            op.envRateMul = mv.twoToTheX.twoToThe(3.f * d * *s);
+            break;
+        case Patch::LFOMixin::LFO_RATE:
+            op.lfoRateMod = d * *s * 4;
+            break;
+        case Patch::LFOMixin::LFO_DEFORM:
+            op.lfoDeformMod = d * *s;
+            break;
+        case Patch::LFOMixin::LFO_STARTPHASE:
+            op.lfoStartMod = d * *s;
+            break;
+        case Patch::SourceNode::DIRECT:
+            op.ratioMod += d * *s * 2;
+            break;
+        case Patch::SourceNode::DIRECT_FINE:
+            op.ratioMod += d * *s * 2.0 / 12.0;
+            break;
+        case Patch::SourceNode::STARTING_PHASE:
+            op.phaseMod += d * *s;
+            break;
+        case Patch::SourceNode::ENV_DEPTH_ATTEN:
+            op.envRatioAtten *= 1.0 - d * (1.0 - std::clamp(*s, 0.f, 1.f));
+            break;
+        case Patch::SourceNode::LFO_DEPTH_ATTEN:
+            op.lfoRatioAtten *= 1.0 - d * (1.0 - std::clamp(*s, 0.f, 1.f));
+            break;
+        case Patch::SourceNode::EXTEND_M:
+            op.extendedMMod += d * *s;
+            break;
+        case Patch::SourceNode::EXTEND_N:
+            op.extendedNMod += d * *s;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+std::vector<uint32_t> modulatedBits(const OpSource &op)
+{
+    std::vector<float> v{op.ratioMod,     op.phaseMod,     op.envRatioAtten, op.lfoRatioAtten,
+                         op.extendedMMod, op.extendedNMod, op.delayMod,      op.attackMod,
+                         op.holdMod,      op.decayMod,     op.sustainMod,    op.releaseMod,
+                         op.aShapeMod,    op.dShapeMod,    op.rShapeMod,     op.envRateMul,
+                         op.lfoRateMod,   op.lfoDeformMod, op.lfoStartMod};
+    std::vector<uint32_t> res(v.size());
+    std::memcpy(res.data(), v.data(), v.size() * sizeof(float));
+    return res;
+}
+} // namespace
+
+TEST_CASE("compiled modulation matches the switch dispatch", "[mod_program]")
+{
+    static_assert(numModsPer == 3, "the slot loops below assume three slots");
+
+    auto patch = std::make_unique<Patch>();
+    auto mv = std::make_unique<MonoValues>(0x5eed);
+    auto vv = std::make_unique<VoiceValues>(0x5eed);
+    auto &sn = patch->sourceNodes[0];
+    auto op = std::make_unique<OpSource>(sn, *mv, *vv);
+
+    const std::vector<int> targets{
+        Patch::SourceNode::NONE,
+        Patch::SourceNode::DIRECT,
+        Patch::SourceNode::DIRECT_FINE,
+        Patch::SourceNode::STARTING_PHASE,
+        Patch::SourceNode::ENV_DEPTH_ATTEN,
+        Patch::SourceNode::LFO_DEPTH_ATTEN,
+        Patch::SourceNode::EXTEND_M,
+        Patch::SourceNode::EXTEND_N,
+        Patch::DAHDSRMixin::ENV_DELAY,
+        Patch::DAHDSRMixin::ENV_ATTACK,
+        Patch::DAHDSRMixin::ENV_HOLD,
+        Patch::DAHDSRMixin::ENV_DECAY,
+        Patch::DAHDSRMixin::ENV_SUSTAIN,
+        Patch::DAHDSRMixin::ENV_RELEASE,
+        Patch::DAHDSRMixin::ENV_ASHAPE,
+        Patch::DAHDSRMixin::ENV_DSHAPE,
+        Patch::DAHDSRMixin::ENV_RSHAPE,
+        Patch::DAHDSRMixin::ENV_RATE,
+        Patch::LFOMixin::LFO_RATE,
+        Patch::LFOMixin::LFO_DEFORM,
+        Patch::LFOMixin::LFO_STARTPHASE};
+
+    // Long mantissas, so a reordered expression has rounding to show, and a source past 1
+    // and below 0 so the ATTEN clamp is exercised
+    const float depths[numModsPer]{0.337f, -0.71f, 0.9999f};
+    const float sourcesA[numModsPer]{0.4142135f, -0.577f, 0.7310586f};
+    const float sourcesB[numModsPer]{1.3f, 0.123457f, -0.0999f};
+
+    float sources[numModsPer];
+    for (int i = 0; i < (int)numModsPer; ++i)
+    {
+        sn.moddepth[i].value = depths[i];
+        op->sourcePointers[i] = &sources[i];
+    }
+    op->anySources = true;
+
+    int checked{0};
+    for (const auto *srcSet : {sourcesA, sourcesB})
+    {
+        std::copy(srcSet, srcSet + numModsPer, sources);
+        for (auto t0 : targets)
+        {
+            for (auto t1 : targets)
+            {
+                for (auto t2 : targets)
+                {
+                    sn.modtarget[0].value = t0;
+                    sn.modtarget[1].value = t1;
+                    sn.modtarget[2].value = t2;
+
+                    op->compileModulation();
+                    op->calculateModulation();
+                    auto compiled = modulatedBits(*op);
+
+                    referenceModulation(*op, sn, *mv);
+                    auto reference = modulatedBits(*op);
+
+                    INFO("Targets " << t0 << " " << t1 << " " << t2);
+                    REQUIRE(compiled == reference);
+                    checked++;
+                }
+            }
+        }
+    }
+    REQUIRE(checked == 2 * (int)(targets.size() * targets.size() * targets.size()));
+}
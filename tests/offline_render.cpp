@@ -0,0 +1,180 @@
+/*
+ * Headless offline rendering (six-sines-render).
+ *
+ * The note list and MIDI file readers turn their input into MIDI 1 messages at
+ * host sample times, and renderScore plays a score through a synth prepared from
+ * patch data until it has rung out. Batch renders fingerprint the same whatever the
+ * thread count, and the fingerprint CSV reads back as it was written.
+ */
+
+#include "catch2/catch2.hpp"
+#include "configuration.h"
+#include "synth/patch.h"
+#include "synth/synth.h"
+#include "render/offline-renderer.h"
+#include "render/batch-renderer.h"
+
+#include <cmath>
+#include <filesystem>
+#include <memory>
+
+using namespace baconpaul::six_sines;
+
+TEST_CASE("note list reads into a sorted score", "[offline_render]")
+{
+    render::Score s;
+    std::string err;
+    auto text = "# a phrase\n"
+                "note 0.5 0.25 62 90 3  # on channel 3\n"
+                "note 0 0.5 60\n"
+                "cc 0.1 74 64\n"
+                "bend 0.2 -8192\n";
+    REQUIRE(render::parseNoteList(text, 48000.0, s, err));
+    REQUIRE(s.events.size() == 6);
+
+    auto is = [&](int i, int64_t sample, uint8_t a, uint8_t b, uint8_t c)
+    {
+        INFO("Event " << i);
+        REQUIRE(s.events[i].sample == sample);
+        REQUIRE(s.events[i].data[0] == a);
+        REQUIRE(s.events[i].data[1] == b);
+        REQUIRE(s.events[i].data[2] == c);
+    };
+    is(0, 0, 0x90, 60, 100);
+    is(1, 4800, 0xB0, 74, 64);
+    is(2, 9600, 0xE0, 0, 0);
+    // The note off sorts ahead of the note on sharing its sample
+    is(3, 24000, 0x80, 60, 0);
+    is(4, 24000, 0x93, 62, 90);
+    is(5, 36000, 0x83, 62, 0);
+
+    render::Score bad;
+    REQUIRE(!render::parseNoteList("note 0 1 128\n", 48000.0, bad, err));
+    REQUIRE(err.find("Line 1") != std::string::npos);
+    REQUIRE(!render::parseNoteList("\nnote 0 1 60 100 16\n", 48000.0, bad, err));
+    REQUIRE(err.find("Line 2") != std::string::npos);
+    REQUIRE(!render::parseNoteList("chord 0 1\n", 48000.0, bad, err));
+}
+
+TEST_CASE("MIDI file follows the tempo map", "[offline_render]")
+{
+    // Format 0 at 96 ticks a quarter. 60bpm, a note at 0 released by a running status
+    // note on at velocity 0 on beat 2, then 120bpm, a program change and a note on beat 3
+    std::vector<uint8_t> track{0,    0xFF, 0x51, 3,    0x0F, 0x42, 0x40, 0,    0x90, 60,
+                               100,  0x60, 60,   0,    0,    0xFF, 0x51, 3,    0x07, 0xA1,
+                               0x20, 0x60, 0x90, 62,   90,   0,    0xC0, 5,    0x81, 0x00,
+                               0x80, 62,   0,    0,    0xFF, 0x2F, 0};
+    std::vector<uint8_t> file{'M', 'T', 'h', 'd', 0,   0,   0,   6, 0, 0, 0, 1, 0, 96,
+                              'M', 'T', 'r', 'k', 0,   0,   0,   (uint8_t)track.size()};
+    file.insert(file.end(), track.begin(), track.end());
+
+    render::Score s;
+    std::string err;
+    REQUIRE(render::parseMidiFile(file, 48000.0, s, err));
+    REQUIRE(s.events.size() == 4);
+    REQUIRE(s.events[0].sample == 0);
+    REQUIRE(s.events[1].sample == 48000);
+    REQUIRE(s.events[1].data[2] == 0);
+    REQUIRE(s.events[2].sample == 72000);
+    REQUIRE(s.events[3].sample == 104000);
+
+    file.resize(file.size() - 5);
+    REQUIRE(!render::parseMidiFile(file, 48000.0, s, err));
+    REQUIRE(!render::parseMidiFile({'R', 'I', 'F', 'F'}, 48000.0, s, err));
+}
+
+TEST_CASE("a score renders from patch data and rings out", "[offline_render]")
+{
+    std::string patchData;
+    {
+        auto src = std::make_unique<Synth>(false);
+        auto &p = src->patch;
+        p.output.level.value = 0.5f;
+        p.sourceNodes[0].active.value = 1.f;
+        p.mixerNodes[0].active.value = 1.f;
+        p.mixerNodes[0].level.value = 0.5f;
+        patchData = p.toState();
+    }
+
+    auto synth = std::make_unique<Synth>(false);
+    std::string err;
+    REQUIRE(render::prepareSynth(*synth, patchData, 44100.0, err));
+    REQUIRE(synth->hostSampleRate == 44100.0);
+    REQUIRE(synth->sampleAccurateEvents());
+
+    render::Score score;
+    REQUIRE(render::parseNoteList("note 0.05 0.2 60\nnote 0.1 0.1 67 80\n", 44100.0, score, err));
+
+    int64_t firstSound{-1}, at{0};
+    float peak{0.f};
+    auto frames = render::renderScore(*synth, score, {},
+                                      [&](const float *L, const float *R, int n)
+                                      {
+                                          for (int i = 0; i < n; ++i, ++at)
+                                          {
+                                              auto a = std::max(std::fabs(L[i]), std::fabs(R[i]));
+                                              if (a > 0.f && firstSound < 0)
+                                                  firstSound = at;
+                                              peak = std::max(peak, a);
+                                          }
+                                      });
+
+    REQUIRE(frames == at);
+    REQUIRE(peak > 0.01f);
+    // Nothing before the first note, give or take the engine's fixed latency
+    REQUIRE(firstSound >= score.events[0].sample);
+    REQUIRE(firstSound < score.events[0].sample + 2048);
+    // Stops once silent, well short of the 30 second tail limit
+    REQUIRE(frames > score.lastSample());
+    REQUIRE(frames < score.lastSample() + 10 * 44100);
+}
+
+TEST_CASE("batch fingerprints are independent of the thread pool", "[offline_render]")
+{
+    auto all = render::factoryPatchJobs();
+    REQUIRE(all.size() > 8);
+    std::vector<render::BatchJob> jobs;
+    for (size_t i = 0; i < all.size(); i += all.size() / 8)
+        jobs.push_back(all[i]);
+
+    render::BatchOptions opts;
+    opts.render.maxTailSeconds = 1.0;
+    render::Score score;
+    std::string err;
+    REQUIRE(render::parseNoteList(render::batchScoreNotes, opts.sampleRate, score, err));
+
+    opts.threads = 1;
+    auto serial = render::renderBatch(jobs, score, opts);
+    opts.threads = 4;
+    auto pooled = render::renderBatch(jobs, score, opts);
+
+    REQUIRE(serial.size() == jobs.size());
+    REQUIRE(pooled.size() == jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        INFO("Patch " << jobs[i].name);
+        REQUIRE(serial[i].ok);
+        REQUIRE(pooled[i].name == jobs[i].name);
+        REQUIRE(serial[i].print.frames > score.lastSample());
+        REQUIRE(serial[i].print.peak > 0.f);
+        REQUIRE(pooled[i].print.hash == serial[i].print.hash);
+        REQUIRE(pooled[i].print.frames == serial[i].print.frames);
+    }
+
+    auto csv = (std::filesystem::temp_directory_path() / "six-sines-fingerprints.csv").string();
+    REQUIRE(render::writeFingerprints(csv, serial));
+    std::map<std::string, render::Fingerprint> baseline;
+    REQUIRE(render::readFingerprints(csv, baseline, err));
+    std::filesystem::remove(csv);
+
+    render::FingerprintTolerance exact;
+    exact.requireHash = true;
+    REQUIRE(render::compareFingerprints(baseline, pooled, opts.sampleRate, exact).empty());
+
+    pooled[0].print.rms *= 2.f;
+    pooled.pop_back();
+    auto diffs = render::compareFingerprints(baseline, pooled, opts.sampleRate, {});
+    REQUIRE(diffs.size() == 2);
+    REQUIRE(diffs[0].find(jobs[0].name + ": rms") == 0);
+    REQUIRE(diffs[1].find("not rendered") != std::string::npos);
+}
@@ -1,13 +1,20 @@
 /*
  * Output-stage DSP regression tests. Pin numeric output of the saturator
- * shapers and the ZOH bit-rate decimator so they don't drift.
+ * shapers and the ZOH bit-rate decimator so they don't drift, check the fused
+ * SIMD shaper against them, and check the polyphase decimator's passband and
+ * stopband at every oversampling ratio.
  */
 
 #include "catch2/catch2.hpp"
 #include "synth/synth.h"
+#include "dsp/polyphase_decimator.h"
+#include "dsp/output_shaper.h"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <iterator>
+#include <memory>
 
 using baconpaul::six_sines::Synth;
 
@@ -132,3 +139,124 @@ TEST_CASE("ZOHRateDownsampler golden", "[output_stage]")
             REQUIRE(in[i] == Approx(expected[i]));
     }
 }
+
+TEST_CASE("Fused output shaper matches the scalar stages", "[output_stage]")
+{
+    namespace ss = baconpaul::six_sines;
+    namespace os = baconpaul::six_sines::output_shaper;
+
+    os::Params p;
+    p.drive = 1.3f;
+    p.scale = 128.f; // 8 bit
+    p.invScale = 1.f / 128.f;
+    p.gain = 0.7f;
+
+    for (auto sat : {ss::SAT_NONE, ss::SAT_SOFT, ss::SAT_OJD})
+    {
+        for (auto crush : {false, true})
+        {
+            DYNAMIC_SECTION("Saturation " << sat << " crush " << crush)
+            {
+                float L alignas(16)[ss::blockSize], R alignas(16)[ss::blockSize];
+                float in[ss::blockSize];
+                for (int i = 0; i < ss::blockSize; ++i)
+                {
+                    // a ramp across -3..3, past both saturator rails
+                    in[i] = -3.f + 6.f * i / (ss::blockSize - 1);
+                    L[i] = in[i];
+                    R[i] = -in[i];
+                }
+                os::shapeFnFor(sat, crush, true)(L, R, p);
+
+                auto scalar = [&](float x)
+                {
+                    if (sat == ss::SAT_SOFT)
+                        x = Synth::softSaturator(x * p.drive);
+                    else if (sat == ss::SAT_OJD)
+                        x = Synth::ojdSaturator(x * p.drive);
+                    if (crush)
+                        x = std::round(x * p.scale) * p.invScale;
+                    return x * p.gain;
+                };
+                for (int i = 0; i < ss::blockSize; ++i)
+                {
+                    INFO("Input " << in[i]);
+                    REQUIRE(L[i] == Approx(scalar(in[i])).margin(1e-6));
+                    REQUIRE(R[i] == Approx(scalar(-in[i])).margin(1e-6));
+                }
+            }
+        }
+    }
+
+    SECTION("Bit depth rounds the halfway boundaries like std::round")
+    {
+        os::Params u;
+        float L alignas(16)[ss::blockSize], R alignas(16)[ss::blockSize];
+        const float edges[]{0.49999997f, 0.5f, 0.50000006f, 1.5f, 2.5f, 2.4999998f, 8388607.5f};
+        for (int i = 0; i < ss::blockSize; ++i)
+        {
+            L[i] = edges[i % std::size(edges)];
+            R[i] = -L[i];
+        }
+        os::shapeFnFor(ss::SAT_NONE, true, false)(L, R, u);
+        for (int i = 0; i < ss::blockSize; ++i)
+        {
+            auto e = edges[i % std::size(edges)];
+            INFO("Input " << e);
+            REQUIRE(L[i] == std::round(e));
+            REQUIRE(R[i] == std::round(-e));
+        }
+    }
+}
+
+TEST_CASE("PolyphaseDecimator passes the band and rejects the stop", "[output_stage]")
+{
+    namespace ss = baconpaul::six_sines;
+    using PD = ss::PolyphaseDecimator;
+
+    // Peak host rate level of a unit sine at f, once the filter has filled
+    auto levelDb = [](ss::SampleRateStrategy s, PD::Tier t, double f)
+    {
+        int L, M;
+        PD::ratioFor(s, L, M);
+        auto engineRate = 48000.0 * M / L;
+        auto d = std::make_unique<PD>();
+        d->reset(PD::coefficientsFor(s, t));
+
+        int64_t n{0};
+        float peak{0.f};
+        float out[2][ss::blockSize];
+        for (int b = 0; b < 1000; ++b)
+        {
+            while (d->inputsRequiredToGenerateOutputs(ss::blockSize) > 0)
+            {
+                float in[ss::blockSize];
+                for (auto &v : in)
+                    v = (float)std::sin(2.0 * M_PI * f * (n++) / engineRate);
+                d->pushBlock(in, in);
+            }
+            d->populateNextBlockSize(out[0], out[1]);
+            if (b > 500)
+                for (int i = 0; i < ss::blockSize; ++i)
+                    peak = std::max(peak, std::fabs(out[0][i]));
+        }
+        return 20 * std::log10(peak + 1e-12);
+    };
+
+    for (auto s : {ss::SR_110120, ss::SR_132144, ss::SR_176192, ss::SR_220240})
+    {
+        DYNAMIC_SECTION("Strategy " << s)
+        {
+            REQUIRE(levelDb(s, PD::STANDARD, 1000.0) == Approx(0.0).margin(0.05));
+            REQUIRE(levelDb(s, PD::HQ, 1000.0) == Approx(0.0).margin(0.05));
+            for (auto f : {27000.0, 40000.0, 70000.0})
+            {
+                INFO("Frequency " << f);
+                REQUIRE(levelDb(s, PD::STANDARD, f) < -95.0);
+                REQUIRE(levelDb(s, PD::HQ, f) < -115.0);
+            }
+            // HQ holds the stopband right down to nyquist
+            REQUIRE(levelDb(s, PD::HQ, 24500.0) < -115.0);
+        }
+    }
+}
@@ -17,6 +17,7 @@
 //   - Patch::copyValuesFrom (value-only copy used by activate())
 //   - Synth::drainAudioToMainInto (audio -> patchMain main-thread drain)
 //   - processUIQueue (UI -> audio-thread patch)
+//   - publishPatchToAudio (whole-patch snapshot -> audio-thread patch)
 //   - paramsFlushMainThread (inactive host param flush -> patchMain)
 //   - the DAW session state (dawStateMain) streaming on patchMain
 // No CLAP host is needed: Synth works standalone, and handleParamValue only calls
@@ -165,6 +166,73 @@ TEST_CASE("UI edit reaches the audio patch through processUIQueue", "[patch-sync
     REQUIRE(approxEq(engine.patch.paramMap.at(pid)->value, target));
 }
 
+TEST_CASE("A whole patch reaches the audio patch as one snapshot", "[patch-sync]")
+{
+    auto enginePtr = std::make_unique<Synth>(false);
+    auto &engine = *enginePtr;
+    auto out = makeOut();
+
+    const uint32_t gid = engine.patch.output.outputGain.meta.id;
+    const uint32_t mid = engine.patch.macroNodes[0].level.meta.id;
+
+    // Two loads before the audio thread runs: the first marker adopts the newest values
+    engine.patchMain.paramMap.at(gid)->value = 0.3f;
+    Synth::publishPatchToAudio(engine.patchMain, engine.mainToAudio);
+    engine.patchMain.paramMap.at(gid)->value = 0.6f;
+    engine.patchMain.paramMap.at(mid)->value = 0.7f;
+    Synth::publishPatchToAudio(engine.patchMain, engine.mainToAudio);
+
+    engine.processUIQueue(&out);
+    for (auto &[id, p] : engine.patchMain.paramMap)
+        REQUIRE(engine.patch.paramMap.at(id)->value == p->value);
+    REQUIRE(engine.patch.paramMap.at(gid)->value == 0.6f);
+
+    // With nothing newly published a marker changes nothing
+    engine.patch.paramMap.at(gid)->value = 0.1f;
+    engine.mainToAudio.push({Synth::MainToAudioMsg::ADOPT_PATCH_SNAPSHOT,
+                             engine.mainToAudio.patchSnapshot.lastPublished});
+    engine.processUIQueue(&out);
+    REQUIRE(engine.patch.paramMap.at(gid)->value == 0.1f);
+}
+
+TEST_CASE("An edit queued between two loads does not outlive the second", "[patch-sync]")
+{
+    auto enginePtr = std::make_unique<Synth>(false);
+    auto &engine = *enginePtr;
+    auto out = makeOut();
+
+    const uint32_t gid = engine.patch.output.outputGain.meta.id;
+    const uint32_t mid = engine.patch.macroNodes[0].level.meta.id;
+
+    // publish(P1), ADOPT, SET_PARAM, publish(P2), ADOPT, all before the audio thread runs.
+    // The first marker adopts P2, which already replaced the edit
+    engine.patchMain.paramMap.at(gid)->value = 0.3f;
+    Synth::publishPatchToAudio(engine.patchMain, engine.mainToAudio);
+    engine.patchMain.paramMap.at(gid)->value = 0.9f;
+    engine.mainToAudio.push({Synth::MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING, gid, 0.9f});
+    engine.patchMain.paramMap.at(gid)->value = 0.6f;
+    Synth::publishPatchToAudio(engine.patchMain, engine.mainToAudio);
+
+    engine.processUIQueue(&out);
+    engine.snapAllParams();
+    REQUIRE(engine.patch.paramMap.at(gid)->value == 0.6f);
+
+    // Edits after the last marker apply as usual
+    engine.patchMain.paramMap.at(mid)->value = 0.25f;
+    engine.mainToAudio.push({Synth::MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING, mid, 0.25f});
+    engine.processUIQueue(&out);
+    REQUIRE(engine.patch.paramMap.at(mid)->value == 0.25f);
+
+    // An edit the second load kept survives it, since the snapshot carries it
+    engine.patchMain.paramMap.at(gid)->value = 0.45f;
+    engine.mainToAudio.push({Synth::MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING, gid, 0.45f});
+    Synth::publishPatchToAudio(engine.patchMain, engine.mainToAudio);
+    engine.processUIQueue(&out);
+    REQUIRE(engine.patch.paramMap.at(gid)->value == 0.45f);
+    for (auto &[id, p] : engine.patchMain.paramMap)
+        REQUIRE(engine.patch.paramMap.at(id)->value == p->value);
+}
+
 TEST_CASE("Audio-thread param change drains back into patchMain", "[patch-sync]")
 {
     auto enginePtr = std::make_unique<Synth>(false);
@@ -0,0 +1,89 @@
+#!/usr/bin/env bash
+# Run the perf scenarios against each engine block size build and tabulate
+# CPU cost next to modulation resolution.
+#
+# Usage:
+#   tests/perf/matrix.sh <perf-bin> [<perf-bin> ...]
+#
+# Each binary is a six-sines-perf built against one impl variant
+# (six-sines-perf, six-sines-perf-bs16, six-sines-perf-bs32); the block size
+# is read back from the engine_block field of the digest. The
+# six-sines-perf-matrix target calls this with all three.
+#
+# Env vars:
+#   FILTER="[bench][plugin]"   Catch2 tag filter (default: every scenario)
+#   PERF_SAMPLE_MS=N           passed through to the binaries
+#   ENGINE_RATE=N              engine rate used for the resolution column
+#                              (default 120000, the 48k host default)
+#
+# The modulation step is blockSize / engine rate: envelopes, LFOs and the
+# mod matrix update once per block, so doubling the block halves their
+# resolution. cpu columns are cpu_pct_48k; delta is against the smallest block.
+
+set -euo pipefail
+
+if [[ $# -lt 1 ]]; then
+    echo "usage: $0 <perf-bin> [<perf-bin> ...]" >&2
+    exit 2
+fi
+
+FILTER="${FILTER:-}"
+TMP="$(mktemp -t sixsines-perf-matrix.XXXXXX)"
+trap 'rm -f "${TMP}"' EXIT
+
+for bin in "$@"; do
+    echo "--- ${bin} ---"
+    if [[ -n "${FILTER}" ]]; then
+        "${bin}" "${FILTER}" | tee -a "${TMP}"
+    else
+        "${bin}" | tee -a "${TMP}"
+    fi
+done
+
+python3 - "${TMP}" "${ENGINE_RATE:-120000}" <<'PY'
+import sys, re
+path, engine_rate = sys.argv[1], float(sys.argv[2])
+kv_re = re.compile(r'(\w+)=([^\s]+)')
+cpu = {}
+sizes = set()
+with open(path) as f:
+    for line in f:
+        if not line.startswith('[scn:'):
+            continue
+        tag = line.split(']', 1)[0].lstrip('[')
+        kv = dict(kv_re.findall(line))
+        bs = int(kv.get('engine_block', 8))
+        sizes.add(bs)
+        cpu[(tag, kv.get('level', '?'), bs)] = float(kv.get('cpu_pct_48k', 0))
+
+sizes = sorted(sizes)
+if not sizes:
+    print("no digest lines found")
+    sys.exit(0)
+
+w = lambda s, n: str(s).ljust(n)
+print()
+print("modulation step: " + ", ".join(
+    f"{bs} samples = {bs / engine_rate * 1e6:.0f} us" for bs in sizes))
+print()
+hdr = f"{w('tag', 28)} {w('lvl', 7)}"
+for bs in sizes:
+    hdr += f" {w(f'cpu@{bs}', 9)}"
+for bs in sizes[1:]:
+    hdr += f" {w(f'd@{bs}', 9)}"
+print(hdr)
+print("-" * len(hdr))
+for tag, lvl in sorted({(t, l) for (t, l, _) in cpu}):
+    row = f"{w(tag, 28)} {w(lvl, 7)}"
+    for bs in sizes:
+        v = cpu.get((tag, lvl, bs))
+        row += f" {w('-' if v is None else f'{v:.2f}', 9)}"
+    base = cpu.get((tag, lvl, sizes[0]))
+    for bs in sizes[1:]:
+        v = cpu.get((tag, lvl, bs))
+        if base and v is not None:
+            row += f" {w(f'{(v - base) / base * 100.0:+.1f}%', 9)}"
+        else:
+            row += f" {w('-', 9)}"
+    print(row)
+PY
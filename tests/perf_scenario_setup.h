@@ -0,0 +1,329 @@
+/*
+ * The perf scenario matrix: ScenarioSpec, the in-code patch it builds and the synth
+ * bring-up. Shared by the perf harness (perf_scenarios.cpp) and the golden audio
+ * check (golden_audio.cpp), so both render exactly the same scenarios.
+ *
+ * With SIX_SINES_GOLDEN_BASELINE set it also builds against the engine from before the
+ * performance work, which has none of the scheduling options, for
+ * tests/golden/record-baseline.sh.
+ */
+
+#ifndef BACONPAUL_SIX_SINES_TESTS_PERF_SCENARIO_SETUP_H
+#define BACONPAUL_SIX_SINES_TESTS_PERF_SCENARIO_SETUP_H
+
+#include <cstdint>
+#include <memory>
+
+#include "configuration.h"
+#include "synth/patch.h"
+#include "synth/synth.h"
+#include "synth/mod_matrix.h"
+#include "dsp/sintable.h"
+#include "dsp/matrix_node.h"
+
+namespace baconpaul::six_sines::perf
+{
+static constexpr uint32_t scenarioRandomSeed{0x5155};
+
+// ---------------------------------------------------------------------------
+// ScenarioSpec — the workload knobs the plan calls out. One spec per row in
+// the PERFORMANCE_TESTS.md scenarios table.
+// ---------------------------------------------------------------------------
+struct ScenarioSpec
+{
+    int activeOps{1};       // ops 0..activeOps-1 will have active=1
+    bool fullMatrix{false}; // all 15 matrix nodes active
+    bool allSelfFB{false};  // all 6 self-feedback nodes active
+    bool fullMod{false};    // 1 mod slot populated on every node
+    Patch::SourceNode::ExtendedMode em{Patch::SourceNode::ExtendedMode::NONE};
+    ResamplerEngine resampler{SRC_FAST}; // engine -> host rate conversion
+    int noteStartDelay{0}; // Synth::voiceStartDelay for the notes, as a scheduled event sets
+    bool outputStages{false}; // saturation, bit depth, lowpass and gain on the output
+    bool ultrasonic{false};   // the ultrasonic brickwall on the output
+};
+
+// ---------------------------------------------------------------------------
+// Helpers that walk the Patch sub-structures and set fields. Kept terse —
+// we read .value directly, which is what Synth itself does at runtime.
+// ---------------------------------------------------------------------------
+
+// Default-good envelope so notes don't decay during a benchmark run:
+// instant attack, full sustain. envIsMult=1 means env multiplies the level.
+inline void setFastSustainedEnv(Patch::DAHDSRMixin &e)
+{
+    e.delay.value = 0.f;
+    e.attack.value = 0.01f;
+    e.hold.value = 0.f;
+    e.decay.value = 0.f;
+    e.sustain.value = 1.f;
+    e.release.value = 0.5f;
+    e.envPower.value = 1.f;
+    e.envIsMultiplcative.value = 1.f;
+    e.envIsOneShot.value = 0.f;
+    e.envTriggersFromZero.value = 0.f;
+    // triggerMode default (Key Press = 3) is fine.
+}
+
+// Active sine LFO at a moderate rate. Keeps INTERNAL_LFO source pointers
+// pointing at something that actually moves.
+inline void setActiveLFO(Patch::LFOMixin &l)
+{
+    l.lfoActive.value = 1.f;
+    l.lfoRate.value = 0.3f; // moderate
+    l.lfoShape.value = 0.f; // Sine — no smoothing branch
+    l.lfoDeform.value = 0.f;
+    l.tempoSync.value = 0.f;
+    l.lfoBipolar.value = 1.f;
+    l.lfoIsEnveloped.value = 0.f;
+    l.lfoStartPhase.value = 0.f;
+}
+
+// Populate slot 0 of a node's modulation triple. We use DIRECT (target id 10
+// on every node type) so the same write applies uniformly. MACRO_0 is a
+// cheap, always-valid source.
+//
+// `targetDirect` is the node-specific TargetID::DIRECT (always 10 in this
+// codebase, but we pass it explicitly so accidental drift is caught).
+template <typename Node>
+inline void wireOneMod(Node &n, int32_t source, int32_t targetDirect, float depth)
+{
+    n.modsource[0].value = (float)source;
+    n.moddepth[0].value = depth;
+    n.modtarget[0].value = (float)targetDirect;
+}
+
+// Set ratio to a non-trivial value so the inner loop walks the wavetable
+// rather than sitting at phase=0 for every op identically.
+inline void setOpDefaults(Patch::SourceNode &s, int idx)
+{
+    s.ratio.value = 0.0f + 0.13f * idx; // 1.0, ~1.094, ~1.198, ... in 2^x
+    s.waveForm.value = (float)SinTable::SIN;
+    s.envToRatio.value = 0.f;
+    s.envToRatioFine.value = 0.f;
+    s.lfoToRatio.value = 0.f;
+    s.lfoToRatioFine.value = 0.f;
+    s.startingPhase.value = 0.f;
+    s.octTranspose.value = 0.f;
+    s.keyTrack.value = 1.f;
+    s.unisonParticipation.value = 3.f; // pan+tune
+    s.unisonToMain.value = 0.f;
+    s.unisonToOpOut.value = 0.f;
+    setFastSustainedEnv(s);
+    setActiveLFO(s);
+}
+
+inline void configureScenarioPatch(Patch &patch, const ScenarioSpec &spec)
+{
+    // ---- Output ----
+    patch.output.level.value = 0.5f;
+    patch.output.velSensitivity.value = 0.f;
+    patch.output.playMode.value = 0.f; // poly
+    patch.output.polyLimit.value = (float)maxVoices;
+    patch.output.unisonCount.value = 1.f;
+    patch.output.pianoModeActive.value = 0.f;
+    patch.output.octTranspose.value = 0.f;
+    patch.output.fineTune.value = 0.f;
+    patch.output.pan.value = 0.f;
+    patch.output.lfoDepth.value = 0.f;
+    setFastSustainedEnv(patch.output);
+    setActiveLFO(patch.output);
+    patch.output.ultrasonicFilter.value = spec.ultrasonic ? 1.f : 0.f;
+    if (spec.outputStages)
+    {
+        patch.output.saturationType.value = (float)SAT_OJD;
+        patch.output.saturationDrive.value = 1.1f;
+        patch.output.bitDepthAdjust.value = (float)BD_12;
+        patch.output.lowpass.value = (float)LP_16K;
+        patch.output.outputGain.value = 0.9f;
+    }
+
+    // Run all nodes with active=1 by default — designModeRunAll is false in
+    // these benchmarks; we toggle .active per node explicitly below.
+
+    // ---- Source nodes (operators) ----
+    for (int i = 0; i < (int)numOps; ++i)
+    {
+        auto &s = patch.sourceNodes[i];
+        setOpDefaults(s, i);
+        s.active.value = (i < spec.activeOps) ? 1.f : 0.f;
+
+        // Extended mode (per-op): only configure when needed; otherwise leave NONE.
+        s.extendedModeMode.value = (float)spec.em;
+        if (spec.em == Patch::SourceNode::ExtendedMode::PHASE_REMAP)
+        {
+            s.phaseMapModeShape.value = (float)Patch::SourceNode::PhaseMapShape::SAW;
+            s.extendedModeM.value = 0.5f;
+        }
+        else if (spec.em == Patch::SourceNode::ExtendedMode::RESONANT_SWEEP)
+        {
+            s.resonantSweepWindowShape.value = (float)Patch::SourceNode::ResonantSweepWindow::HANN;
+            s.resonantSweepFrequencyDepth.value =
+                (float)Patch::SourceNode::ResonantSweepFrequencyDepth::FOUR;
+            s.extendedModeM.value = 0.5f;
+        }
+        else if (spec.em == Patch::SourceNode::ExtendedMode::NOISE)
+        {
+            s.noiseMode.value = (float)Patch::SourceNode::NoiseMode::ADD_TO_SIGNAL;
+            s.noiseType.value = (float)Patch::SourceNode::NoiseType::PINK;
+            s.lfsrMode.value = (float)Patch::SourceNode::LFSRMode::LONG_KEYTRACK;
+            s.extendedModeM.value = 0.3f;
+            s.extendedModeN.value = 0.5f;
+        }
+
+        if (spec.fullMod)
+        {
+            wireOneMod(s, ModMatrixConfig::Source::MACRO_0, Patch::SourceNode::TargetID::DIRECT,
+                       0.1f);
+        }
+    }
+
+    // ---- Mixer nodes (must be active to produce output) ----
+    for (int i = 0; i < (int)numOps; ++i)
+    {
+        auto &m = patch.mixerNodes[i];
+        m.active.value = (i < spec.activeOps) ? 1.f : 0.f;
+        m.level.value = 0.5f;
+        m.pan.value = 0.f;
+        m.lfoToLevel.value = 0.f;
+        m.lfoToPan.value = 0.f;
+        m.envToLevel.value = 0.f;
+        m.solo.value = 0.f;
+        setFastSustainedEnv(m);
+        setActiveLFO(m);
+        if (spec.fullMod)
+        {
+            wireOneMod(m, ModMatrixConfig::Source::MACRO_0, Patch::MixerNode::TargetID::DIRECT,
+                       0.1f);
+        }
+    }
+
+    // ---- Self-feedback nodes ----
+    for (int i = 0; i < (int)numOps; ++i)
+    {
+        auto &sn = patch.selfNodes[i];
+        sn.active.value = (spec.allSelfFB && i < spec.activeOps) ? 1.f : 0.f;
+        sn.fbLevel.value = 0.25f;
+        sn.lfoToFB.value = 0.f;
+        sn.envToFB.value = 0.f;
+        sn.overdrive.value = 0.f;
+        setFastSustainedEnv(sn);
+        setActiveLFO(sn);
+        if (spec.fullMod)
+        {
+            wireOneMod(sn, ModMatrixConfig::Source::MACRO_0, Patch::SelfNode::TargetID::DIRECT,
+                       0.1f);
+        }
+    }
+
+    // ---- Matrix nodes (15 src→tgt with src<tgt) ----
+    for (int i = 0; i < (int)matrixSize; ++i)
+    {
+        auto &mx = patch.matrixNodes[i];
+        // Activate only matrix nodes whose source AND target are within
+        // activeOps. Otherwise we waste cycles routing from a silent op.
+        int srcOp = MatrixIndex::sourceIndexAt(i);
+        int tgtOp = MatrixIndex::targetIndexAt(i);
+        bool inRange = (srcOp < spec.activeOps) && (tgtOp < spec.activeOps);
+        mx.active.value = (spec.fullMatrix && inRange) ? 1.f : 0.f;
+        mx.level.value = 0.2f;
+        mx.modulationMode.value = 2.f; // Linear FM (the typical hot path)
+        mx.modulationScale.value = 0.f;
+        mx.lfoToDepth.value = 0.f;
+        mx.envToLevel.value = 0.f;
+        mx.overdrive.value = 0.f;
+        setFastSustainedEnv(mx);
+        setActiveLFO(mx);
+        if (spec.fullMod)
+        {
+            wireOneMod(mx, ModMatrixConfig::Source::MACRO_0, Patch::MatrixNode::TargetID::DIRECT,
+                       0.1f);
+        }
+    }
+
+    // ---- Macro nodes (always present; we want at least MACRO_0 sane) ----
+    for (int i = 0; i < (int)numMacros; ++i)
+    {
+        auto &mn = patch.macroNodes[i];
+        mn.level.value = 0.5f;
+        mn.macroPower.value = 0.f; // off — voiceValues.macroOut falls back to mono macroPtr
+    }
+
+    // ---- Output mod nodes (panMod, fineTuneMod) — leave default-off ----
+    // Patch ctor already constructs fineTuneMod and mainPanMod with sane defaults.
+}
+
+// ---------------------------------------------------------------------------
+// Synth setup helpers — bring up a Synth, configure the patch, trigger notes.
+// ---------------------------------------------------------------------------
+
+// Constructing a Synth lazily ensures SinTable statics get initialized via
+// OpSource ctor before any other DSP code runs.
+inline std::unique_ptr<Synth> bringUpSynth(const ScenarioSpec &spec, int numVoices,
+                                           double hostSampleRate = 48000.0,
+                                           bool polySine = false,
+                                           uint32_t randomSeed = scenarioRandomSeed)
+{
+    // A fixed random seed, so noise, random LFOs and starting phases are the same each run
+    auto s = std::make_unique<Synth>(false, randomSeed);
+    // setSampleRate picks the resampler, and the decimator tier the ultrasonic filter
+    // wants, up from the patch
+    s->patch.output.resampleEngine.value = (float)spec.resampler;
+    s->patch.output.ultrasonicFilter.value = spec.ultrasonic ? 1.f : 0.f;
+    s->setSampleRate(hostSampleRate);
+    configureScenarioPatch(s->patch, spec);
+#if !SIX_SINES_GOLDEN_BASELINE
+    // The SinTable backend latches at note on, so it has to be set before the notes
+    s->monoValues.polySine = polySine;
+    Synth::prepareWaveFormsFor(s->patch);
+#endif
+    // reapplyControlSettings is public and re-reads playMode/polyLimit/MPE etc
+    // from the patch we just configured.
+    s->reapplyControlSettings();
+    // Trigger notes — one per voice, spread across keys so the engine isn't
+    // accidentally rendering identical phase trajectories per voice.
+    int baseKey = 36;
+#if !SIX_SINES_GOLDEN_BASELINE
+    s->voiceStartDelay = spec.noteStartDelay;
+#endif
+    for (int v = 0; v < numVoices; ++v)
+    {
+        s->voiceManager->processNoteOnEvent(0, 0, baseKey + (v % 60), -1, 0.8f, 0.f);
+    }
+#if !SIX_SINES_GOLDEN_BASELINE
+    s->voiceStartDelay = 0;
+#endif
+    // Let envelopes step out of the attack stage so timings reflect steady state.
+    // Three host blocks ≈ 0.5 ms at 48 kHz; far less than 10 ms minAttack but our
+    // attack is set near zero, so this is sufficient.
+    for (int i = 0; i < 8; ++i)
+        s->process(nullptr);
+    return s;
+}
+
+// Auto-calibrated timing: each scenario fills `target_sample_ms` of
+// wall-clock per timed sample (default 30 ms → 17 scenarios × 15 samples ×
+// ~30 ms ≈ 8 s total). Overridable per-scenario, and globally via
+// PERF_SAMPLE_MS env var.
+struct RunOptions
+{
+    int samples{15};
+    int warmup{3};
+    double target_sample_ms{100.0};
+    bool voicePack{true}; // Synth::voicePackRendering; false for the serial comparison rows
+    int renderWorkers{0}; // VoiceRenderPool worker threads; 0 renders on the calling thread
+    int macroBlocks{1};   // Synth::macroBlocks; blocks each voice renders per pass
+    bool polySine{false}; // MonoValues::polySine; passed to bringUpSynth, as it latches at attack
+    int srcBatchBlocks{1}; // Synth::srcBatchBlocks; engine blocks per libsamplerate call
+};
+
+inline void applyRunOptions(Synth &s, const RunOptions &opts)
+{
+#if !SIX_SINES_GOLDEN_BASELINE
+    s.voicePackRendering = opts.voicePack;
+    s.renderPool.start(opts.renderWorkers);
+    s.macroBlocks = opts.macroBlocks;
+    s.srcBatchBlocks = opts.srcBatchBlocks;
+#endif
+}
+} // namespace baconpaul::six_sines::perf
+#endif // PERF_SCENARIO_SETUP_H
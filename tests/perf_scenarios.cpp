@@ -13,6 +13,9 @@
  *
  * Per-scenario one-line digest is printed via perf_timing.h:printDigest.
  * `tests/perf/diff.sh` greps those lines and joins on the [scn:...] tag.
+ * Plugin-level scenarios follow it with [tail:...] lines from the synth's
+ * ProcessTiming histograms (p50/p99/max share of the block deadline), which
+ * run.sh leaves out of the CSV.
  *
  * Programmatic patch construction here is deliberately minimal: we set only
  * the params required to make the desired DSP path active. Everything else
@@ -21,6 +24,7 @@
 
 #include "catch2/catch2.hpp"
 #include "perf_timing.h"
+#include "perf_scenario_setup.h"
 
 #include "configuration.h"
 #include "synth/patch.h"
@@ -31,6 +35,10 @@
 #include "dsp/sintable.h"
 #include "dsp/matrix_node.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -41,249 +49,6 @@ using namespace baconpaul::six_sines::perf;
 namespace
 {
 
-// ---------------------------------------------------------------------------
-// ScenarioSpec — the workload knobs the plan calls out. One spec per row in
-// the PERFORMANCE_TESTS.md scenarios table.
-// ---------------------------------------------------------------------------
-struct ScenarioSpec
-{
-    int activeOps{1};       // ops 0..activeOps-1 will have active=1
-    bool fullMatrix{false}; // all 15 matrix nodes active
-    bool allSelfFB{false};  // all 6 self-feedback nodes active
-    bool fullMod{false};    // 1 mod slot populated on every node
-    Patch::SourceNode::ExtendedMode em{Patch::SourceNode::ExtendedMode::NONE};
-};
-
-// ---------------------------------------------------------------------------
-// Helpers that walk the Patch sub-structures and set fields. Kept terse —
-// we read .value directly, which is what Synth itself does at runtime.
-// ---------------------------------------------------------------------------
-
-// Default-good envelope so notes don't decay during a benchmark run:
-// instant attack, full sustain. envIsMult=1 means env multiplies the level.
-void setFastSustainedEnv(Patch::DAHDSRMixin &e)
-{
-    e.delay.value = 0.f;
-    e.attack.value = 0.01f;
-    e.hold.value = 0.f;
-    e.decay.value = 0.f;
-    e.sustain.value = 1.f;
-    e.release.value = 0.5f;
-    e.envPower.value = 1.f;
-    e.envIsMultiplcative.value = 1.f;
-    e.envIsOneShot.value = 0.f;
-    e.envTriggersFromZero.value = 0.f;
-    // triggerMode default (Key Press = 3) is fine.
-}
-
-// Active sine LFO at a moderate rate. Keeps INTERNAL_LFO source pointers
-// pointing at something that actually moves.
-void setActiveLFO(Patch::LFOMixin &l)
-{
-    l.lfoActive.value = 1.f;
-    l.lfoRate.value = 0.3f; // moderate
-    l.lfoShape.value = 0.f; // Sine — no smoothing branch
-    l.lfoDeform.value = 0.f;
-    l.tempoSync.value = 0.f;
-    l.lfoBipolar.value = 1.f;
-    l.lfoIsEnveloped.value = 0.f;
-    l.lfoStartPhase.value = 0.f;
-}
-
-// Populate slot 0 of a node's modulation triple. We use DIRECT (target id 10
-// on every node type) so the same write applies uniformly. MACRO_0 is a
-// cheap, always-valid source.
-//
-// `targetDirect` is the node-specific TargetID::DIRECT (always 10 in this
-// codebase, but we pass it explicitly so accidental drift is caught).
-template <typename Node> void wireOneMod(Node &n, int32_t source, int32_t targetDirect, float depth)
-{
-    n.modsource[0].value = (float)source;
-    n.moddepth[0].value = depth;
-    n.modtarget[0].value = (float)targetDirect;
-}
-
-// Set ratio to a non-trivial value so the inner loop walks the wavetable
-// rather than sitting at phase=0 for every op identically.
-void setOpDefaults(Patch::SourceNode &s, int idx)
-{
-    s.ratio.value = 0.0f + 0.13f * idx; // 1.0, ~1.094, ~1.198, ... in 2^x
-    s.waveForm.value = (float)SinTable::SIN;
-    s.envToRatio.value = 0.f;
-    s.envToRatioFine.value = 0.f;
-    s.lfoToRatio.value = 0.f;
-    s.lfoToRatioFine.value = 0.f;
-    s.startingPhase.value = 0.f;
-    s.octTranspose.value = 0.f;
-    s.keyTrack.value = 1.f;
-    s.unisonParticipation.value = 3.f; // pan+tune
-    s.unisonToMain.value = 0.f;
-    s.unisonToOpOut.value = 0.f;
-    setFastSustainedEnv(s);
-    setActiveLFO(s);
-}
-
-void configureScenarioPatch(Patch &patch, const ScenarioSpec &spec)
-{
-    // ---- Output ----
-    patch.output.level.value = 0.5f;
-    patch.output.velSensitivity.value = 0.f;
-    patch.output.playMode.value = 0.f; // poly
-    patch.output.polyLimit.value = (float)maxVoices;
-    patch.output.unisonCount.value = 1.f;
-    patch.output.pianoModeActive.value = 0.f;
-    patch.output.octTranspose.value = 0.f;
-    patch.output.fineTune.value = 0.f;
-    patch.output.pan.value = 0.f;
-    patch.output.lfoDepth.value = 0.f;
-    setFastSustainedEnv(patch.output);
-    setActiveLFO(patch.output);
-
-    // Run all nodes with active=1 by default — designModeRunAll is false in
-    // these benchmarks; we toggle .active per node explicitly below.
-
-    // ---- Source nodes (operators) ----
-    for (int i = 0; i < (int)numOps; ++i)
-    {
-        auto &s = patch.sourceNodes[i];
-        setOpDefaults(s, i);
-        s.active.value = (i < spec.activeOps) ? 1.f : 0.f;
-
-        // Extended mode (per-op): only configure when needed; otherwise leave NONE.
-        s.extendedModeMode.value = (float)spec.em;
-        if (spec.em == Patch::SourceNode::ExtendedMode::PHASE_REMAP)
-        {
-            s.phaseMapModeShape.value = (float)Patch::SourceNode::PhaseMapShape::SAW;
-            s.extendedModeM.value = 0.5f;
-        }
-        else if (spec.em == Patch::SourceNode::ExtendedMode::RESONANT_SWEEP)
-        {
-            s.resonantSweepWindowShape.value = (float)Patch::SourceNode::ResonantSweepWindow::HANN;
-            s.resonantSweepFrequencyDepth.value =
-                (float)Patch::SourceNode::ResonantSweepFrequencyDepth::FOUR;
-            s.extendedModeM.value = 0.5f;
-        }
-        else if (spec.em == Patch::SourceNode::ExtendedMode::NOISE)
-        {
-            s.noiseMode.value = (float)Patch::SourceNode::NoiseMode::ADD_TO_SIGNAL;
-            s.noiseType.value = (float)Patch::SourceNode::NoiseType::PINK;
-            s.lfsrMode.value = (float)Patch::SourceNode::LFSRMode::LONG_KEYTRACK;
-            s.extendedModeM.value = 0.3f;
-            s.extendedModeN.value = 0.5f;
-        }
-
-        if (spec.fullMod)
-        {
-            wireOneMod(s, ModMatrixConfig::Source::MACRO_0, Patch::SourceNode::TargetID::DIRECT,
-                       0.1f);
-        }
-    }
-
-    // ---- Mixer nodes (must be active to produce output) ----
-    for (int i = 0; i < (int)numOps; ++i)
-    {
-        auto &m = patch.mixerNodes[i];
-        m.active.value = (i < spec.activeOps) ? 1.f : 0.f;
-        m.level.value = 0.5f;
-        m.pan.value = 0.f;
-        m.lfoToLevel.value = 0.f;
-        m.lfoToPan.value = 0.f;
-        m.envToLevel.value = 0.f;
-        m.solo.value = 0.f;
-        setFastSustainedEnv(m);
-        setActiveLFO(m);
-        if (spec.fullMod)
-        {
-            wireOneMod(m, ModMatrixConfig::Source::MACRO_0, Patch::MixerNode::TargetID::DIRECT,
-                       0.1f);
-        }
-    }
-
-    // ---- Self-feedback nodes ----
-    for (int i = 0; i < (int)numOps; ++i)
-    {
-        auto &sn = patch.selfNodes[i];
-        sn.active.value = (spec.allSelfFB && i < spec.activeOps) ? 1.f : 0.f;
-        sn.fbLevel.value = 0.25f;
-        sn.lfoToFB.value = 0.f;
-        sn.envToFB.value = 0.f;
-        sn.overdrive.value = 0.f;
-        setFastSustainedEnv(sn);
-        setActiveLFO(sn);
-        if (spec.fullMod)
-        {
-            wireOneMod(sn, ModMatrixConfig::Source::MACRO_0, Patch::SelfNode::TargetID::DIRECT,
-                       0.1f);
-        }
-    }
-
-    // ---- Matrix nodes (15 src→tgt with src<tgt) ----
-    for (int i = 0; i < (int)matrixSize; ++i)
-    {
-        auto &mx = patch.matrixNodes[i];
-        // Activate only matrix nodes whose source AND target are within
-        // activeOps. Otherwise we waste cycles routing from a silent op.
-        int srcOp = MatrixIndex::sourceIndexAt(i);
-        int tgtOp = MatrixIndex::targetIndexAt(i);
-        bool inRange = (srcOp < spec.activeOps) && (tgtOp < spec.activeOps);
-        mx.active.value = (spec.fullMatrix && inRange) ? 1.f : 0.f;
-        mx.level.value = 0.2f;
-        mx.modulationMode.value = 2.f; // Linear FM (the typical hot path)
-        mx.modulationScale.value = 0.f;
-        mx.lfoToDepth.value = 0.f;
-        mx.envToLevel.value = 0.f;
-        mx.overdrive.value = 0.f;
-        setFastSustainedEnv(mx);
-        setActiveLFO(mx);
-        if (spec.fullMod)
-        {
-            wireOneMod(mx, ModMatrixConfig::Source::MACRO_0, Patch::MatrixNode::TargetID::DIRECT,
-                       0.1f);
-        }
-    }
-
-    // ---- Macro nodes (always present; we want at least MACRO_0 sane) ----
-    for (int i = 0; i < (int)numMacros; ++i)
-    {
-        auto &mn = patch.macroNodes[i];
-        mn.level.value = 0.5f;
-        mn.macroPower.value = 0.f; // off — voiceValues.macroOut falls back to mono macroPtr
-    }
-
-    // ---- Output mod nodes (panMod, fineTuneMod) — leave default-off ----
-    // Patch ctor already constructs fineTuneMod and mainPanMod with sane defaults.
-}
-
-// ---------------------------------------------------------------------------
-// Synth setup helpers — bring up a Synth, configure the patch, trigger notes.
-// ---------------------------------------------------------------------------
-
-// Constructing a Synth lazily ensures SinTable statics get initialized via
-// OpSource ctor before any other DSP code runs.
-std::unique_ptr<Synth> bringUpSynth(const ScenarioSpec &spec, int numVoices,
-                                    double hostSampleRate = 48000.0)
-{
-    auto s = std::make_unique<Synth>(false);
-    s->setSampleRate(hostSampleRate);
-    configureScenarioPatch(s->patch, spec);
-    // reapplyControlSettings is public and re-reads playMode/polyLimit/MPE etc
-    // from the patch we just configured.
-    s->reapplyControlSettings();
-    // Trigger notes — one per voice, spread across keys so the engine isn't
-    // accidentally rendering identical phase trajectories per voice.
-    int baseKey = 36;
-    for (int v = 0; v < numVoices; ++v)
-    {
-        s->voiceManager->processNoteOnEvent(0, 0, baseKey + (v % 60), -1, 0.8f, 0.f);
-    }
-    // Let envelopes step out of the attack stage so timings reflect steady state.
-    // Three host blocks ≈ 0.5 ms at 48 kHz; far less than 10 ms minAttack but our
-    // attack is set near zero, so this is sufficient.
-    for (int i = 0; i < 8; ++i)
-        s->process(nullptr);
-    return s;
-}
-
 // ---------------------------------------------------------------------------
 // Drivers — return a callable suitable for timeIt().
 // ---------------------------------------------------------------------------
@@ -308,6 +73,16 @@ auto makeVoiceDriver(Synth &s)
             s.monoValues.twoToTheX.twoToThe(s.patch.output.unisonSpread.value) - 1.f;
         s.monoValues.unisonPanScalar = s.patch.output.unisonPan.value;
 
+        if (s.voicePackRendering)
+        {
+            Voice *vs[maxVoices];
+            size_t n{0};
+            for (auto *cv = s.head; cv; cv = cv->next)
+                vs[n++] = cv;
+            Voice::renderBlocksPacked(vs, n);
+            return;
+        }
+
         auto *cv = s.head;
         while (cv)
         {
@@ -347,6 +122,35 @@ uint64_t hashOneOutputBlock(Synth &s)
     return h;
 }
 
+// ---------------------------------------------------------------------------
+// Tail latency digest: one line per ProcessTiming histogram with any records. The engine
+// ones are relative block cost, with no deadline to be over or late against; only the
+// plugin's host buffers have one, and the harness has no host.
+//
+//   [tail:8v_dense] block n=480000 p50_pct=3.1 p99_pct=4.2 max_pct=61.0
+// ---------------------------------------------------------------------------
+void printTiming(const char *tag, const ProcessTiming &t)
+{
+    if (std::strncmp(tag, "scn:", 4) == 0)
+        tag += 4;
+    auto line = [tag](const char *what, const TimingHistogram &h)
+    {
+        auto s = h.summary();
+        if (s.count == 0)
+            return;
+        std::printf("[tail:%s] %s n=%llu p50_pct=%.1f p99_pct=%.1f max_pct=%.1f", tag, what,
+                    (unsigned long long)s.count, s.p50 * 100, s.p99 * 100, s.max * 100);
+        if (h.hasDeadline)
+            std::printf(" over_%d_pct=%llu late=%llu",
+                        (int)std::round(h.getOverThreshold() * 100), (unsigned long long)s.over,
+                        (unsigned long long)s.late);
+        std::printf("\n");
+    };
+    line("block", t.block);
+    line("attack", t.attack);
+    std::fflush(stdout);
+}
+
 // ---------------------------------------------------------------------------
 // Per-scenario shared driver: build synth, time, print digest.
 // ---------------------------------------------------------------------------
@@ -371,23 +175,15 @@ const char *levelName(Level l)
     return "?";
 }
 
-// Auto-calibrated timing: each scenario fills `target_sample_ms` of
-// wall-clock per timed sample (default 30 ms → 17 scenarios × 15 samples ×
-// ~30 ms ≈ 8 s total). Overridable per-scenario, and globally via
-// PERF_SAMPLE_MS env var.
-struct RunOptions
-{
-    int samples{15};
-    int warmup{3};
-    double target_sample_ms{100.0};
-};
-
 void runScenario(const char *tag, Level level, const ScenarioSpec &spec, int numVoices,
                  RunOptions opts = {})
 {
-    auto synth = bringUpSynth(spec, numVoices);
+    auto synth = bringUpSynth(spec, numVoices, 48000.0, opts.polySine);
+    applyRunOptions(*synth, opts);
 
     uint64_t hash = hashOneOutputBlock(*synth);
+    // Only the timed blocks, not the bring up and its note attacks
+    synth->processTiming.requestReset();
 
     BenchResult r;
     switch (level)
@@ -414,12 +210,85 @@ void runScenario(const char *tag, Level level, const ScenarioSpec &spec, int num
     d.iters_per_sample = r.iters_per_sample;
     d.hash = hash;
     printDigest(d);
+    if (level == Level::Plugin)
+        printTiming(tag, synth->processTiming);
 
     // Catch2 sanity: at least confirm we got non-trivial timing and a real hash.
     REQUIRE(r.median_ns_per_iter > 0);
     REQUIRE(hash != 0);
 }
 
+// SinTable backend comparison: SinTable::atBlock over a run of scattered phases (the
+// access pattern an FM'd operator makes), rotating through `waveforms` call by call
+// so the table rows compete for cache the way a multi-timbral session does. The
+// digest is per lookup, and notes carry the worst error against the table backend.
+void runSinTableScenario(const char *tag, SinTable::Backend backend,
+                         const std::vector<SinTable::WaveForm> &waveforms)
+{
+    static constexpr int n{4096};
+    uint32_t ph alignas(16)[n];
+    uint32_t x{0x2468ace};
+    for (int i = 0; i < n; ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+        ph[i] = x;
+    }
+
+    std::vector<SinTable> tables(waveforms.size());
+    float maxErr{0.f};
+    for (size_t w = 0; w < waveforms.size(); ++w)
+    {
+        SinTable::prepareWaveForm(waveforms[w]);
+        SinTable ref;
+        ref.setWaveForm(waveforms[w]);
+        tables[w].setWaveForm(waveforms[w], backend);
+        for (int i = 0; i < n; ++i)
+        {
+            auto v = tables[w].usesPoly() ? tables[w].atPoly(ph[i]) : tables[w].at(ph[i]);
+            maxErr = std::max(maxErr, std::fabs(v - ref.at(ph[i])));
+        }
+    }
+
+    float out alignas(16)[n];
+    size_t which{0};
+    auto r = timeIt(15, 3, 100.0,
+                    [&]()
+                    {
+                        tables[which].atBlock(ph, out, n);
+                        which = (which + 1) % tables.size();
+                    });
+
+    uint64_t hash{0};
+    for (auto &t : tables)
+    {
+        t.atBlock(ph, out, n);
+        hash = hash * 0x9E3779B97F4A7C15ull ^ hashFloats(out, n);
+    }
+
+    char notes[64];
+    std::snprintf(notes, sizeof(notes), "max_err=%.3e", maxErr);
+    DigestParams d{};
+    d.tag = tag;
+    d.level = "inner";
+    d.voices = 1;
+    d.activeOps = (int)waveforms.size();
+    d.block_ns = r.median_ns_per_iter;
+    d.samplesPerBlock = n;
+    d.stddev_pct = r.stddev_pct;
+    d.iters_per_sample = r.iters_per_sample;
+    d.hash = hash;
+    d.notes = notes;
+    printDigest(d);
+
+    REQUIRE(r.median_ns_per_iter > 0);
+    REQUIRE(maxErr < 1e-3f);
+}
+
+const std::vector<SinTable::WaveForm> polyWaveforms{
+    SinTable::SIN,       SinTable::TX2,       SinTable::TX3,       SinTable::TX4,
+    SinTable::TX5,       SinTable::TX6,       SinTable::TX7,       SinTable::TX8,
+    SinTable::SPIKY_TX2, SinTable::SPIKY_TX4, SinTable::SPIKY_TX6, SinTable::SPIKY_TX8};
+
 } // namespace
 
 // ---------------------------------------------------------------------------
@@ -476,6 +345,154 @@ TEST_CASE("64 voice, dense", "[bench][plugin][scn:64v_dense]")
     runScenario("scn:64v_dense", Level::Plugin, spec, 64);
 }
 
+// Serial (voice-by-voice) mirrors of the heavy poly rows, to show what the
+// cross-voice SIMD pack buys. Hashes must match the packed rows.
+TEST_CASE("32 voice, dense, serial", "[bench][plugin][scn:32v_dense_serial]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    RunOptions opts;
+    opts.voicePack = false;
+    runScenario("scn:32v_dense_serial", Level::Plugin, spec, 32, opts);
+}
+
+TEST_CASE("64 voice, dense, serial", "[bench][plugin][scn:64v_dense_serial]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    RunOptions opts;
+    opts.voicePack = false;
+    runScenario("scn:64v_dense_serial", Level::Plugin, spec, 64, opts);
+}
+
+// Multi-core mirror of the max poly row. Timing is wall clock on the calling
+// thread, so this shows the per-block latency win, not total CPU. Hash must match.
+TEST_CASE("64 voice, dense, 3 render workers", "[bench][plugin][scn:64v_dense_mt]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    RunOptions opts;
+    opts.renderWorkers = 3;
+    runScenario("scn:64v_dense_mt", Level::Plugin, spec, 64, opts);
+}
+
+// Macro-block mirror of the max poly row: each voice renders 4 blocks per pass
+// while its state is in cache. Modulation still runs every block; hash must match.
+TEST_CASE("64 voice, dense, 4 block macro render", "[bench][plugin][scn:64v_dense_macro4]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    RunOptions opts;
+    opts.macroBlocks = 4;
+    runScenario("scn:64v_dense_macro4", Level::Plugin, spec, 64, opts);
+}
+
+// The libsamplerate sinc at its best quality, per engine block and batched 8 blocks a
+// call. Batching only moves the call boundaries, so the two hashes should match.
+TEST_CASE("8 voice, dense, SRC best", "[bench][plugin][scn:8v_dense_srcbest]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.resampler = SRC_BEST;
+    runScenario("scn:8v_dense_srcbest", Level::Plugin, spec, 8);
+}
+
+TEST_CASE("8 voice, dense, SRC best, 8 block batch",
+          "[bench][plugin][scn:8v_dense_srcbest_batch8]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.resampler = SRC_BEST;
+    RunOptions opts;
+    opts.srcBatchBlocks = 8;
+    runScenario("scn:8v_dense_srcbest_batch8", Level::Plugin, spec, 8, opts);
+}
+
+// The end of chain with saturation, bit depth and output gain split by the lowpass,
+// so two fused shaper passes and a filter at the engine rate
+TEST_CASE("8 voice, dense, output stages", "[bench][plugin][scn:8v_dense_outstages]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.outputStages = true;
+    runScenario("scn:8v_dense_outstages", Level::Plugin, spec, 8);
+}
+
+// The ultrasonic brickwall as an explicit 16 pole filter ahead of SRC, and folded into
+// the polyphase decimator (HQ tier) with nothing non-linear in the chain
+TEST_CASE("8 voice, dense, ultrasonic filter", "[bench][plugin][scn:8v_dense_ultrasonic]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.ultrasonic = true;
+    runScenario("scn:8v_dense_ultrasonic", Level::Plugin, spec, 8);
+}
+
+TEST_CASE("8 voice, dense, ultrasonic folded into polyphase",
+          "[bench][plugin][scn:8v_dense_ultrasonic_poly]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.ultrasonic = true;
+    spec.resampler = POLYPHASE;
+    runScenario("scn:8v_dense_ultrasonic_poly", Level::Plugin, spec, 8);
+}
+
+// Every voice started mid block, as sample accurate events start them, so each block
+// pays the start delay shift. Output is the plain row's delayed, so the hash differs.
+TEST_CASE("8 voice, dense, delayed note start", "[bench][plugin][scn:8v_dense_delayed]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.noteStartDelay = blockSize / 2 + 1;
+    runScenario("scn:8v_dense_delayed", Level::Plugin, spec, 8);
+}
+
+// Polynomial sine mirror of the serial max poly row (POLY operators don't pack).
+// Output differs from the table rows by float rounding, so the hash does too.
+TEST_CASE("64 voice, dense, serial, poly sine", "[bench][plugin][scn:64v_dense_serial_poly]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    RunOptions opts;
+    opts.voicePack = false;
+    opts.polySine = true;
+    runScenario("scn:64v_dense_serial_poly", Level::Plugin, spec, 64, opts);
+}
+
 TEST_CASE("16 voice, PHASE_REMAP", "[bench][plugin][scn:em_phaseremap]")
 {
     ScenarioSpec spec{};
@@ -530,6 +547,58 @@ TEST_CASE("worst case: 64v + NOISE + everything", "[bench][plugin][scn:worst]")
     runScenario("scn:worst", Level::Plugin, spec, 64);
 }
 
+// ---------------------------------------------------------------------------
+// Tail latency: the histograms over a realistic run rather than a steady state.
+// Five voice unison notes start every 20 ms on a dense patch, so some blocks
+// carry a burst of attacks (voice init, op resets, noise warmup) on top of up to
+// 40 sounding voices. Prints only [tail:...] lines; the block_ns rows above
+// stay the steady state numbers.
+// ---------------------------------------------------------------------------
+
+TEST_CASE("tail: 5 voice unison attacks, dense", "[tail][plugin][scn:tail_unison]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    auto synth = bringUpSynth(spec, 0);
+    synth->patch.output.unisonCount.value = 5;
+    synth->processTiming.requestReset();
+
+    static constexpr double seconds{4.0}, noteEvery{0.02};
+    static constexpr int held{8};
+    auto blocks = (int)(seconds * synth->hostSampleRate / blockSize);
+    auto blocksPerNote = (int)(noteEvery * synth->hostSampleRate / blockSize);
+    int notes{0};
+    for (int b = 0; b < blocks; ++b)
+    {
+        if (b % blocksPerNote == 0)
+        {
+            if (notes >= held)
+                synth->voiceManager->processNoteOffEvent(0, 0, 36 + (notes - held) % 60, -1, 0.f);
+            synth->voiceManager->processNoteOnEvent(0, 0, 36 + notes % 60, -1, 0.8f, 0.f);
+            notes++;
+        }
+        synth->process(nullptr);
+    }
+
+    printTiming("scn:tail_unison", synth->processTiming);
+
+    auto blockTiming = synth->processTiming.block.summary();
+    auto attackTiming = synth->processTiming.attack.summary();
+    REQUIRE(blockTiming.count == (uint64_t)blocks);
+    // A note which finds every voice still fading out makes none and records no attack
+    REQUIRE(attackTiming.count > 0);
+    REQUIRE(attackTiming.count <= (uint64_t)notes);
+    REQUIRE(blockTiming.p50 <= blockTiming.p99);
+    REQUIRE(blockTiming.p99 <= blockTiming.max);
+    // However slow, a block is not an xrun; only a host buffer can be
+    REQUIRE(blockTiming.over == 0);
+    REQUIRE(blockTiming.late == 0);
+    REQUIRE(attackTiming.late == 0);
+}
+
 // ---------------------------------------------------------------------------
 // Voice-level mirrors of a couple key scenarios — same patches, no SRC tail.
 // Useful when PERFORMANCE.md changes are voice-internal and we want to see
@@ -603,3 +672,29 @@ TEST_CASE("inner: EM::NOISE", "[bench][inner][scn:inner_noise]")
     spec.em = Patch::SourceNode::ExtendedMode::NOISE;
     runScenario("scn:inner_noise", Level::Inner, spec, 1);
 }
+
+// ---------------------------------------------------------------------------
+// SinTable backends — table lookup against the minimax polynomial, on SIN alone
+// (one 256 KB table row, warm in L2) and rotating through all twelve waveforms
+// the polynomial covers (3 MB of table rows).
+// ---------------------------------------------------------------------------
+
+TEST_CASE("sintable: table, SIN", "[bench][inner][scn:sintable_table_sin]")
+{
+    runSinTableScenario("scn:sintable_table_sin", SinTable::TABLE, {SinTable::SIN});
+}
+
+TEST_CASE("sintable: poly, SIN", "[bench][inner][scn:sintable_poly_sin]")
+{
+    runSinTableScenario("scn:sintable_poly_sin", SinTable::POLY, {SinTable::SIN});
+}
+
+TEST_CASE("sintable: table, SIN and TX", "[bench][inner][scn:sintable_table_tx]")
+{
+    runSinTableScenario("scn:sintable_table_tx", SinTable::TABLE, polyWaveforms);
+}
+
+TEST_CASE("sintable: poly, SIN and TX", "[bench][inner][scn:sintable_poly_tx]")
+{
+    runSinTableScenario("scn:sintable_poly_tx", SinTable::POLY, polyWaveforms);
+}
@@ -131,6 +131,7 @@ inline uint64_t hashFloats(const float *data, size_t n)
 //   stddev_pct=2.1 hash=0x...
 //
 // `level` is one of: plugin, voice, inner.
+// `engine_block` is the compile time blockSize of the impl library under test.
 // `block_ns` is wall-clock per host (or engine) block, depending on level.
 // `sample_ns` is per audio sample at the host rate.
 // `cpu_pct_48k` is what fraction of a 48 kHz host realtime budget this
@@ -163,10 +164,10 @@ inline void printDigest(const DigestParams &d)
     double cpu_pct_48k = (sample_ns / 1e9) * 48000.0 * 100.0;
     double vops_per_s =
         (sample_ns > 0) ? (double)d.voices * (double)d.activeOps * 1e9 / sample_ns : 0.0;
-    std::printf("[%s] level=%s voices=%d ops=%d block_ns=%.1f sample_ns=%.2f "
+    std::printf("[%s] level=%s voices=%d ops=%d engine_block=%d block_ns=%.1f sample_ns=%.2f "
                 "cpu_pct_48k=%.2f vops_per_s=%.3e stddev_pct=%.2f iters=%d hash=0x%016llx%s%s\n",
-                d.tag, d.level, d.voices, d.activeOps, d.block_ns, sample_ns, cpu_pct_48k,
-                vops_per_s, d.stddev_pct, d.iters_per_sample,
+                d.tag, d.level, d.voices, d.activeOps, (int)blockSize, d.block_ns, sample_ns,
+                cpu_pct_48k, vops_per_s, d.stddev_pct, d.iters_per_sample,
                 static_cast<unsigned long long>(d.hash), (d.notes && d.notes[0]) ? " " : "",
                 d.notes ? d.notes : "");
     std::fflush(stdout);
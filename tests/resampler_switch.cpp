@@ -0,0 +1,214 @@
+/*
+ * Sample rate strategy and resampler engine switching.
+ *
+ * Every resampler variant is built by setSampleRate, so a change arriving on
+ * the audio thread only re-points into the pools. A change while running fades
+ * the output out over 20ms, switches at silence and fades back in. Voices
+ * survive an engine change; a strategy change moves the engine rate, which
+ * voices latch at attack, so it stops them once the output is silent.
+ *
+ * The SRC engines can batch several engine blocks into one libsamplerate call,
+ * which moves the call boundaries but not the resampled stream.
+ *
+ * With the polyphase engine and a linear output chain the ultrasonic brickwall
+ * folds into the decimator's HQ tier; a non-linear stage brings the explicit filter
+ * back from the next block, and the tier only moves once the engine is idle.
+ */
+
+#include "catch2/catch2.hpp"
+#include "test_synth_setup.h"
+
+#include "configuration.h"
+#include "synth/patch.h"
+#include "synth/synth.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace baconpaul::six_sines;
+
+namespace
+{
+std::unique_ptr<Synth> bringUpSynth(ResamplerEngine engine = SRC_FAST)
+{
+    test::TestSynthSetup setup;
+    setup.engine = engine;
+    return test::bringUpTestSynth(setup);
+}
+
+float blockPeak(const Synth &s)
+{
+    float res{0.f};
+    for (int c = 0; c < 2; ++c)
+        for (int i = 0; i < blockSize; ++i)
+            res = std::max(res, std::fabs(s.output[c][i]));
+    return res;
+}
+
+void setAndNotify(Synth &s, Param &p, float v)
+{
+    p.value = v;
+    s.handleAudioThreadParamSideEffects(&p);
+}
+} // namespace
+
+TEST_CASE("resampler engine switch keeps voices", "[resampler]")
+{
+    auto s = bringUpSynth();
+    REQUIRE(s->resamplerEngine == SRC_FAST);
+    s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    for (int blk = 0; blk < 200; ++blk)
+        s->process(nullptr);
+    REQUIRE(blockPeak(*s) > 0.f);
+
+    auto *lanczos0 = s->lanczosPool[s->sampleRateStrategy][0].get();
+    setAndNotify(*s, s->patch.output.resampleEngine, (float)LANCZOS);
+    REQUIRE(s->resamplerSwitchPending);
+    REQUIRE(s->resamplerEngine == SRC_FAST);
+
+    for (int blk = 0; blk < s->resamplerFadeBlocks; ++blk)
+        s->process(nullptr);
+    // Faded to silence and switched onto the pooled resampler
+    REQUIRE(s->output[0][blockSize - 1] == 0.f);
+    REQUIRE(s->output[1][blockSize - 1] == 0.f);
+    REQUIRE(!s->resamplerSwitchPending);
+    REQUIRE(s->resamplerEngine == LANCZOS);
+    REQUIRE(s->resampler[0] == lanczos0);
+    REQUIRE(s->voiceCount == 1);
+
+    for (int blk = 0; blk < 200; ++blk)
+        s->process(nullptr);
+    REQUIRE(s->resamplerFadeLevel == s->resamplerFadeBlocks);
+    REQUIRE(blockPeak(*s) > 0.f);
+}
+
+TEST_CASE("sample rate strategy switch stops voices at silence", "[resampler]")
+{
+    auto s = bringUpSynth();
+    auto oldRate = s->engineSampleRate;
+    s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    for (int blk = 0; blk < 200; ++blk)
+        s->process(nullptr);
+
+    setAndNotify(*s, s->patch.output.sampleRateStrategy, (float)SR_176192);
+    for (int blk = 0; blk < s->resamplerFadeBlocks - 1; ++blk)
+    {
+        s->process(nullptr);
+        REQUIRE(s->voiceCount == 1);
+        REQUIRE(s->engineSampleRate == oldRate);
+    }
+    s->process(nullptr);
+    REQUIRE(s->voiceCount == 0);
+    REQUIRE(s->engineSampleRate == 192000.0);
+    REQUIRE(s->monoValues.sr.sampleRate == 192000.0);
+}
+
+TEST_CASE("batched SRC matches per block SRC", "[resampler]")
+{
+    for (auto engine : {SRC_FAST, SRC_BEST})
+    {
+        for (auto batch : {2, 5, (int)maxSRCBatchBlocks})
+        {
+            DYNAMIC_SECTION("Engine " << engine << " batch " << batch)
+            {
+                auto single = bringUpSynth(engine);
+                auto batched = bringUpSynth(engine);
+                batched->srcBatchBlocks = batch;
+                for (auto *s : {single.get(), batched.get()})
+                {
+                    REQUIRE(s->resamplerEngine == engine);
+                    s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+                }
+
+                bool anyNonZero{false};
+                for (int blk = 0; blk < 300; ++blk)
+                {
+                    single->process(nullptr);
+                    batched->process(nullptr);
+                    for (int c = 0; c < 2; ++c)
+                    {
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            INFO("block " << blk << " channel " << c << " sample " << i);
+                            REQUIRE(batched->output[c][i] ==
+                                    Approx(single->output[c][i]).margin(1e-6));
+                            anyNonZero = anyNonZero || single->output[c][i] != 0.f;
+                        }
+                    }
+                }
+                REQUIRE(anyNonZero);
+            }
+        }
+    }
+}
+
+TEST_CASE("ultrasonic filter folds into the polyphase decimator", "[resampler]")
+{
+    auto hasUltrasonicStage = [](const Synth &s)
+    {
+        for (int i = 0; i < s.numEndStages; ++i)
+            if (s.endStages[i].kind == Synth::ES_ULTRASONIC)
+                return true;
+        return false;
+    };
+
+    SECTION("SRC keeps the explicit filter")
+    {
+        auto s = bringUpSynth(SRC_FAST);
+        setAndNotify(*s, s->patch.output.ultrasonicFilter, 1.f);
+        REQUIRE(!s->ultrasonicFolded);
+        REQUIRE(hasUltrasonicStage(*s));
+    }
+
+    SECTION("Polyphase folds it with a linear chain and unfolds for saturation")
+    {
+        auto s = bringUpSynth(POLYPHASE);
+        REQUIRE(s->decimatorTier == PolyphaseDecimator::STANDARD);
+        s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+        for (int blk = 0; blk < 50; ++blk)
+            s->process(nullptr);
+
+        // Turning it on while playing runs the explicit filter, with no fade, and the
+        // decimators keep their tier until the engine is idle
+        setAndNotify(*s, s->patch.output.ultrasonicFilter, 1.f);
+        REQUIRE(!s->resamplerSwitchPending);
+        REQUIRE(!s->ultrasonicFolded);
+        REQUIRE(hasUltrasonicStage(*s));
+        for (int blk = 0; blk < 50; ++blk)
+        {
+            s->process(nullptr);
+            REQUIRE(blockPeak(*s) > 0.f);
+        }
+        REQUIRE(s->decimatorTier == PolyphaseDecimator::STANDARD);
+
+        s->voiceManager->processNoteOffEvent(0, 0, 60, -1, 0.f);
+        for (int blk = 0; blk < 100000 && !s->isIdle(); ++blk)
+            s->process(nullptr);
+        REQUIRE(s->isIdle());
+        REQUIRE(s->decimatorTier == PolyphaseDecimator::HQ);
+        REQUIRE(s->ultrasonicFolded);
+        REQUIRE(!hasUltrasonicStage(*s));
+
+        s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+        for (int blk = 0; blk < 50; ++blk)
+            s->process(nullptr);
+        REQUIRE(blockPeak(*s) > 0.f);
+
+        // A saturator unfolds it from the next block, again without a fade
+        setAndNotify(*s, s->patch.output.saturationType, (float)SAT_SOFT);
+        REQUIRE(!s->resamplerSwitchPending);
+        REQUIRE(!s->ultrasonicFolded);
+        REQUIRE(hasUltrasonicStage(*s));
+        for (int blk = 0; blk < 50; ++blk)
+        {
+            s->process(nullptr);
+            REQUIRE(blockPeak(*s) > 0.f);
+        }
+        REQUIRE(s->decimatorTier == PolyphaseDecimator::HQ);
+        REQUIRE(s->voiceCount == 1);
+
+        setAndNotify(*s, s->patch.output.saturationType, (float)SAT_NONE);
+        REQUIRE(s->ultrasonicFolded);
+        REQUIRE(!hasUltrasonicStage(*s));
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * SinTable lookups. The block lookup runs four phases per SIMD op and has to
+ * match the one-at-a-time lookup exactly, since the no-feedback inner loop
+ * switches between them depending on the operator's routing.
+ *
+ * The POLY backend evaluates SIN and the TX shapes from a polynomial instead of
+ * the tables. It should land within float rounding of the table wherever the shape
+ * is smooth; the table's hermite rounds off the kink in the middle of each
+ * SPIKY_TX6 / TX8 quadrant, so those get more room.
+ *
+ * Tables other than SIN and HANN_WINDOW build on demand, all of them at activate.
+ * Selecting one which still isn't built builds it, rather than playing another shape.
+ */
+
+#include "catch2/catch2.hpp"
+#include "dsp/sintable.h"
+
+#include <cmath>
+#include <cstdint>
+
+using namespace baconpaul::six_sines;
+
+TEST_CASE("atBlock matches at", "[sintable]")
+{
+    SinTable st;
+    static constexpr int n{64};
+
+    // An LCG over the full 32 bit range, so the unmasked high bits get exercised too
+    uint32_t ph alignas(16)[n];
+    uint32_t x{0x1234567};
+    for (int i = 0; i < n; ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+        ph[i] = x;
+    }
+    ph[0] = 0;
+    ph[1] = phase::phaseMask;
+    ph[2] = phase::halfPhase;
+
+    for (int wf = 0; wf < (int)SinTable::AUDIO_IN; ++wf)
+    {
+        INFO("Waveform " << wf);
+        SinTable::prepareWaveForm((SinTable::WaveForm)wf);
+        st.setWaveForm((SinTable::WaveForm)wf);
+        float out alignas(16)[n];
+        st.atBlock(ph, out, n);
+        for (int i = 0; i < n; ++i)
+        {
+            INFO("Phase " << ph[i]);
+            REQUIRE(out[i] == st.at(ph[i]));
+        }
+    }
+}
+
+TEST_CASE("poly backend tracks the table", "[sintable]")
+{
+    SinTable table, poly;
+    static constexpr int n{4096};
+
+    uint32_t ph alignas(16)[n];
+    uint32_t x{0x7654321};
+    for (int i = 0; i < n; ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+        ph[i] = (i % 2) ? x : (uint32_t)i * (phase::phaseMax / n);
+    }
+
+    for (int wf = 0; wf < (int)SinTable::AUDIO_IN; ++wf)
+    {
+        auto w = (SinTable::WaveForm)wf;
+        if (!SinTable::hasPolyBackend(w))
+            continue;
+
+        INFO("Waveform " << wf);
+        SinTable::prepareWaveForm(w);
+        poly.setWaveForm(w, SinTable::POLY);
+        table.setWaveForm(w);
+        REQUIRE(poly.usesPoly());
+        REQUIRE(!table.usesPoly());
+
+        auto tol = (w == SinTable::SPIKY_TX6 || w == SinTable::SPIKY_TX8) ? 2.5e-4f : 1e-6f;
+        float out alignas(16)[n];
+        poly.atBlock(ph, out, n);
+        for (int i = 0; i < n; ++i)
+        {
+            INFO("Phase " << ph[i]);
+            REQUIRE(out[i] == poly.atPoly(ph[i]));
+            REQUIRE(std::fabs(out[i] - table.at(ph[i])) < tol);
+        }
+    }
+
+    // A waveform with no POLY kernel stays on its table whatever is asked for
+    REQUIRE(!SinTable::hasPolyBackend(SinTable::SAWISH));
+    SinTable::prepareWaveForm(SinTable::SAWISH);
+    poly.setWaveForm(SinTable::SAWISH, SinTable::POLY);
+    REQUIRE(!poly.usesPoly());
+}
+
+TEST_CASE("waveform tables build before they play", "[sintable]")
+{
+    SinTable st;
+    REQUIRE(SinTable::isWaveFormReady(SinTable::SIN));
+    REQUIRE(SinTable::isWaveFormReady(SinTable::HANN_WINDOW));
+    REQUIRE(SinTable::isWaveFormReady(SinTable::AUDIO_IN));
+
+    // Statics are shared with the other tests, so TUKEY_WINDOW may already be built. If it
+    // isn't, selecting it builds it; it never reads the SIN row in its place.
+    auto w = SinTable::TUKEY_WINDOW;
+    st.setWaveForm(w);
+    REQUIRE(SinTable::isWaveFormReady(w));
+    REQUIRE(st.simdQuad == SinTable::simdFullQuad[w]);
+    // Tukey is flat at 1 across the middle of the cycle
+    REQUIRE(st.at(phase::halfPhase) == Approx(1.f).margin(1e-6));
+
+    // What activate runs
+    SinTable::prepareAllWaveForms();
+    for (int wf = 0; wf < (int)SinTable::NUM_WAVEFORMS; ++wf)
+        REQUIRE(SinTable::isWaveFormReady((SinTable::WaveForm)wf));
+}
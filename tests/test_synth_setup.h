@@ -0,0 +1,59 @@
+/*
+ * The synth the engine tests start from, ready for notes: poly over every voice, no
+ * unison, and the first playingOps operators each heard through its own mixer at half
+ * level. TestSynthSetup picks the engine side (multi out, resampler, rate strategy) and
+ * configure runs on the patch after the defaults, before the waveforms are prepared and
+ * the control settings read, so a test can change or replace any of it.
+ */
+
+#ifndef BACONPAUL_SIX_SINES_TESTS_TEST_SYNTH_SETUP_H
+#define BACONPAUL_SIX_SINES_TESTS_TEST_SYNTH_SETUP_H
+
+#include <functional>
+#include <memory>
+
+#include "configuration.h"
+#include "synth/patch.h"
+#include "synth/synth.h"
+#include "dsp/sintable.h"
+
+namespace baconpaul::six_sines::test
+{
+struct TestSynthSetup
+{
+    bool multiOut{false};
+    ResamplerEngine engine{SRC_FAST};
+    SampleRateStrategy strategy{SR_110120};
+    int playingOps{1};
+    double hostSampleRate{48000.0};
+};
+
+inline std::unique_ptr<Synth> bringUpTestSynth(const TestSynthSetup &setup = {},
+                                               const std::function<void(Patch &)> &configure = {})
+{
+    auto s = std::make_unique<Synth>(setup.multiOut);
+    // setSampleRate builds the resamplers for the engine and strategy in the patch
+    s->patch.output.resampleEngine.value = (float)setup.engine;
+    s->patch.output.sampleRateStrategy.value = (float)setup.strategy;
+    s->setSampleRate(setup.hostSampleRate);
+
+    auto &p = s->patch;
+    p.output.level.value = 0.5f;
+    p.output.playMode.value = 0.f; // poly
+    p.output.polyLimit.value = (float)maxVoices;
+    p.output.unisonCount.value = 1.f;
+    for (int i = 0; i < setup.playingOps; ++i)
+    {
+        p.sourceNodes[i].active.value = 1.f;
+        p.mixerNodes[i].active.value = 1.f;
+        p.mixerNodes[i].level.value = 0.5f;
+    }
+    if (configure)
+        configure(p);
+
+    Synth::prepareWaveFormsFor(p);
+    s->reapplyControlSettings();
+    return s;
+}
+} // namespace baconpaul::six_sines::test
+#endif // TEST_SYNTH_SETUP_H
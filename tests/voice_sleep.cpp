@@ -0,0 +1,250 @@
+/*
+ * Silence-aware voice retirement and dormant operators.
+ *
+ * A held note whose mixers have all decayed to a zero sustain can't make a
+ * sound again until something reattacks, so it retires once its output has
+ * been under the sleep threshold for a while, rather than holding a voice until
+ * note off. A released voice retires once it has been under the threshold for a
+ * while and nothing can bring it back up, rather than at the end of its release;
+ * under a tremolo it plays on.
+ *
+ * Operators which can't reach the output, through their mixer or through the
+ * matrix into an operator which can, are skipped rather than rendered. That is
+ * recomputed every block, so it follows settled envelopes. A zero level can be
+ * automated back up, so it keeps the operator and its envelopes running.
+ *
+ * With no voices left and the output tails rung out, the whole engine reports
+ * itself idle so the plugin can stop processing.
+ */
+
+#include "catch2/catch2.hpp"
+#include "test_synth_setup.h"
+
+#include "configuration.h"
+#include "synth/matrix_index.h"
+#include "synth/patch.h"
+#include "synth/synth.h"
+#include "synth/voice.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace baconpaul::six_sines;
+
+namespace
+{
+void setEnv(Patch::DAHDSRMixin &e, float decay, float sustain)
+{
+    e.delay.value = 0.f;
+    e.attack.value = 0.f;
+    e.hold.value = 0.f;
+    e.decay.value = decay;
+    e.sustain.value = sustain;
+    e.release.value = 0.5f;
+    e.envPower.value = 1.f;
+    e.envIsMultiplcative.value = 1.f;
+    e.envIsOneShot.value = 0.f;
+}
+
+// Op 2 is heard through a mixer with a bell envelope (short decay, no sustain). Op 1 only
+// modulates op 2, through a matrix node with the same envelope.
+void configureBellPatch(Patch &patch)
+{
+    patch.output.level.value = 0.5f;
+    patch.output.playMode.value = 0.f; // poly
+    patch.output.polyLimit.value = (float)maxVoices;
+    patch.output.unisonCount.value = 1.f;
+    setEnv(patch.output, 0.f, 1.f);
+
+    for (int i = 0; i < (int)numOps; ++i)
+    {
+        patch.sourceNodes[i].active.value = (i < 2) ? 1.f : 0.f;
+        patch.sourceNodes[i].ratio.value = 0.f;
+        patch.sourceNodes[i].keyTrack.value = 1.f;
+        setEnv(patch.sourceNodes[i], 0.f, 1.f);
+
+        patch.mixerNodes[i].active.value = (i == 1) ? 1.f : 0.f;
+        patch.mixerNodes[i].level.value = 0.5f;
+        setEnv(patch.mixerNodes[i], 0.1f, 0.f);
+
+        patch.selfNodes[i].active.value = 0.f;
+    }
+    for (int i = 0; i < (int)matrixSize; ++i)
+        patch.matrixNodes[i].active.value = 0.f;
+
+    auto &mx = patch.matrixNodes[MatrixIndex::positionForSourceTarget(0, 1)];
+    mx.active.value = 1.f;
+    mx.level.value = 0.3f;
+    setEnv(mx, 0.1f, 0.f);
+}
+
+std::unique_ptr<Synth> bringUpSynth() { return test::bringUpTestSynth({}, configureBellPatch); }
+
+bool renderForSeconds(Synth &s, float seconds)
+{
+    bool anyNonZero{false};
+    auto blocks = (int)(seconds * 48000 / blockSize);
+    for (int b = 0; b < blocks; ++b)
+    {
+        s.process(nullptr);
+        for (int i = 0; i < blockSize; ++i)
+            anyNonZero = anyNonZero || s.output[0][i] != 0.f;
+    }
+    return anyNonZero;
+}
+} // namespace
+
+TEST_CASE("held voice at zero sustain retires once silent", "[voice_sleep]")
+{
+    auto synth = bringUpSynth();
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    REQUIRE(synth->voiceCount == 1);
+    REQUIRE(renderForSeconds(*synth, 0.02f));
+    REQUIRE(synth->voiceCount == 1);
+
+    renderForSeconds(*synth, 4.f);
+    REQUIRE(synth->voiceCount == 0);
+}
+
+TEST_CASE("released voice under the threshold retires before its release ends",
+          "[voice_sleep]")
+{
+    auto synth = bringUpSynth();
+    // A held mixer, as a pad's constant one, and the voice taken under the threshold at
+    // its output long before the output envelope has released
+    setEnv(synth->patch.mixerNodes[1], 0.f, 1.f);
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    REQUIRE(renderForSeconds(*synth, 0.02f));
+    synth->patch.output.level.value = 0.f;
+    synth->voiceManager->processNoteOffEvent(0, 0, 60, -1, 0.f);
+
+    renderForSeconds(*synth, 1.5f * Voice::silenceSecondsBeforeSleep);
+    REQUIRE(synth->voiceCount == 0);
+}
+
+TEST_CASE("quiet released voice keeps playing under a tremolo", "[voice_sleep]")
+{
+    auto synth = bringUpSynth();
+    setEnv(synth->patch.mixerNodes[1], 0.f, 1.f);
+    synth->patch.mixerNodes[1].lfoToLevel.value = 0.5f;
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    REQUIRE(renderForSeconds(*synth, 0.02f));
+    synth->patch.output.level.value = 0.f;
+    synth->voiceManager->processNoteOffEvent(0, 0, 60, -1, 0.f);
+
+    // Well past the silence hold, but still inside the release
+    renderForSeconds(*synth, 1.5f * Voice::silenceSecondsBeforeSleep);
+    REQUIRE(synth->voiceCount == 1);
+}
+
+TEST_CASE("engine goes idle once the last voice has rung out", "[voice_sleep]")
+{
+    auto synth = bringUpSynth();
+    renderForSeconds(*synth, 2 * Synth::idleSeconds);
+    REQUIRE(synth->isIdle());
+
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    REQUIRE(renderForSeconds(*synth, 0.02f));
+    REQUIRE(!synth->isIdle());
+
+    // The voice retires, then the tails have to stay quiet for idleSeconds
+    renderForSeconds(*synth, 4.f);
+    REQUIRE(synth->voiceCount == 0);
+    REQUIRE(synth->isIdle());
+}
+
+TEST_CASE("voice sleeping can be turned off", "[voice_sleep]")
+{
+    auto synth = bringUpSynth();
+    synth->setVoiceSleepThresholdDb(0);
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    renderForSeconds(*synth, 4.f);
+    REQUIRE(synth->voiceCount == 1);
+}
+
+TEST_CASE("operator feeding only decayed nodes goes dormant", "[voice_sleep]")
+{
+    auto synth = bringUpSynth();
+    synth->setVoiceSleepThresholdDb(0);
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    renderForSeconds(*synth, 0.02f);
+
+    auto *v = synth->head;
+    REQUIRE(v);
+    REQUIRE(!v->src[0].dormant);
+    REQUIRE(!v->src[1].dormant);
+
+    renderForSeconds(*synth, 4.f);
+    REQUIRE(v->src[0].dormant);
+    REQUIRE(v->src[1].dormant);
+    for (int i = 0; i < blockSize; ++i)
+    {
+        REQUIRE(v->src[0].output[i] == 0.f);
+        REQUIRE(v->src[1].output[i] == 0.f);
+    }
+
+    // Release from zero sustain stays silent, and the voice still ends normally
+    synth->voiceManager->processNoteOffEvent(0, 0, 60, -1, 0.f);
+    REQUIRE(!renderForSeconds(*synth, 4.f));
+    REQUIRE(synth->voiceCount == 0);
+}
+
+TEST_CASE("unrouted operators are skipped", "[voice_sleep]")
+{
+    auto synth = bringUpSynth();
+    synth->setVoiceSleepThresholdDb(0);
+    auto &patch = synth->patch;
+    // Sustained everything, and op 3 on but routed nowhere
+    for (int i = 0; i < (int)numOps; ++i)
+        setEnv(patch.mixerNodes[i], 0.f, 1.f);
+    auto &mx = patch.matrixNodes[MatrixIndex::positionForSourceTarget(0, 1)];
+    setEnv(mx, 0.f, 1.f);
+    patch.sourceNodes[2].active.value = 1.f;
+
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    REQUIRE(renderForSeconds(*synth, 0.01f));
+
+    auto *v = synth->head;
+    REQUIRE(v);
+    REQUIRE(!v->src[0].dormant);
+    REQUIRE(!v->src[1].dormant);
+    REQUIRE(v->src[2].dormant);
+
+    // A route at zero depth can be turned back up, so the modulator keeps running
+    mx.level.value = 0.f;
+    renderForSeconds(*synth, 0.01f);
+    REQUIRE(!v->src[0].dormant);
+    REQUIRE(!v->src[1].dormant);
+
+    // And so does a carrier whose mixer is at zero, silent as it is
+    patch.mixerNodes[1].level.value = 0.f;
+    REQUIRE(!renderForSeconds(*synth, 0.05f));
+    for (int i = 0; i < 2; ++i)
+        REQUIRE(!v->src[i].dormant);
+    REQUIRE(v->src[2].dormant);
+}
+
+TEST_CASE("a level brought up mid note finds its envelopes already run", "[voice_sleep]")
+{
+    auto synth = bringUpSynth();
+    synth->setVoiceSleepThresholdDb(0);
+    auto &patch = synth->patch;
+    // The carrier's mixer and op 2's own envelope decay to a held, non zero sustain
+    setEnv(patch.mixerNodes[1], 0.1f, 0.5f);
+    setEnv(patch.sourceNodes[1], 0.1f, 0.5f);
+    patch.mixerNodes[1].level.value = 0.f;
+
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    REQUIRE(!renderForSeconds(*synth, 1.f));
+
+    auto *v = synth->head;
+    REQUIRE(v);
+    REQUIRE(v->mixerNode[1].env.stage == MixerNode::env_t::s_sustain);
+    REQUIRE(v->src[1].env.stage == OpSource::env_t::s_sustain);
+
+    // Automated up, the note comes in at its sustain rather than attacking from scratch
+    patch.mixerNodes[1].level.value = 0.5f;
+    REQUIRE(renderForSeconds(*synth, 0.01f));
+    REQUIRE(v->mixerNode[1].env.stage == MixerNode::env_t::s_sustain);
+    REQUIRE(v->src[1].env.stage == OpSource::env_t::s_sustain);
+}